@@ -0,0 +1,578 @@
+/*
+ * Sharded multi-sensor ingest
+ * ---------------------------
+ * Ingests thousands of sensors the way a gateway would, spread across
+ * cores instead of funnelled through one logger thread:
+ *  - sensor IDs are sharded across worker threads (shard = id % shards);
+ *    each shard owns its alarm state and its output buffer, so the hot
+ *    path takes no lock and shares no cache line with other shards
+ *  - load generator threads play the sensors; every generator has one
+ *    lock-free SPSC ring per shard, so each ring keeps a single producer
+ *    and a single consumer
+ *  - workers run the alarm rule engine per sensor (one AlarmRuleSource
+ *    per sensor and rule) and format CSV rows into a shard-local block;
+ *    with --history N they also keep the shard's last N readings in a
+ *    SensorHistory ring (the loggers' circular buffer with rolling stats)
+ *  - full blocks are merged into a common store: one shared LogWriter
+ *    taken once per 64 KiB block (--store shared), one file per shard
+ *    (--store sharded) or nothing (--store none, pure ingest cost)
+ *  - alarm transitions of all shards go to one alarm log
+ *
+ * --scale repeats the run for 1, 2, 4 ... shards and prints aggregate
+ * samples/s against the shard count. Generators run on the same cores
+ * as the workers, so the numbers are for the whole pipeline.
+ *
+ * Usage: sensor_ingest [--sensors N] [--shards K] [--generators G] [--seconds S]
+ *                      [--rate HZ] [--ring N] [--history N] [--rules FILE]
+ *                      [--store shared|sharded|none] [--out DIR] [--scale]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "spsc_ring.h"
+#include "sensor_data.h"
+#include "sensor_csv.h"
+#include "sensor_history.h"
+#include "alarm_rules.h"
+#include "log_writer.h"
+#include "timebase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <inttypes.h>
+
+#define INGEST_MAX_SHARDS     64
+#define INGEST_MAX_GENERATORS 64
+#define INGEST_RING_SIZE      4096u       /* samples per generator->shard ring */
+#define INGEST_BATCH          256u        /* samples per ring push/pop */
+#define INGEST_BLOCK_BYTES    (64u * 1024u)
+#define INGEST_EVENTS         16u
+
+#define INGEST_TICKS_PER_S    1e9         /* timestamps: ns since the Unix epoch (timebase.h) */
+#define INGEST_MAX_RATE_HZ    1000000000u /* the generator period is a whole ns */
+
+#define INGEST_HEADER "Sensor,Temperature (°C),Pressure (bar),Flow (L/min),Timestamp (ns)\n"
+
+typedef enum { STORE_SHARED = 0, STORE_SHARDED, STORE_NONE } StoreMode;
+
+typedef struct {
+    uint32_t   sensor;
+    SensorData d;
+} IngestSample;
+
+typedef struct Ingest Ingest;
+
+typedef struct {
+    Ingest   *ing;
+    size_t    id;
+    pthread_t thread;
+
+    SpscRing *in;                 /* one ring per generator */
+    AlarmRules rules;             /* shard copy: statistics stay shard-local */
+    AlarmRuleSource *state;       /* sensors_owned * rules.count */
+    size_t    sensors_owned;
+    SensorHistory recent;         /* --history: latest readings of the shard's sensors */
+
+    LogWriter own;                /* STORE_SHARDED */
+    char     *block;              /* rows waiting to be merged into the store */
+    size_t    block_len;
+
+    unsigned long long samples;
+    unsigned long long bytes;
+    unsigned long blocks;
+    unsigned long events;
+} Shard;
+
+typedef struct {
+    Ingest   *ing;
+    size_t    id;
+    pthread_t thread;
+    uint32_t  rng;
+    IngestSample *stage;          /* shards * INGEST_BATCH staging slots */
+    size_t   *staged;
+    unsigned long stalls;         /* ring full: generator waited for a worker */
+} Generator;
+
+struct Ingest {
+    size_t    sensors, shards, generators;
+    unsigned  rate_hz;            /* per sensor, 0 = as fast as possible */
+    size_t    ring_size;
+    size_t    history;            /* SensorHistory window per shard, 0 = none */
+    StoreMode store;
+    const char *out_dir;
+    const AlarmRules *rules;
+
+    Shard     shard[INGEST_MAX_SHARDS];
+    Generator gen[INGEST_MAX_GENERATORS];
+    IngestSample *ring_storage;
+
+    LogWriter data;               /* STORE_SHARED */
+    LogWriter alarms;
+    int       logging;
+
+    uint64_t  start_ns;
+    int       stop;               /* generators: time is up */
+    size_t    gens_done;          /* workers: no more input after the rings drain */
+};
+
+/* pacing and run time: CLOCK_MONOTONIC, which clock_nanosleep() sleeps on */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * TIMEBASE_NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t deadline) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline / TIMEBASE_NS_PER_S);
+    ts.tv_nsec = (long)(deadline % TIMEBASE_NS_PER_S);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* ---- load generator ---- */
+
+static inline uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+/* 0..1..0 over period_ms, shifted per sensor so they do not alarm in step */
+static inline float triangle(uint64_t t_ms, uint32_t phase, uint32_t period_ms) {
+    uint32_t p = (uint32_t)((t_ms + phase) % period_ms);
+    uint32_t half = period_ms / 2;
+    return (float)(p < half ? p : period_ms - p) / (float)half;
+}
+
+static void push_stage(Generator *g, size_t shard) {
+    Ingest *ing = g->ing;
+    SpscRing *r = &ing->shard[shard].in[g->id];
+    const IngestSample *src = g->stage + shard * INGEST_BATCH;
+    size_t n = g->staged[shard], done = 0;
+
+    while (done < n) {
+        size_t k = spsc_push_batch(r, src + done, n - done);
+        if (k == 0) {
+            g->stalls++;
+            sched_yield();     /* back-pressure: the shard is behind */
+        }
+        done += k;
+    }
+    g->staged[shard] = 0;
+}
+
+static void *generator_thread(void *arg) {
+    Generator *g = (Generator *)arg;
+    Ingest *ing = g->ing;
+    const uint64_t period_ns = ing->rate_hz ? TIMEBASE_NS_PER_S / ing->rate_hz : 0;
+    uint64_t next = now_ns();
+
+    while (!__atomic_load_n(&ing->stop, __ATOMIC_RELAXED)) {
+        uint64_t ts = timebase_wall_ns();
+        uint64_t t_ms = (now_ns() - ing->start_ns) / 1000000ULL;
+
+        /* one pass = one sample from every sensor this generator plays */
+        for (size_t s = g->id; s < ing->sensors; s += ing->generators) {
+            size_t shard = s % ing->shards;
+            uint32_t phase = (uint32_t)s * 7919u;
+            float noise = (float)(xorshift32(&g->rng) & 0xffff) / 65536.0f - 0.5f;
+            IngestSample *x = g->stage + shard * INGEST_BATCH + g->staged[shard];
+
+            x->sensor = (uint32_t)s;
+            x->d.temperature = 55.0f + 30.0f * triangle(t_ms, phase, 20000) + noise;
+            x->d.pressure = 4.0f + 6.0f * triangle(t_ms, phase, 31000) + 0.1f * noise;
+            x->d.flow = 8.0f + 60.0f * triangle(t_ms, phase, 47000) + noise;
+            x->d.timestamp = ts;
+            if (++g->staged[shard] == INGEST_BATCH) push_stage(g, shard);
+        }
+        for (size_t k = 0; k < ing->shards; k++)
+            if (g->staged[k]) push_stage(g, k);
+
+        if (period_ns) {
+            next += period_ns;
+            sleep_until_ns(next);
+        }
+    }
+    __atomic_fetch_add(&ing->gens_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/* ---- shard workers ---- */
+
+static void shard_flush(Shard *sh) {
+    Ingest *ing = sh->ing;
+    if (sh->block_len == 0) return;
+    if (ing->store == STORE_SHARED) log_writer_write(&ing->data, sh->block, sh->block_len);
+    else if (ing->store == STORE_SHARDED) log_writer_write(&sh->own, sh->block, sh->block_len);
+    sh->bytes += sh->block_len;
+    sh->blocks++;
+    sh->block_len = 0;
+}
+
+static void shard_events(Shard *sh, uint32_t sensor, const AlarmEvent *ev, size_t n) {
+    Ingest *ing = sh->ing;
+    sh->events += n;
+    if (!ing->logging) return;
+    for (size_t i = 0; i < n; i++) {
+        log_writer_printf(&ing->alarms, "%" PRIu64 " sensor %" PRIu32 " %s %s: %s %.2f\n",
+                          ev[i].timestamp, sensor, sh->rules.name[ev[i].rule],
+                          ev[i].type == ALARM_EVENT_RAISE ? "RAISED" : "CLEARED",
+                          alarm_rules_channel_name(sh->rules.channel[ev[i].rule]), ev[i].value);
+    }
+}
+
+static void shard_process(Shard *sh, const IngestSample *x, size_t n) {
+    Ingest *ing = sh->ing;
+    const size_t nrules = sh->rules.count;
+    AlarmEvent ev[INGEST_EVENTS];
+
+    for (size_t i = 0; i < n; i++) {
+        AlarmRuleSource *src = sh->state + (x[i].sensor / ing->shards) * nrules;
+        size_t nev = alarm_rules_eval_source(&sh->rules, src, &x[i].d, 1, ev, INGEST_EVENTS);
+        if (nev) shard_events(sh, x[i].sensor, ev, nev);
+        if (ing->history) history_push(&sh->recent, &x[i].d);
+
+        if (sh->block_len + 12 + SENSOR_CSV_MAX_ROW > INGEST_BLOCK_BYTES) shard_flush(sh);
+        char *dst = sh->block + sh->block_len;
+        size_t len = sensor_csv_u64(dst, x[i].sensor);
+        dst[len++] = ',';
+        len += sensor_csv_row(dst + len, &x[i].d);
+        sh->block_len += len;
+    }
+    sh->samples += n;
+}
+
+static void *shard_thread(void *arg) {
+    Shard *sh = (Shard *)arg;
+    Ingest *ing = sh->ing;
+    IngestSample batch[INGEST_BATCH];
+
+    for (;;) {
+        /* read the flag before draining so nothing pushed earlier is missed */
+        int last = __atomic_load_n(&ing->gens_done, __ATOMIC_ACQUIRE) == ing->generators;
+        size_t got = 0;
+        for (size_t g = 0; g < ing->generators; g++) {
+            size_t n = spsc_pop_batch(&sh->in[g], batch, INGEST_BATCH);
+            if (n) shard_process(sh, batch, n);
+            got += n;
+        }
+        if (got == 0) {
+            if (last) break;
+            sched_yield();
+        }
+    }
+    shard_flush(sh);
+    return NULL;
+}
+
+/* ---- one run ---- */
+
+typedef struct {
+    double seconds;
+    unsigned long long samples, bytes;
+    unsigned long events, stalls, blocks;
+} IngestResult;
+
+static int open_outputs(Ingest *ing) {
+    LogWriterConfig cfg;
+    char path[512];
+    log_writer_default_config(&cfg);
+    ing->logging = ing->store != STORE_NONE;
+    if (!ing->logging) return 0;
+
+    snprintf(path, sizeof(path), "%s/ingest_alarms.txt", ing->out_dir);
+    if (log_writer_open(&ing->alarms, path, 1, &cfg) != 0) {
+        fprintf(stderr, "Error: cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (ing->store == STORE_SHARED) {
+        snprintf(path, sizeof(path), "%s/ingest_data.csv", ing->out_dir);
+        if (log_writer_open(&ing->data, path, 1, &cfg) != 0) {
+            fprintf(stderr, "Error: cannot open %s: %s\n", path, strerror(errno));
+            log_writer_close(&ing->alarms);
+            return -1;
+        }
+        log_writer_write(&ing->data, INGEST_HEADER, sizeof(INGEST_HEADER) - 1);
+        return 0;
+    }
+    for (size_t k = 0; k < ing->shards; k++) {
+        snprintf(path, sizeof(path), "%s/ingest_data.%02zu.csv", ing->out_dir, k);
+        if (log_writer_open(&ing->shard[k].own, path, 1, &cfg) != 0) {
+            fprintf(stderr, "Error: cannot open %s: %s\n", path, strerror(errno));
+            while (k-- > 0) log_writer_close(&ing->shard[k].own);
+            log_writer_close(&ing->alarms);
+            return -1;
+        }
+        log_writer_write(&ing->shard[k].own, INGEST_HEADER, sizeof(INGEST_HEADER) - 1);
+    }
+    return 0;
+}
+
+static void close_outputs(Ingest *ing) {
+    if (!ing->logging) return;
+    if (ing->store == STORE_SHARED) log_writer_close(&ing->data);
+    else
+        for (size_t k = 0; k < ing->shards; k++) log_writer_close(&ing->shard[k].own);
+    log_writer_close(&ing->alarms);
+}
+
+static void free_run(Ingest *ing) {
+    for (size_t k = 0; k < ing->shards; k++) {
+        free(ing->shard[k].in);
+        free(ing->shard[k].state);
+        free(ing->shard[k].block);
+        history_free(&ing->shard[k].recent);
+    }
+    for (size_t g = 0; g < ing->generators; g++) {
+        free(ing->gen[g].stage);
+        free(ing->gen[g].staged);
+    }
+    free(ing->ring_storage);
+    ing->ring_storage = NULL;
+}
+
+static int setup_run(Ingest *ing) {
+    const size_t nrules = ing->rules->count;
+    memset(ing->shard, 0, sizeof(ing->shard));
+    memset(ing->gen, 0, sizeof(ing->gen));
+
+    ing->ring_storage = malloc(ing->shards * ing->generators * ing->ring_size * sizeof(IngestSample));
+    if (!ing->ring_storage) return -1;
+
+    for (size_t k = 0; k < ing->shards; k++) {
+        Shard *sh = &ing->shard[k];
+        sh->ing = ing;
+        sh->id = k;
+        sh->rules = *ing->rules;
+        sh->sensors_owned = (ing->sensors - k + ing->shards - 1) / ing->shards;
+        sh->in = calloc(ing->generators, sizeof(SpscRing));
+        sh->state = calloc(sh->sensors_owned * nrules + 1, sizeof(AlarmRuleSource));
+        sh->block = malloc(INGEST_BLOCK_BYTES);
+        if (!sh->in || !sh->state || !sh->block) return -1;
+        if (ing->history && !history_init(&sh->recent, ing->history, INGEST_TICKS_PER_S)) return -1;
+        for (size_t g = 0; g < ing->generators; g++) {
+            IngestSample *storage = ing->ring_storage + (k * ing->generators + g) * ing->ring_size;
+            spsc_init(&sh->in[g], storage, ing->ring_size, sizeof(IngestSample));
+        }
+    }
+    for (size_t g = 0; g < ing->generators; g++) {
+        Generator *gen = &ing->gen[g];
+        gen->ing = ing;
+        gen->id = g;
+        gen->rng = 0x9e3779b9u ^ (uint32_t)(g * 2654435761u);
+        if (gen->rng == 0) gen->rng = 1;
+        gen->stage = malloc(ing->shards * INGEST_BATCH * sizeof(IngestSample));
+        gen->staged = calloc(ing->shards, sizeof(size_t));
+        if (!gen->stage || !gen->staged) return -1;
+    }
+    return 0;
+}
+
+static int run_ingest(Ingest *ing, unsigned seconds, IngestResult *res) {
+    memset(res, 0, sizeof(*res));
+    if (setup_run(ing) != 0) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        free_run(ing);
+        return -1;
+    }
+    if (open_outputs(ing) != 0) {
+        free_run(ing);
+        return -1;
+    }
+
+    ing->stop = 0;
+    ing->gens_done = 0;
+    ing->start_ns = now_ns();
+    size_t shards_up = 0, gens_up = 0;
+    while (shards_up < ing->shards &&
+           pthread_create(&ing->shard[shards_up].thread, NULL, shard_thread, &ing->shard[shards_up]) == 0)
+        shards_up++;
+    while (shards_up == ing->shards && gens_up < ing->generators &&
+           pthread_create(&ing->gen[gens_up].thread, NULL, generator_thread, &ing->gen[gens_up]) == 0)
+        gens_up++;
+    int started = shards_up == ing->shards && gens_up == ing->generators;
+
+    if (started) sleep_until_ns(ing->start_ns + (uint64_t)seconds * TIMEBASE_NS_PER_S);
+    __atomic_store_n(&ing->stop, 1, __ATOMIC_RELAXED);
+    for (size_t g = 0; g < gens_up; g++) pthread_join(ing->gen[g].thread, NULL);
+    /* generators that never started count as done, so the workers drain and exit */
+    __atomic_fetch_add(&ing->gens_done, ing->generators - gens_up, __ATOMIC_RELEASE);
+    for (size_t k = 0; k < shards_up; k++) pthread_join(ing->shard[k].thread, NULL);
+    if (!started) {
+        fprintf(stderr, "Error: cannot start %s threads.\n", shards_up < ing->shards ? "shard" : "generator");
+        close_outputs(ing);
+        free_run(ing);
+        return -1;
+    }
+    res->seconds = (double)(now_ns() - ing->start_ns) / 1e9;
+
+    for (size_t k = 0; k < ing->shards; k++) {
+        res->samples += ing->shard[k].samples;
+        res->bytes += ing->shard[k].bytes;
+        res->events += ing->shard[k].events;
+        res->blocks += ing->shard[k].blocks;
+    }
+    for (size_t g = 0; g < ing->generators; g++) res->stalls += ing->gen[g].stalls;
+    close_outputs(ing);
+    return 0;
+}
+
+static void print_report(const Ingest *ing, const IngestResult *res) {
+    printf("\n%-6s %10s %8s %12s %8s %10s", "Shard", "Sensors", "Blocks", "Samples", "Events", "MB");
+    if (ing->history) printf(" %10s %10s", "Temp mean", "Temp max");
+    printf("\n");
+    for (size_t k = 0; k < ing->shards; k++) {
+        const Shard *sh = &ing->shard[k];
+        printf("%-6zu %10zu %8lu %12llu %8lu %10.1f", k, sh->sensors_owned, sh->blocks,
+               sh->samples, sh->events, (double)sh->bytes / 1e6);
+        if (ing->history) {
+            ChannelStats t;
+            history_stats(&sh->recent, SENSOR_CH_TEMPERATURE, &t);
+            printf(" %10.2f %10.2f", t.mean, t.max);
+        }
+        printf("\n");
+    }
+    if (ing->history) printf("(temperatures over the last %zu readings of each shard)\n", ing->history);
+
+    printf("\n%-14s %-12s %3s %9s %10s %10s %10s\n",
+           "Rule", "Channel", "Op", "Threshold", "Raised", "Suppressed", "Cleared");
+    for (size_t r = 0; r < ing->rules->count; r++) {
+        unsigned long raised = 0, suppressed = 0, cleared = 0;
+        for (size_t k = 0; k < ing->shards; k++) {
+            raised += ing->shard[k].rules.raised[r];
+            suppressed += ing->shard[k].rules.suppressed[r];
+            cleared += ing->shard[k].rules.cleared[r];
+        }
+        printf("%-14s %-12s %3s %9.2f %10lu %10lu %10lu\n", ing->rules->name[r],
+               alarm_rules_channel_name(ing->rules->channel[r]),
+               alarm_rules_op_name((RuleOp)ing->rules->op[r]), ing->rules->threshold[r],
+               raised, suppressed, cleared);
+    }
+
+    printf("\nIngested %llu samples in %.2f s: %.2f M samples/s, %.1f MB/s of CSV | "
+           "%lu alarm events | %lu generator stalls\n",
+           res->samples, res->seconds, (double)res->samples / res->seconds / 1e6,
+           (double)res->bytes / res->seconds / 1e6, res->events, res->stalls);
+    int error = 0;
+    if (ing->store == STORE_SHARED) error = ing->data.error;
+    for (size_t k = 0; ing->store == STORE_SHARDED && k < ing->shards && !error; k++)
+        error = ing->shard[k].own.error;
+    if (error) fprintf(stderr, "Warning: store write error: %s\n", strerror(error));
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--sensors N] [--shards K] [--generators G] [--seconds S]\n"
+           "          [--rate HZ] [--ring N] [--history N] [--rules FILE]\n"
+           "          [--store shared|sharded|none] [--out DIR] [--scale]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    static Ingest ing;
+    static AlarmRules rules;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t shards = ncpu > 0 ? (size_t)ncpu : 1, generators = 0;
+    unsigned seconds = 3;
+    const char *rules_path = NULL;
+    int scale = 0;
+
+    ing.sensors = 10000;
+    ing.ring_size = INGEST_RING_SIZE;
+    ing.store = STORE_SHARED;
+    ing.out_dir = ".";
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--sensors") == 0 && i + 1 < argc) ing.sensors = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--shards") == 0 && i + 1 < argc) shards = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--generators") == 0 && i + 1 < argc) generators = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            char *end;
+            unsigned long hz = strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || argv[i][0] == '-' || hz > INGEST_MAX_RATE_HZ) {
+                fprintf(stderr, "Error: --rate must be 0..%u Hz.\n", INGEST_MAX_RATE_HZ);
+                return 1;
+            }
+            ing.rate_hz = (unsigned)hz;
+        }
+        else if (strcmp(argv[i], "--ring") == 0 && i + 1 < argc)
+            ing.ring_size = spsc_round_capacity((size_t)atol(argv[++i]));
+        else if (strcmp(argv[i], "--history") == 0 && i + 1 < argc) ing.history = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) rules_path = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) ing.out_dir = argv[++i];
+        else if (strcmp(argv[i], "--scale") == 0) scale = 1;
+        else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc) {
+            const char *m = argv[++i];
+            if (strcmp(m, "shared") == 0) ing.store = STORE_SHARED;
+            else if (strcmp(m, "sharded") == 0) ing.store = STORE_SHARDED;
+            else if (strcmp(m, "none") == 0) ing.store = STORE_NONE;
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    timebase_init(TIMEBASE_AUTO);
+    if (ing.sensors == 0 || seconds == 0 || shards == 0 || shards > INGEST_MAX_SHARDS ||
+        generators > INGEST_MAX_GENERATORS || ing.ring_size < INGEST_BATCH) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    alarm_rules_init(&rules, INGEST_TICKS_PER_S);
+    if (rules_path) {
+        char err[256];
+        if (alarm_rules_load(&rules, rules_path, err, sizeof(err)) != 0) {
+            fprintf(stderr, "Error: %s\n", err);
+            return 1;
+        }
+    } else {
+        alarm_rules_add(&rules, "high_temp", SENSOR_CH_TEMPERATURE, RULE_GT, 80.0f, 5.0f, 0, 5);
+        alarm_rules_add(&rules, "high_press", SENSOR_CH_PRESSURE, RULE_GT, 9.0f, 0.5f, 0, 5);
+        alarm_rules_add(&rules, "low_flow", SENSOR_CH_FLOW, RULE_LT, 10.0f, 5.0f, 1, 10);
+    }
+    ing.rules = &rules;
+
+    printf("Sensor ingest: %zu sensors | %s | %u s | rules: %zu | store: %s | %ld CPUs online\n",
+           ing.sensors, ing.rate_hz ? "rate-limited" : "unthrottled", seconds, rules.count,
+           ing.store == STORE_SHARED ? "shared" : ing.store == STORE_SHARDED ? "sharded" : "none",
+           ncpu);
+
+    if (!scale) {
+        IngestResult res;
+        ing.shards = shards;
+        ing.generators = generators ? generators : shards;
+        printf("%zu shards, %zu generators, %zu-sample rings\n", ing.shards, ing.generators, ing.ring_size);
+        if (run_ingest(&ing, seconds, &res) != 0) return 1;
+        print_report(&ing, &res);
+        free_run(&ing);
+        return 0;
+    }
+
+    /* scaling table: shard count doubles up to --shards */
+    double base = 0.0;
+    printf("\n%7s %11s %14s %16s %8s %9s\n", "Shards", "Generators", "M samples/s",
+           "per shard (M/s)", "Speedup", "Stalls");
+    for (size_t k = 1;; k = k * 2 < shards ? k * 2 : shards) {
+        IngestResult res;
+        ing.shards = k;
+        ing.generators = generators ? generators : k;
+        if (run_ingest(&ing, seconds, &res) != 0) return 1;
+        double rate = (double)res.samples / res.seconds;
+        if (k == 1) base = rate;
+        printf("%7zu %11zu %14.2f %16.2f %7.2fx %9lu\n", k, ing.generators, rate / 1e6,
+               rate / 1e6 / (double)k, base > 0 ? rate / base : 0.0, res.stalls);
+        free_run(&ing);
+        if (k == shards) break;
+    }
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * Interrupt simulator for the cooperative scheduler
+ * -------------------------------------------------
+ * Runs the scheduler the way the firmware does on an MCU:
+ *  - a 1 ms POSIX timer signal plays the SysTick ISR and calls
+ *    scheduler_tick()
+ *  - a second timer signal plays a peripheral IRQ (e.g. UART RX): it
+ *    timestamps the "interrupt", queues it in an SPSC mailbox and triggers an
+ *    event-driven task
+ *  - the main loop sleeps until a signal arrives, then calls
+ *    scheduler_dispatch()
+ *
+ * A configurable background task burns CPU to create load, and the
+ * interrupt-to-task latency (IRQ timestamp -> event task start) is
+ * reported as a distribution at the end.
+ *
+ * Usage: irq_sim [--seconds S] [--irq-hz H] [--load-us U] [--load-period MS]
+ *                [--no-critical] [--rt-cpu N] [--rt-prio P] [--rt-mlock]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "scheduler.h"
+#include "rt_host.h"
+#include "spsc_ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <inttypes.h>
+
+#define SIG_TICK        (SIGRTMIN)
+#define SIG_PERIPHERAL  (SIGRTMIN + 1)
+
+#define MAILBOX_SIZE    256u  /* power of two */
+
+/* ---- peripheral "hardware": IRQ timestamps, ISR -> event task ---- */
+static uint64_t mailbox_slots[MAILBOX_SIZE];
+static SpscRing mailbox;
+static volatile sig_atomic_t mailbox_overflow = 0;
+
+static volatile sig_atomic_t work_pending = 0;
+static volatile sig_atomic_t irq_count = 0;
+static volatile sig_atomic_t irq_missed = 0;      /* expirations lost while pending */
+static volatile sig_atomic_t tick_count = 0;
+static volatile sig_atomic_t tick_overruns = 0;   /* ticks merged by the kernel */
+
+static timer_t tick_timer, irq_timer;
+
+static int rx_task_id = -1;
+static sigset_t irq_mask;
+
+/* latency samples (ns), preallocated for the whole run */
+static uint64_t *latency = NULL;
+static size_t latency_cap = 0;
+static size_t latency_count = 0;
+static RtJitterHist latency_hist;
+
+static uint32_t load_us = 200;
+
+/* ---- "ISRs" ---- */
+static void tick_isr(int sig) {
+    (void)sig;
+    /* a late signal can stand for several expirations: replay them so the
+       scheduler's time base does not slip */
+    int missed = timer_getoverrun(tick_timer);
+    for (int i = 0; i <= missed; ++i) scheduler_tick();
+    if (missed > 0) tick_overruns += missed;
+    tick_count += 1 + (missed > 0 ? missed : 0);
+    work_pending = 1;
+}
+
+static void peripheral_isr(int sig) {
+    (void)sig;
+    uint64_t ts = rt_host_now_ns();
+    /* unlike SysTick these cannot be replayed: the data of a peripheral
+       interrupt that fires again while still pending is gone (an RX overrun) */
+    int missed = timer_getoverrun(irq_timer);
+    if (missed > 0) irq_missed += missed;
+    if (!spsc_push(&mailbox, &ts)) mailbox_overflow++;
+    irq_count++;
+    if (rx_task_id >= 0) scheduler_trigger((size_t)rx_task_id);
+    work_pending = 1;
+}
+
+/* critical section = mask both timer signals, like __disable_irq() */
+static void irq_disable(void) {
+    sigprocmask(SIG_BLOCK, &irq_mask, NULL);
+}
+
+static void irq_enable(void) {
+    sigprocmask(SIG_UNBLOCK, &irq_mask, NULL);
+}
+
+/* ---- tasks ---- */
+static void rx_task(void) {
+    uint64_t start = rt_host_now_ns();
+    SpscSpan spans[2];
+    size_t n = spsc_peek(&mailbox, spans);
+    for (int s = 0; s < 2; ++s) {
+        const uint64_t *irq_ts = (const uint64_t *)spans[s].data;
+        for (size_t i = 0; i < spans[s].count; ++i) {
+            uint64_t lat = start - irq_ts[i];
+            if (latency_count < latency_cap) latency[latency_count++] = lat;
+            rt_jitter_record(&latency_hist, lat);
+        }
+    }
+    spsc_consume(&mailbox, n);
+}
+
+static void load_task(void) {
+    uint64_t end = rt_host_now_ns() + (uint64_t)load_us * 1000ULL;
+    while (rt_host_now_ns() < end) {
+        /* simulate a long-running cooperative task */
+    }
+}
+
+static void housekeeping_task(void) {
+    /* short periodic task, keeps the tick path busy */
+    static volatile uint32_t counter = 0;
+    counter++;
+}
+
+static int start_timer(int sig, long period_ns, timer_t *out) {
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = sig;
+    if (timer_create(CLOCK_MONOTONIC, &sev, out) != 0) return -1;
+
+    struct itimerspec its;
+    its.it_value.tv_sec = period_ns / 1000000000L;
+    its.it_value.tv_nsec = period_ns % 1000000000L;
+    its.it_interval = its.it_value;
+    return timer_settime(*out, 0, &its, NULL);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t *sorted, size_t n, double p) {
+    if (n == 0) return 0.0;
+    size_t idx = (size_t)(p / 100.0 * (double)(n - 1) + 0.5);
+    return (double)sorted[idx] / 1e3;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--seconds S] [--irq-hz H] [--load-us U] [--load-period MS]\n"
+           "          [--no-critical] [--rt-cpu N] [--rt-prio P] [--rt-mlock]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t seconds = 5, irq_hz = 500, load_period = 10;
+    int use_critical = 1;
+    RtConfig rt = { -1, 0, 0, 0 };
+    int use_rt = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--irq-hz") == 0 && i + 1 < argc) irq_hz = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--load-us") == 0 && i + 1 < argc) load_us = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--load-period") == 0 && i + 1 < argc) load_period = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-critical") == 0) use_critical = 0;
+        else if (strcmp(argv[i], "--rt-cpu") == 0 && i + 1 < argc) { rt.cpu = atoi(argv[++i]); use_rt = 1; }
+        else if (strcmp(argv[i], "--rt-prio") == 0 && i + 1 < argc) { rt.fifo_priority = atoi(argv[++i]); use_rt = 1; }
+        else if (strcmp(argv[i], "--rt-mlock") == 0) { rt.lock_memory = 1; use_rt = 1; }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (irq_hz == 0 || seconds == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    latency_cap = (size_t)irq_hz * seconds + MAILBOX_SIZE;
+    latency = malloc(latency_cap * sizeof(*latency));
+    if (!latency) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+    rt_jitter_reset(&latency_hist);
+    spsc_init(&mailbox, mailbox_slots, MAILBOX_SIZE, sizeof(uint64_t));
+    if (use_rt) {
+        rt_host_apply(&rt);
+        rt_host_prefault(latency, latency_cap * sizeof(*latency));
+    }
+
+    scheduler_init();
+    rx_task_id = scheduler_add(rx_task, SCHED_EVENT_TASK);
+    scheduler_add(housekeeping_task, 1);
+    if (load_us > 0 && load_period > 0) scheduler_add(load_task, load_period);
+
+    sigemptyset(&irq_mask);
+    sigaddset(&irq_mask, SIG_TICK);
+    sigaddset(&irq_mask, SIG_PERIPHERAL);
+    if (use_critical) scheduler_set_critical(irq_disable, irq_enable);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = tick_isr;
+    sigaction(SIG_TICK, &sa, NULL);
+    /* the peripheral IRQ may preempt the tick ISR, not vice versa */
+    sigaddset(&sa.sa_mask, SIG_TICK);
+    sa.sa_handler = peripheral_isr;
+    sigaction(SIG_PERIPHERAL, &sa, NULL);
+
+    printf("IRQ simulator: %u s | peripheral IRQ %u Hz | load %u us every %u ms | critical sections %s\n",
+           seconds, irq_hz, load_us, load_period, use_critical ? "on" : "off");
+
+    if (start_timer(SIG_TICK, 1000000L, &tick_timer) != 0 ||
+        start_timer(SIG_PERIPHERAL, 1000000000L / (long)irq_hz, &irq_timer) != 0) {
+        perror("timer_create");
+        return 1;
+    }
+
+    /* main loop: wait for an "interrupt", then dispatch */
+    sigset_t wait_mask;
+    sigprocmask(SIG_BLOCK, &irq_mask, &wait_mask);
+    sigdelset(&wait_mask, SIG_TICK);
+    sigdelset(&wait_mask, SIG_PERIPHERAL);
+    uint64_t end_ns = rt_host_now_ns() + (uint64_t)seconds * 1000000000ULL;
+
+    while (rt_host_now_ns() < end_ns) {
+        if (!work_pending) sigsuspend(&wait_mask);  /* atomically unmask + sleep */
+        work_pending = 0;
+        irq_enable();
+        scheduler_dispatch();
+        irq_disable();
+    }
+
+    timer_delete(irq_timer);
+    timer_delete(tick_timer);
+    irq_enable();
+
+    qsort(latency, latency_count, sizeof(*latency), cmp_u64);
+    printf("Ticks: %ld (%ld delivered late as overruns) | IRQs: %ld (%ld missed as timer overruns) | "
+           "serviced: %zu | mailbox overflows: %ld\n",
+           (long)tick_count, (long)tick_overruns, (long)irq_count, (long)irq_missed,
+           latency_count, (long)mailbox_overflow);
+    printf("IRQ->task latency us: p50=%.1f p90=%.1f p99=%.1f p99.9=%.1f max=%.1f\n",
+           percentile_us(latency, latency_count, 50.0),
+           percentile_us(latency, latency_count, 90.0),
+           percentile_us(latency, latency_count, 99.0),
+           percentile_us(latency, latency_count, 99.9),
+           latency_count ? (double)latency[latency_count - 1] / 1e3 : 0.0);
+    rt_jitter_report("IRQ->task latency", &latency_hist);
+
+    free(latency);
+    return 0;
+}
@@ -4,54 +4,57 @@
 >Memory usage monitoring
 >Alarm thresholds (both sensor and memory(warn if memory is near capacity))
 >Overflow protection
+>Load test: --bench N [--buffer N] [--rate HZ] skips the prompt and all per-reading output and prints a JSON summary (logger_bench.h)
 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+#include "spsc_ring.h"
+#include "timebase.h"
+#include "logger_bench.h"
+#include "sensor_data.h"
+#include "sensor_sim.h"
+
 #define MEMORY_WARNING_THRESHOLD 0.8  // 80% usage warning
+#define BUFFER_CAPACITY 10            // readings kept
 
-// -------- Sensor simulation structure ----------
-typedef struct {
-    float temperature;
-    float pressure;
-    float flow;
-} SensorData;
+static int quiet = 0;                 // --bench: no per-reading output
+static unsigned long alarms_raised = 0;
 
 // -------- Circular buffer structure ----------
 typedef struct {
-    SensorData *buffer; // dynamically allocated
-    int capacity;
-    int head;
-    int count;
+    SpscRing ring;       // lock-free ring (firmware/inc/spsc_ring.h)
+    SensorData *buffer;  // dynamically allocated, power-of-two slots
+    int capacity;        // readings kept
 } CircularBuffer;
 
 // -------- Function prototypes ----------
 void initBuffer(CircularBuffer *cb, int capacity);
 void freeBuffer(CircularBuffer *cb);
 void addReading(CircularBuffer *cb, SensorData data);
-void displayBuffer(const CircularBuffer *cb);
+void displayBuffer(CircularBuffer *cb);
 SensorData simulateSensor(void);
 
 // -------- Sensor simulation ----------
+static SensorSim sim;                 // simulated plant (sensor_sim.h)
+
 SensorData simulateSensor(void) {
-    SensorData d;
-    d.temperature = 60.0 + (rand() % 50); // 60–110°C
-    d.pressure = 5.0 + (rand() % 10);     // 5–15 bar
-    d.flow = 20.0 + (rand() % 30);        // 20–50 L/min
+    SensorData d = sensor_sim_next(&sim);   // 20–100°C, 1–10 bar, 0–100 L/min
+    d.timestamp = timebase_wall_ns();
     return d;
 }
 
 // -------- Buffer initialization ----------
 void initBuffer(CircularBuffer *cb, int capacity) {
-    cb->buffer = (SensorData *)malloc(sizeof(SensorData) * capacity);
+    size_t slots = spsc_round_capacity((size_t)capacity);
+    cb->buffer = (SensorData *)malloc(sizeof(SensorData) * slots);
     if (!cb->buffer) {
         printf("[ERROR] Memory allocation failed.\n");
         exit(1);
     }
+    spsc_init(&cb->ring, cb->buffer, slots, sizeof(SensorData));
     cb->capacity = capacity;
-    cb->head = 0;
-    cb->count = 0;
 }
 
 // -------- Free memory ----------
@@ -59,66 +62,97 @@ void freeBuffer(CircularBuffer *cb) {
     free(cb->buffer);
     cb->buffer = NULL;
     cb->capacity = 0;
-    cb->count = 0;
-    cb->head = 0;
 }
 
 // -------- Add data to buffer ----------
 void addReading(CircularBuffer *cb, SensorData data) {
     // Handle overflow — overwrite oldest
-    if (cb->count < cb->capacity) {
-        cb->buffer[(cb->head + cb->count) % cb->capacity] = data;
-        cb->count++;
-    } else {
-        printf("[WARN] Buffer full, overwriting oldest data.\n");
-        cb->buffer[cb->head] = data;
-        cb->head = (cb->head + 1) % cb->capacity;
+    if (spsc_count(&cb->ring) >= (size_t)cb->capacity) {
+        if (!quiet) printf("[WARN] Buffer full, overwriting oldest data.\n");
+        spsc_consume(&cb->ring, 1);
     }
+    spsc_push(&cb->ring, &data);
 
     // Check memory usage
-    float usage = (float)cb->count / cb->capacity;
-    if (usage >= MEMORY_WARNING_THRESHOLD) {
-        printf("[ALERT] Memory usage high: %.0f%% used.\n", usage * 100);
+    if (!quiet) {
+        float usage = (float)spsc_count(&cb->ring) / cb->capacity;
+        if (usage >= MEMORY_WARNING_THRESHOLD)
+            printf("[ALERT] Memory usage high: %.0f%% used.\n", usage * 100);
     }
 
     // Sensor alarms
-    if (data.temperature > 80.0)
-        printf("[TEMP ALARM] Temperature %.2f°C exceeds limit!\n", data.temperature);
-    if (data.pressure > 9.0)
-        printf("[PRESSURE ALARM] Pressure %.2f bar exceeds limit!\n", data.pressure);
-    if (data.flow > 45.0)
-        printf("[FLOW ALARM] Flow %.2f L/min exceeds limit!\n", data.flow);
+    if (data.temperature > 80.0) {
+        alarms_raised++;
+        if (!quiet) printf("[TEMP ALARM] Temperature %.2f°C exceeds limit!\n", data.temperature);
+    }
+    if (data.pressure > 9.0) {
+        alarms_raised++;
+        if (!quiet) printf("[PRESSURE ALARM] Pressure %.2f bar exceeds limit!\n", data.pressure);
+    }
+    if (data.flow > 45.0) {
+        alarms_raised++;
+        if (!quiet) printf("[FLOW ALARM] Flow %.2f L/min exceeds limit!\n", data.flow);
+    }
 }
 
 // -------- Display current buffer contents ----------
-void displayBuffer(const CircularBuffer *cb) {
-    printf("\n---- Buffer Contents (%d/%d) ----\n", cb->count, cb->capacity);
-    for (int i = 0; i < cb->count; i++) {
-        int index = (cb->head + i) % cb->capacity;
-        SensorData d = cb->buffer[index];
-        printf("[%02d] T=%.1f°C  P=%.1f bar  F=%.1f L/min\n", i + 1, d.temperature, d.pressure, d.flow);
+void displayBuffer(CircularBuffer *cb) {
+    SpscSpan spans[2];
+    size_t count = spsc_peek(&cb->ring, spans);
+
+    printf("\n---- Buffer Contents (%zu/%d) ----\n", count, cb->capacity);
+    int n = 0;
+    for (int s = 0; s < 2; s++) {
+        const SensorData *d = (const SensorData *)spans[s].data;
+        for (size_t i = 0; i < spans[s].count; i++) {
+            printf("[%02d] T=%.1f°C  P=%.1f bar  F=%.1f L/min\n", ++n, d[i].temperature, d[i].pressure, d[i].flow);
+        }
     }
     printf("-------------------------------\n");
 }
 
 // -------- Main program ----------
-int main() {
-    srand(time(NULL));
-
+int main(int argc, char *argv[]) {
     CircularBuffer cb;
     int numReadings;
+    static LoggerBench bench;
+    if (logger_bench_parse(&bench, argc, argv) != 0)
+        return 1;
+    timebase_init(TIMEBASE_AUTO);
+
+    SimConfig sim_cfg;
+    sensor_sim_default_config(&sim_cfg);
+    if (bench.enabled && bench.rate_hz > 0) sim_cfg.rate_hz = bench.rate_hz;
+    sensor_sim_init(&sim, &sim_cfg, (uint64_t)time(NULL));
+
+    if (bench.enabled) {
+        quiet = 1;
+        numReadings = (int)bench.count;
+    } else {
+        printf("Enter number of readings to simulate: ");
+        scanf("%d", &numReadings);
+    }
 
-    printf("Enter number of readings to simulate: ");
-    scanf("%d", &numReadings);
-
-    initBuffer(&cb, 10); // 10-sample buffer
+    initBuffer(&cb, bench.buffer ? bench.buffer : BUFFER_CAPACITY);
+    if (bench.enabled) {
+        bench.buffer = cb.capacity;
+        logger_bench_start(&bench);
+    }
 
     for (int i = 0; i < numReadings; i++) {
+        if (bench.enabled) logger_bench_pace(&bench);
         SensorData d = simulateSensor();
         addReading(&cb, d);
+        if (bench.enabled) logger_bench_done(&bench);
     }
 
-    displayBuffer(&cb);
+    if (bench.enabled) {
+        logger_bench_stop(&bench);
+        bench.alarms = alarms_raised;
+        logger_bench_report(&bench, "Improved_sensor_logger_alarm");
+    } else {
+        displayBuffer(&cb);
+    }
     freeBuffer(&cb);
 
     return 0;
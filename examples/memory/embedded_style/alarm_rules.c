@@ -0,0 +1,243 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "alarm_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RULE_FLAG_NOTIFIED  0x01   // RAISE of the current episode was emitted
+#define RULE_FLAG_EVER      0x02   // last_notify is valid
+
+static const char *channel_names[] = { "temperature", "pressure", "flow" };
+static const char *op_names[] = { ">", ">=", "<", "<=" };
+
+const char *alarm_rules_channel_name(int channel) {
+    return channel >= 0 && channel < 3 ? channel_names[channel] : "?";
+}
+
+const char *alarm_rules_op_name(RuleOp op) {
+    return (unsigned)op < 4 ? op_names[op] : "?";
+}
+
+void alarm_rules_init(AlarmRules *rs, double ticks_per_s) {
+    memset(rs, 0, sizeof(*rs));
+    rs->ticks_per_s = ticks_per_s > 0 ? ticks_per_s : 1.0;
+}
+
+int alarm_rules_add(AlarmRules *rs, const char *name, int channel, RuleOp op, float threshold,
+                    float hysteresis, float min_duration_s, float rate_limit_s) {
+    if (rs->count >= ALARM_RULES_MAX || channel < 0 || channel > 2 || (unsigned)op > RULE_LE ||
+        hysteresis < 0 || min_duration_s < 0 || rate_limit_s < 0)
+        return -1;
+
+    size_t r = rs->count++;
+    snprintf(rs->name[r], ALARM_RULE_NAME, "%s", name);
+    rs->channel[r] = (uint8_t)channel;
+    rs->op[r] = (uint8_t)op;
+    rs->threshold[r] = threshold;
+    rs->hysteresis[r] = hysteresis;
+    rs->raise_at[r] = threshold;
+    // high alarms clear below the threshold, low alarms above it
+    rs->clear_at[r] = op <= RULE_GE ? threshold - hysteresis : threshold + hysteresis;
+    rs->min_ticks[r] = (uint64_t)(min_duration_s * rs->ticks_per_s + 0.5);
+    rs->rate_ticks[r] = (uint64_t)(rate_limit_s * rs->ticks_per_s + 0.5);
+    rs->state[r] = RULE_CLEAR;
+    return (int)r;
+}
+
+static int parse_channel(const char *s) {
+    if (strcmp(s, "temperature") == 0 || strcmp(s, "temp") == 0) return 0;
+    if (strcmp(s, "pressure") == 0 || strcmp(s, "press") == 0) return 1;
+    if (strcmp(s, "flow") == 0) return 2;
+    return -1;
+}
+
+static int parse_op(const char *s) {
+    for (int i = 0; i < 4; i++)
+        if (strcmp(s, op_names[i]) == 0) return i;
+    return -1;
+}
+
+int alarm_rules_load(AlarmRules *rs, const char *path, char *err, size_t errlen) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        snprintf(err, errlen, "%s: cannot open", path);
+        return -1;
+    }
+
+    char line[256];
+    int lineno = 0, rc = 0;
+    while (rc == 0 && fgets(line, sizeof(line), f)) {
+        lineno++;
+        if (!strchr(line, '\n') && !feof(f)) {
+            snprintf(err, errlen, "%s:%d: line longer than %zu characters", path, lineno,
+                     sizeof(line) - 2);
+            rc = -1;
+            break;
+        }
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        // name channel op threshold and up to three options
+        char *tok[7];
+        int ntok = 0;
+        for (char *t = strtok(line, " \t\r\n"); t; t = strtok(NULL, " \t\r\n")) {
+            if (ntok == 7) {
+                ntok++;
+                break;
+            }
+            tok[ntok++] = t;
+        }
+        if (ntok == 0) continue;
+        if (ntok < 4 || ntok > 7) {
+            snprintf(err, errlen, "%s:%d: expected 'name channel op threshold [options]'%s", path,
+                     lineno, ntok > 7 ? " with at most 3 options" : "");
+            rc = -1;
+            break;
+        }
+
+        int channel = parse_channel(tok[1]);
+        int op = parse_op(tok[2]);
+        char *end;
+        float threshold = strtof(tok[3], &end);
+        if (channel < 0 || op < 0 || *end != '\0') {
+            snprintf(err, errlen, "%s:%d: bad channel, comparator or threshold", path, lineno);
+            rc = -1;
+            break;
+        }
+
+        float hyst = 0.0f, min_s = 0.0f, rate_s = 0.0f;
+        for (int i = 4; i < ntok; i++) {
+            char *eq = strchr(tok[i], '=');
+            float *dst = !eq ? NULL
+                       : strncmp(tok[i], "hysteresis=", 11) == 0 ? &hyst
+                       : strncmp(tok[i], "min_duration=", 13) == 0 ? &min_s
+                       : strncmp(tok[i], "rate_limit=", 11) == 0 ? &rate_s : NULL;
+            if (!dst) {
+                snprintf(err, errlen, "%s:%d: unknown option '%s'", path, lineno, tok[i]);
+                rc = -1;
+                break;
+            }
+            *dst = strtof(eq + 1, &end);
+            if (end == eq + 1 || *end != '\0') {
+                snprintf(err, errlen, "%s:%d: bad value for option '%.*s'", path, lineno,
+                         (int)(eq - tok[i]), tok[i]);
+                rc = -1;
+                break;
+            }
+        }
+        if (rc == 0 && alarm_rules_add(rs, tok[0], channel, (RuleOp)op, threshold,
+                                       hyst, min_s, rate_s) < 0) {
+            snprintf(err, errlen, "%s:%d: invalid rule (negative option or more than %d rules)",
+                     path, lineno, ALARM_RULES_MAX);
+            rc = -1;
+        }
+    }
+    fclose(f);
+    if (rc == 0 && rs->count == 0) {
+        snprintf(err, errlen, "%s: no rules", path);
+        rc = -1;
+    }
+    return rc;
+}
+
+void alarm_rules_reset(AlarmRules *rs) {
+    memset(rs->state, RULE_CLEAR, sizeof(rs->state));
+    memset(rs->flags, 0, sizeof(rs->flags));
+}
+
+static inline int rule_hit(int op, float v, float limit) {
+    switch (op) {
+    case RULE_GT: return v > limit;
+    case RULE_GE: return v >= limit;
+    case RULE_LT: return v < limit;
+    default:      return v <= limit;
+    }
+}
+
+static inline void emit(AlarmRules *rs, AlarmEvent *events, size_t max, size_t *n,
+                        size_t r, AlarmEventType type, float v, uint64_t ts) {
+    if (*n < max) {
+        events[*n].rule = (uint16_t)r;
+        events[*n].type = (uint8_t)type;
+        events[*n].value = v;
+        events[*n].timestamp = ts;
+        (*n)++;
+    } else {
+        rs->events_dropped++;
+    }
+}
+
+// One rule, one sample: advance the state machine held in *state/*flags/
+// *since/*last_notify and emit the transition, if any
+static inline void rule_step(AlarmRules *rs, size_t r, uint8_t *state, uint8_t *flags,
+                             uint64_t *since, uint64_t *last_notify,
+                             float v, uint64_t ts,
+                             AlarmEvent *events, size_t max, size_t *nev) {
+    if (*state == RULE_ACTIVE) {
+        // stays active until the value is back past the hysteresis band
+        if (rule_hit(rs->op[r], v, rs->clear_at[r])) return;
+        *state = RULE_CLEAR;
+        rs->cleared[r]++;
+        if (*flags & RULE_FLAG_NOTIFIED)
+            emit(rs, events, max, nev, r, ALARM_EVENT_CLEAR, v, ts);
+        *flags &= (uint8_t)~RULE_FLAG_NOTIFIED;
+        return;
+    }
+
+    if (!rule_hit(rs->op[r], v, rs->raise_at[r])) {
+        *state = RULE_CLEAR;   // PENDING that did not last
+        return;
+    }
+    if (*state == RULE_CLEAR) {
+        *state = RULE_PENDING;
+        *since = ts;
+    }
+    if (ts - *since < rs->min_ticks[r]) return;
+
+    *state = RULE_ACTIVE;
+    rs->raised[r]++;
+    if ((*flags & RULE_FLAG_EVER) && ts - *last_notify < rs->rate_ticks[r]) {
+        rs->suppressed[r]++;
+        return;
+    }
+    *flags |= RULE_FLAG_NOTIFIED | RULE_FLAG_EVER;
+    *last_notify = ts;
+    emit(rs, events, max, nev, r, ALARM_EVENT_RAISE, v, ts);
+}
+
+size_t alarm_rules_eval(AlarmRules *rs, const SensorData *d, size_t n,
+                        AlarmEvent *events, size_t max) {
+    size_t nev = 0;
+    const size_t count = rs->count;
+
+    for (size_t i = 0; i < n; i++) {
+        const float vals[3] = { d[i].temperature, d[i].pressure, d[i].flow };
+        const uint64_t ts = d[i].timestamp;
+
+        for (size_t r = 0; r < count; r++)
+            rule_step(rs, r, &rs->state[r], &rs->flags[r], &rs->since[r], &rs->last_notify[r],
+                      vals[rs->channel[r]], ts, events, max, &nev);
+    }
+    return nev;
+}
+
+void alarm_rules_source_init(const AlarmRules *rs, AlarmRuleSource *src) {
+    memset(src, 0, rs->count * sizeof(*src));
+}
+
+size_t alarm_rules_eval_source(AlarmRules *rs, AlarmRuleSource *src, const SensorData *d, size_t n,
+                               AlarmEvent *events, size_t max) {
+    size_t nev = 0;
+    const size_t count = rs->count;
+
+    for (size_t i = 0; i < n; i++) {
+        const float vals[3] = { d[i].temperature, d[i].pressure, d[i].flow };
+        const uint64_t ts = d[i].timestamp;
+
+        for (size_t r = 0; r < count; r++)
+            rule_step(rs, r, &src[r].state, &src[r].flags, &src[r].since, &src[r].last_notify,
+                      vals[rs->channel[r]], ts, events, max, &nev);
+    }
+    return nev;
+}
@@ -0,0 +1,108 @@
+/*
+ * Alarm Rule Engine
+ * Author: Evara
+ *
+ * Replaces the compile-time TEMP/PRESS/FLOW limits with rules loaded from
+ * a config file. Each rule has:
+ *  - channel     temperature | pressure | flow
+ *  - comparator  >  >=  <  <=
+ *  - threshold   value that raises the alarm
+ *  - hysteresis  how far back past the threshold the value must go before
+ *                the alarm clears (stops flapping around the limit)
+ *  - min_duration seconds the condition must hold before raising (debounce)
+ *  - rate_limit  minimum seconds between two notifications of the rule
+ *
+ * Rules are compiled into a structure-of-arrays table (alarm_rules_eval()
+ * touches a few bytes per rule) and each rule runs a small state machine
+ * CLEAR -> PENDING -> ACTIVE -> CLEAR. Only transitions produce events, so
+ * a value hovering at the limit yields one RAISE and one CLEAR instead of
+ * a line per sample.
+ *
+ * Config file: one rule per line, '#' starts a comment
+ *   # name      channel      op  threshold  [hysteresis=H] [min_duration=S] [rate_limit=S]
+ *   high_temp   temperature  >   80         hysteresis=2 min_duration=3 rate_limit=60
+ */
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_data.h"
+
+#define ALARM_RULES_MAX   64
+#define ALARM_RULE_NAME   32
+
+typedef enum { RULE_GT = 0, RULE_GE, RULE_LT, RULE_LE } RuleOp;
+typedef enum { RULE_CLEAR = 0, RULE_PENDING, RULE_ACTIVE } RuleState;
+
+typedef enum {
+    ALARM_EVENT_RAISE = 1,
+    ALARM_EVENT_CLEAR = 2
+} AlarmEventType;
+
+typedef struct {
+    uint16_t rule;             // index into the table
+    uint8_t  type;             // AlarmEventType
+    float    value;            // channel value that caused the transition
+    uint64_t timestamp;
+} AlarmEvent;
+
+// Rule state for one source when many sensors share a rule table; the
+// table's own state arrays serve the single-sensor alarm_rules_eval()
+typedef struct {
+    uint8_t  state;
+    uint8_t  flags;
+    uint64_t since;
+    uint64_t last_notify;
+} AlarmRuleSource;
+
+typedef struct {
+    size_t count;
+    double ticks_per_s;        // SensorData.timestamp units per second
+
+    // Compiled evaluation table, hot fields first
+    uint8_t  channel[ALARM_RULES_MAX];
+    uint8_t  op[ALARM_RULES_MAX];
+    uint8_t  state[ALARM_RULES_MAX];
+    uint8_t  flags[ALARM_RULES_MAX];
+    float    raise_at[ALARM_RULES_MAX];
+    float    clear_at[ALARM_RULES_MAX];     // threshold moved back by the hysteresis
+    uint64_t min_ticks[ALARM_RULES_MAX];
+    uint64_t rate_ticks[ALARM_RULES_MAX];
+    uint64_t since[ALARM_RULES_MAX];        // condition first seen (PENDING)
+    uint64_t last_notify[ALARM_RULES_MAX];
+
+    // Rule definitions, for messages
+    char  name[ALARM_RULES_MAX][ALARM_RULE_NAME];
+    float threshold[ALARM_RULES_MAX];
+    float hysteresis[ALARM_RULES_MAX];
+
+    // Statistics per rule
+    unsigned long raised[ALARM_RULES_MAX];      // episodes that became ACTIVE
+    unsigned long suppressed[ALARM_RULES_MAX];  // raises muted by the rate limit
+    unsigned long cleared[ALARM_RULES_MAX];
+    unsigned long events_dropped;               // event buffer was full
+} AlarmRules;
+
+void alarm_rules_init(AlarmRules *rs, double ticks_per_s);
+// returns the rule index, or -1 when the table is full or arguments are invalid
+int  alarm_rules_add(AlarmRules *rs, const char *name, int channel, RuleOp op, float threshold,
+                     float hysteresis, float min_duration_s, float rate_limit_s);
+// 0 on success; on error a message with the line number is written to err
+int  alarm_rules_load(AlarmRules *rs, const char *path, char *err, size_t errlen);
+void alarm_rules_reset(AlarmRules *rs);   // all rules back to CLEAR, statistics kept
+
+// Evaluate every rule for n samples; writes up to max events, returns how many
+size_t alarm_rules_eval(AlarmRules *rs, const SensorData *d, size_t n,
+                        AlarmEvent *events, size_t max);
+
+// Same, with the state taken from src[0..count-1] instead of the table;
+// statistics still accumulate in rs. Add all rules before sizing src.
+void   alarm_rules_source_init(const AlarmRules *rs, AlarmRuleSource *src);
+size_t alarm_rules_eval_source(AlarmRules *rs, AlarmRuleSource *src, const SensorData *d, size_t n,
+                               AlarmEvent *events, size_t max);
+
+const char *alarm_rules_channel_name(int channel);
+const char *alarm_rules_op_name(RuleOp op);
+
+#endif
@@ -0,0 +1,252 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "binlog.h"
+#include "gorilla.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static size_t column_max_bytes(int col, uint32_t n) {
+    return col == 0 ? GORILLA_TS_MAX_BYTES(n) : GORILLA_F32_MAX_BYTES(n);
+}
+
+static uint32_t header_crc(const BinlogSegmentHeader *h) {
+    return crc32_update(0, h, offsetof(BinlogSegmentHeader, header_crc));
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static float channel_value(const SensorData *s, int ch) {
+    return ch == 0 ? s->temperature : ch == 1 ? s->pressure : s->flow;
+}
+
+static void set_channel_value(SensorData *s, int ch, float v) {
+    if (ch == 0) s->temperature = v;
+    else if (ch == 1) s->pressure = v;
+    else s->flow = v;
+}
+
+// ===============================
+// --- Writer --------------------
+// ===============================
+int binlog_open(BinlogWriter *w, const char *path, uint32_t segment_samples,
+                uint32_t ts_tick, const LogWriterConfig *cfg) {
+    LogWriterConfig lcfg;
+    memset(w, 0, sizeof(*w));
+    w->ts_tick = ts_tick;
+    w->segment_samples = segment_samples ? segment_samples : BINLOG_DEFAULT_SEGMENT;
+    if (cfg) lcfg = *cfg;
+    else log_writer_default_config(&lcfg);
+
+    // Sync policies count samples here; the log writer only sees segments
+    if (lcfg.sync == LOG_SYNC_EVERY_N) {
+        if (lcfg.sync_every > 0 && lcfg.sync_every < w->segment_samples)
+            w->segment_samples = (uint32_t)lcfg.sync_every;
+        lcfg.sync_every = 1;
+    } else if (lcfg.sync == LOG_SYNC_INTERVAL) {
+        w->max_open_ns = (uint64_t)lcfg.sync_ms * 1000000ull;
+    }
+
+    w->encode_cap = sizeof(BinlogSegmentHeader);
+    for (int c = 0; c < BINLOG_COLUMNS; c++)
+        w->encode_cap += column_max_bytes(c, w->segment_samples);
+
+    w->pending = (SensorData *)malloc(w->segment_samples * sizeof(SensorData));
+    w->encode_buf = (uint8_t *)malloc(w->encode_cap);
+    if (!w->pending || !w->encode_buf) {
+        free(w->pending);
+        free(w->encode_buf);
+        return -1;
+    }
+
+    // A segment goes to the log writer as one record, so it must fit a buffer
+    if (lcfg.buffer_size < w->encode_cap) lcfg.buffer_size = w->encode_cap;
+
+    if (log_writer_open(&w->out, path, 1, &lcfg) != 0) {
+        free(w->pending);
+        free(w->encode_buf);
+        return -1;
+    }
+
+    BinlogFileHeader fh;
+    memset(&fh, 0, sizeof(fh));
+    fh.magic = BINLOG_FILE_MAGIC;
+    fh.version = BINLOG_VERSION;
+    fh.channels = BINLOG_CHANNELS;
+    fh.segment_samples = w->segment_samples;
+    fh.ts_tick = w->ts_tick;
+    w->bytes = sizeof(fh);
+    return log_writer_write(&w->out, &fh, sizeof(fh));
+}
+
+int binlog_flush_segment(BinlogWriter *w) {
+    if (w->count == 0) return 0;
+
+    BinlogSegmentHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = BINLOG_SEGMENT_MAGIC;
+    h.count = w->count;
+    h.first_ts = w->pending[0].timestamp;
+    h.last_ts = w->pending[w->count - 1].timestamp;
+
+    // Columns are encoded back to back after the header
+    size_t off = sizeof(h);
+    for (int c = 0; c < BINLOG_COLUMNS; c++) {
+        GorillaBitWriter bw;
+        gorilla_writer_init(&bw, w->encode_buf + off, column_max_bytes(c, w->count));
+        if (c == 0) {
+            GorillaTsState st;
+            gorilla_ts_init(&st, w->ts_tick);
+            for (uint32_t i = 0; i < w->count; i++)
+                gorilla_encode_ts(&st, &bw, w->pending[i].timestamp);
+        } else {
+            GorillaF32State st = { 0, 0, 0, 0 };
+            for (uint32_t i = 0; i < w->count; i++)
+                gorilla_encode_f32(&st, &bw, channel_value(&w->pending[i], c - 1));
+        }
+        h.column_bytes[c] = (uint32_t)gorilla_writer_bytes(&bw);
+        w->column_bytes[c] += h.column_bytes[c];
+        off += h.column_bytes[c];
+    }
+
+    h.data_crc = crc32_update(0, w->encode_buf + sizeof(h), off - sizeof(h));
+    h.header_crc = header_crc(&h);
+    memcpy(w->encode_buf, &h, sizeof(h));
+
+    w->count = 0;
+    w->segments++;
+    w->bytes += off;
+    return log_writer_write(&w->out, w->encode_buf, off);
+}
+
+int binlog_append(BinlogWriter *w, const SensorData *s) {
+    if (w->count == 0 && w->max_open_ns) w->opened_ns = monotonic_ns();
+    w->pending[w->count++] = *s;
+    w->samples++;
+    if (w->count == w->segment_samples) return binlog_flush_segment(w);
+    if (w->max_open_ns && monotonic_ns() - w->opened_ns >= w->max_open_ns)
+        return binlog_flush_segment(w);
+    return 0;
+}
+
+void binlog_close(BinlogWriter *w) {
+    binlog_flush_segment(w);
+    log_writer_close(&w->out);
+    free(w->pending);
+    free(w->encode_buf);
+    w->pending = NULL;
+    w->encode_buf = NULL;
+}
+
+// ===============================
+// --- Reader --------------------
+// ===============================
+int binlog_reader_open(BinlogReader *r, const char *path) {
+    BinlogFileHeader fh;
+    memset(r, 0, sizeof(*r));
+    r->f = fopen(path, "rb");
+    if (!r->f) return -1;
+    if (fread(&fh, sizeof(fh), 1, r->f) != 1 || fh.magic != BINLOG_FILE_MAGIC ||
+        fh.version < 1 || fh.version > BINLOG_VERSION || fh.channels != BINLOG_CHANNELS) {
+        fclose(r->f);
+        r->f = NULL;
+        return -1;
+    }
+    r->ts_tick = fh.version >= 2 ? fh.ts_tick : 0;
+    return 0;
+}
+
+// Grow a scratch buffer; returns 0 on allocation failure
+static int reserve(void **buf, size_t *cap, size_t need) {
+    if (*cap >= need) return 1;
+    void *p = realloc(*buf, need);
+    if (!p) return 0;
+    *buf = p;
+    *cap = need;
+    return 1;
+}
+
+// Load and decode the next segment: 1 = loaded, 0 = end of file, -1 = error
+static int load_segment(BinlogReader *r) {
+    for (;;) {
+        BinlogSegmentHeader h;
+        size_t got = fread(&h, 1, sizeof(h), r->f);
+        if (got == 0) return 0;
+        if (got < sizeof(h)) {
+            r->truncated = 1;
+            return 0;
+        }
+        if (h.magic != BINLOG_SEGMENT_MAGIC || h.header_crc != header_crc(&h))
+            return -1;   // column sizes cannot be trusted, no way to resync
+
+        size_t total = 0;
+        for (int c = 0; c < BINLOG_COLUMNS; c++) total += h.column_bytes[c];
+        if (!reserve((void **)&r->col_buf, &r->col_cap, total)) return -1;
+        if (fread(r->col_buf, 1, total, r->f) != total) {
+            r->truncated = 1;   // writer died mid-segment
+            return 0;
+        }
+        if (crc32_update(0, r->col_buf, total) != h.data_crc) {
+            r->bad_segments++;
+            continue;
+        }
+
+        if (h.count > r->seg_cap) {
+            SensorData *p = (SensorData *)realloc(r->seg, h.count * sizeof(SensorData));
+            if (!p) return -1;
+            r->seg = p;
+            r->seg_cap = h.count;
+        }
+
+        const uint8_t *col = r->col_buf;
+        int error = 0;
+        for (int c = 0; c < BINLOG_COLUMNS; c++) {
+            GorillaBitReader br;
+            gorilla_reader_init(&br, col, h.column_bytes[c]);
+            if (c == 0) {
+                GorillaTsState st;
+                gorilla_ts_init(&st, r->ts_tick);
+                for (uint32_t i = 0; i < h.count; i++)
+                    r->seg[i].timestamp = gorilla_decode_ts(&st, &br);
+            } else {
+                GorillaF32State st = { 0, 0, 0, 0 };
+                for (uint32_t i = 0; i < h.count; i++)
+                    set_channel_value(&r->seg[i], c - 1, gorilla_decode_f32(&st, &br));
+            }
+            error |= br.error;
+            col += h.column_bytes[c];
+        }
+        if (error) {
+            r->bad_segments++;
+            continue;
+        }
+
+        r->count = h.count;
+        r->pos = 0;
+        r->segments++;
+        return 1;
+    }
+}
+
+int binlog_read(BinlogReader *r, SensorData *out) {
+    while (r->pos == r->count) {
+        int rc = load_segment(r);
+        if (rc <= 0) return rc;
+    }
+    *out = r->seg[r->pos++];
+    r->samples++;
+    return 1;
+}
+
+void binlog_reader_close(BinlogReader *r) {
+    if (r->f) fclose(r->f);
+    free(r->seg);
+    free(r->col_buf);
+    memset(r, 0, sizeof(*r));
+}
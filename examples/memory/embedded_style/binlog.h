@@ -0,0 +1,109 @@
+/*
+ * Binary Columnar Sensor Log
+ * Author: Evara
+ *
+ * Compact alternative to data_log.csv. Samples are grouped into segments;
+ * inside a segment every channel is stored as its own column and compressed
+ * with the Gorilla codec (firmware/inc/gorilla.h):
+ *  - timestamps: delta-of-delta, 1 bit per sample at a steady rate; they
+ *    are rounded to the file's tick first (BINLOG_TICK_NS for the loggers'
+ *    ns timestamps), so sampling jitter stays in the small dod buckets
+ *  - temperature / pressure / flow: XOR against the previous value
+ *
+ * File layout:
+ *   BinlogFileHeader
+ *   { BinlogSegmentHeader, ts column, temp column, press column, flow column }*
+ *
+ * Each segment header carries its own CRC and a CRC of the column data, so a
+ * reader can stop cleanly at a torn tail and skip a corrupted segment.
+ *
+ * The log writer's sync policy is applied to samples, not segments: with
+ * every:N a segment is closed (and synced) after at most N samples, with
+ * interval:MS a partial segment is closed once it has been open MS
+ * milliseconds. Short segments compress less well; that is the price of
+ * durability.
+ * All integers are little-endian (the host byte order of every target).
+ */
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "sensor_data.h"
+#include "log_writer.h"
+
+#define BINLOG_FILE_MAGIC     0x474C5645u  // "EVLG"
+#define BINLOG_SEGMENT_MAGIC  0x31474553u  // "SEG1"
+#define BINLOG_VERSION        2            // 2: ts_tick in the file header
+#define BINLOG_CHANNELS       3
+#define BINLOG_COLUMNS        (1 + BINLOG_CHANNELS)
+#define BINLOG_DEFAULT_SEGMENT 4096         // samples per segment
+#define BINLOG_TICK_NS        1000u        // 1 us: far below the loggers' timer jitter
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t channels;
+    uint32_t segment_samples;  // writer's segment size (informative)
+    uint32_t ts_tick;          // timestamps are multiples of it (v1: reserved, 0 = exact)
+} BinlogFileHeader;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;                       // samples in this segment
+    uint64_t first_ts;
+    uint64_t last_ts;
+    uint32_t column_bytes[BINLOG_COLUMNS];// timestamp, temperature, pressure, flow
+    uint32_t data_crc;                    // CRC-32 of all column bytes
+    uint32_t header_crc;                  // CRC-32 of the fields above
+} BinlogSegmentHeader;
+
+typedef struct {
+    LogWriter out;             // async batched file writer (log_writer.h)
+    SensorData *pending;       // samples of the open segment
+    uint32_t segment_samples;  // closes a segment; <= sync_every for every:N
+    uint32_t count;
+    uint32_t ts_tick;          // 0 or 1 = exact timestamps
+    uint64_t max_open_ns;      // interval:MS, 0 = segments close only when full
+    uint64_t opened_ns;        // CLOCK_MONOTONIC at the first pending sample
+    uint8_t *encode_buf;
+    size_t encode_cap;
+
+    // Statistics
+    unsigned long samples;
+    unsigned long segments;
+    unsigned long long bytes;  // file bytes including headers
+    unsigned long long column_bytes[BINLOG_COLUMNS];   // encoded, over all segments
+} BinlogWriter;
+
+typedef struct {
+    FILE *f;
+    SensorData *seg;           // decoded samples of the current segment
+    uint32_t seg_cap;
+    uint32_t count;
+    uint32_t pos;
+    uint8_t *col_buf;
+    size_t col_cap;
+    uint32_t ts_tick;
+
+    // Statistics
+    unsigned long samples;
+    unsigned long segments;
+    unsigned long bad_segments; // CRC mismatch, skipped
+    int truncated;              // stopped at an incomplete segment
+} BinlogReader;
+
+// segment_samples 0 = BINLOG_DEFAULT_SEGMENT; ts_tick: timestamps are rounded
+// to multiples of it (0 = exact); cfg NULL = log writer defaults
+int  binlog_open(BinlogWriter *w, const char *path, uint32_t segment_samples,
+                 uint32_t ts_tick, const LogWriterConfig *cfg);
+int  binlog_append(BinlogWriter *w, const SensorData *s);
+int  binlog_flush_segment(BinlogWriter *w);   // close the open segment early
+void binlog_close(BinlogWriter *w);           // flush partial segment, close file
+
+int  binlog_reader_open(BinlogReader *r, const char *path);
+int  binlog_read(BinlogReader *r, SensorData *out);  // 1 = sample, 0 = end, -1 = error
+void binlog_reader_close(BinlogReader *r);
+
+#endif
@@ -0,0 +1,134 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dashboard.h"
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#define ESC "\x1b"
+
+void dashboard_init(Dashboard *d, int fd, int rows, double max_fps) {
+    memset(d, 0, sizeof(*d));
+    d->fd = fd;
+    d->rows = rows < 1 ? 1 : rows > DASHBOARD_MAX_ROWS ? DASHBOARD_MAX_ROWS : rows;
+    d->min_interval_s = max_fps > 0 ? 1.0 / max_fps : 0.0;
+}
+
+void dashboard_push(Dashboard *d, const SensorData *s) {
+    d->row[d->seq % (unsigned long)d->rows] = *s;
+    d->seq++;
+}
+
+int dashboard_due(const Dashboard *d, double now_s) {
+    return !d->started || now_s - d->last_frame_s >= d->min_interval_s;
+}
+
+void dashboard_status(Dashboard *d, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(d->status, sizeof(d->status), fmt, ap);
+    va_end(ap);
+}
+
+void dashboard_alarms(Dashboard *d, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(d->alarms, sizeof(d->alarms), fmt, ap);
+    va_end(ap);
+}
+
+void dashboard_stats(Dashboard *d, SensorChannel ch, const ChannelStats *st) {
+    d->stats[ch] = *st;
+    d->has_stats = 1;
+}
+
+static void append(Dashboard *d, const char *s, size_t n) {
+    if (d->frame_len + n > sizeof(d->frame)) n = sizeof(d->frame) - d->frame_len;
+    memcpy(d->frame + d->frame_len, s, n);
+    d->frame_len += n;
+}
+
+// Format line i of the region; queue it only if it differs from the screen
+static void line(Dashboard *d, int i, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+static void line(Dashboard *d, int i, const char *fmt, ...) {
+    char text[DASHBOARD_COLS], move[16];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+
+    if (i >= d->lines) d->lines = i + 1;
+    if (strcmp(text, d->screen[i]) == 0) return;
+    memcpy(d->screen[i], text, sizeof(text));
+    int n = snprintf(move, sizeof(move), ESC "[%d;1H", i + 1);
+    append(d, move, (size_t)n);
+    append(d, text, strlen(text));
+    append(d, ESC "[K", 3);
+    d->lines_sent++;
+}
+
+static void send_frame(Dashboard *d) {
+    size_t off = 0;
+    while (off < d->frame_len) {        // one write() unless the tty cuts it short
+        ssize_t n = write(d->fd, d->frame + off, d->frame_len - off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        off += (size_t)n;
+    }
+    d->bytes_sent += off;
+    d->frame_len = 0;
+}
+
+int dashboard_render(Dashboard *d, double now_s, int force) {
+    static const char *names[SENSOR_CHANNELS] = { "Temp", "Press", "Flow" };
+    if (!force && !dashboard_due(d, now_s)) return 0;
+
+    d->frame_len = 0;
+    if (!d->started) {
+        // hide the cursor, clear; \x01 never matches a line so all are drawn
+        append(d, ESC "[?25l" ESC "[H" ESC "[2J", 13);
+        for (int i = 0; i < DASHBOARD_LINES; i++) strcpy(d->screen[i], "\x01");
+        d->started = 1;
+    }
+
+    int i = 0;
+    line(d, i++, "SENSOR DASHBOARD | %s", d->status);
+    line(d, i++, "Slot | Temp (°C) | Press (bar) | Flow (L/min) | Timestamp");
+    line(d, i++, "----------------------------------------------------------");
+    unsigned long newest = d->seq ? (d->seq - 1) % (unsigned long)d->rows : 0;
+    for (int r = 0; r < d->rows; r++) {
+        const SensorData *s = &d->row[r];
+        if ((unsigned long)r >= d->seq)
+            line(d, i++, "%4d |", r);
+        else
+            line(d, i++, "%4d%c| %9.2f | %11.2f | %12.2f | %" PRIu64, r,
+                 (unsigned long)r == newest ? '>' : ' ', s->temperature, s->pressure, s->flow,
+                 s->timestamp);
+    }
+    line(d, i++, "----------------------------------------------------------");
+    if (d->has_stats) {
+        line(d, i++, "Stat  |     Mean |  Variance |      Min |      Max |   Rate/s");
+        for (int c = 0; c < SENSOR_CHANNELS; c++) {
+            const ChannelStats *st = &d->stats[c];
+            line(d, i++, "%-5s | %8.2f | %9.2f | %8.2f | %8.2f | %8.2f", names[c], st->mean,
+                 st->variance, st->min, st->max, st->rate_per_s);
+        }
+    }
+    line(d, i++, "Alarms: %s", d->alarms);
+
+    if (d->frame_len) send_frame(d);
+    d->last_frame_s = now_s;
+    d->frames++;
+    return 1;
+}
+
+void dashboard_close(Dashboard *d, double now_s) {
+    char tail[32];
+    dashboard_render(d, now_s, 1);
+    int n = snprintf(tail, sizeof(tail), ESC "[%d;1H" ESC "[?25h\n", d->lines + 1);
+    append(d, tail, (size_t)n);
+    send_frame(d);
+}
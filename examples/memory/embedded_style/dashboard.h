@@ -0,0 +1,77 @@
+/*
+ * Incremental Terminal Dashboard
+ * Author: Evara
+ *
+ * Replacement for printBuffer(), which reprints the whole buffer after
+ * every reading (O(buffer size) terminal output per sample). The dashboard
+ * owns a fixed screen region and redraws it with ANSI cursor addressing:
+ *  - readings are shown by ring slot (reading n goes to row n % rows),
+ *    like the circular buffer itself, so a new reading changes one row
+ *    plus the newest-row marker instead of scrolling every row
+ *  - the previous frame is kept line by line; only lines whose text
+ *    changed are sent, each as "cursor to line, text, clear to EOL"
+ *  - frames are rate limited (max_fps): readings arriving in between only
+ *    update the in-memory rows, and the caller computes the rolling
+ *    statistics only when dashboard_due() says a frame will be drawn
+ *  - every frame is assembled in one buffer and sent with one write()
+ *
+ * Panel below the rows: a status line, the rolling statistics of each
+ * channel (sensor_history.h) and an alarm line set by the caller.
+ *
+ * Single thread: push, set and render from the display stage.
+ */
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <stddef.h>
+#include "sensor_data.h"
+#include "sensor_history.h"
+
+#define DASHBOARD_MAX_ROWS   32      // reading rows shown at most
+#define DASHBOARD_COLS       100     // bytes per line, including the NUL
+#define DASHBOARD_LINES      (DASHBOARD_MAX_ROWS + 4 + SENSOR_CHANNELS + 3)
+#define DASHBOARD_FRAME_MAX  (DASHBOARD_LINES * (DASHBOARD_COLS + 16) + 32)
+
+typedef struct {
+    int fd;
+    int rows;                        // reading rows in use
+    double min_interval_s;           // 1 / max_fps
+    double last_frame_s;
+    int started;                     // screen cleared, cursor hidden
+
+    unsigned long seq;               // readings pushed
+    SensorData row[DASHBOARD_MAX_ROWS];
+
+    // Panel text set by the caller
+    char status[DASHBOARD_COLS];
+    char alarms[DASHBOARD_COLS];
+    ChannelStats stats[SENSOR_CHANNELS];
+    int has_stats;
+
+    char screen[DASHBOARD_LINES][DASHBOARD_COLS];   // what the terminal shows
+    char frame[DASHBOARD_FRAME_MAX];
+    size_t frame_len;
+    int lines;                       // lines of the region drawn so far
+
+    // Statistics
+    unsigned long frames;
+    unsigned long lines_sent;        // lines redrawn over all frames
+    unsigned long long bytes_sent;
+} Dashboard;
+
+// rows: reading rows to show, clamped to 1..DASHBOARD_MAX_ROWS; with a
+// larger buffer the region shows only the newest DASHBOARD_MAX_ROWS readings
+void dashboard_init(Dashboard *d, int fd, int rows, double max_fps);
+void dashboard_push(Dashboard *d, const SensorData *s);
+int  dashboard_due(const Dashboard *d, double now_s);   // a render now would draw
+
+void dashboard_status(Dashboard *d, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void dashboard_alarms(Dashboard *d, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void dashboard_stats(Dashboard *d, SensorChannel ch, const ChannelStats *st);
+
+// Draws a frame if one is due (or force): returns 1 if a frame was written
+int  dashboard_render(Dashboard *d, double now_s, int force);
+// Final frame, cursor back below the region and visible
+void dashboard_close(Dashboard *d, double now_s);
+
+#endif
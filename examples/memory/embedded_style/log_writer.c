@@ -0,0 +1,223 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static double monotonic_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+void log_writer_default_config(LogWriterConfig *cfg) {
+    cfg->buffer_size = 1u << 20;
+    cfg->flush_ms = 100;
+    cfg->sync = LOG_SYNC_NONE;
+    cfg->sync_every = 0;
+    cfg->sync_ms = 0;
+}
+
+int log_writer_parse_sync(LogWriterConfig *cfg, const char *spec) {
+    if (strcmp(spec, "none") == 0) {
+        cfg->sync = LOG_SYNC_NONE;
+    } else if (strncmp(spec, "every:", 6) == 0 && atol(spec + 6) > 0) {
+        cfg->sync = LOG_SYNC_EVERY_N;
+        cfg->sync_every = (unsigned long)atol(spec + 6);
+    } else if (strncmp(spec, "interval:", 9) == 0 && atoi(spec + 9) > 0) {
+        cfg->sync = LOG_SYNC_INTERVAL;
+        cfg->sync_ms = (unsigned int)atoi(spec + 9);
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static void write_all(LogWriter *w, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(w->fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (!w->error) w->error = errno;
+            return;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+// every:N is due: N records buffered or written since the last sync (lock held)
+static int sync_due(const LogWriter *w) {
+    return w->cfg.sync == LOG_SYNC_EVERY_N && w->active_records > 0 &&
+           w->unsynced + w->active_records >= w->cfg.sync_every;
+}
+
+static void *flusher_thread(void *arg) {
+    LogWriter *w = (LogWriter *)arg;
+    double last_sync = monotonic_s();
+
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        // wait for a full buffer, a due sync, the flush interval, or close
+        if (!w->closing && w->active_len < w->cfg.buffer_size / 2 && !sync_due(w)) {
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            long ns = until.tv_nsec + (long)(w->cfg.flush_ms % 1000) * 1000000L;
+            until.tv_sec += (time_t)(w->cfg.flush_ms / 1000) + ns / 1000000000L;
+            until.tv_nsec = ns % 1000000000L;
+            pthread_cond_timedwait(&w->wake, &w->lock, &until);
+        }
+
+        // swap buffers under the lock, write outside it
+        char *buf = w->active;
+        size_t len = w->active_len;
+        unsigned long recs = w->active_records;
+        int closing = w->closing;
+        w->active = w->spare;
+        w->spare = buf;
+        w->active_len = 0;
+        w->active_records = 0;
+        w->unsynced += recs;
+        unsigned long unsynced = w->unsynced;
+        pthread_cond_broadcast(&w->space);
+        pthread_mutex_unlock(&w->lock);
+
+        if (len > 0) write_all(w, buf, len);
+
+        int do_sync = 0;
+        if (w->cfg.sync == LOG_SYNC_EVERY_N && unsynced >= w->cfg.sync_every) do_sync = 1;
+        if (w->cfg.sync == LOG_SYNC_INTERVAL && unsynced > 0 &&
+            monotonic_s() - last_sync >= w->cfg.sync_ms / 1e3) do_sync = 1;
+        if (closing && w->cfg.sync != LOG_SYNC_NONE && unsynced > 0) do_sync = 1;
+        if (do_sync) {
+            if (fdatasync(w->fd) != 0 && !w->error) w->error = errno;
+            last_sync = monotonic_s();
+        }
+
+        pthread_mutex_lock(&w->lock);
+        if (len > 0) w->flushes++;
+        w->written += len;
+        if (do_sync) {
+            w->syncs++;
+            w->unsynced -= unsynced;
+        }
+        // the spare buffer is free again: wake producers waiting on it
+        pthread_cond_broadcast(&w->space);
+        if (closing && w->active_len == 0) break;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+int log_writer_open(LogWriter *w, const char *path, int truncate, const LogWriterConfig *cfg) {
+    memset(w, 0, sizeof(*w));
+    if (cfg) w->cfg = *cfg;
+    else log_writer_default_config(&w->cfg);
+    if (w->cfg.buffer_size < 4 * LOG_WRITER_MAX_RECORD) w->cfg.buffer_size = 4 * LOG_WRITER_MAX_RECORD;
+    if (w->cfg.flush_ms == 0) w->cfg.flush_ms = 100;
+
+    w->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+    if (w->fd < 0) return -1;
+
+    w->active = malloc(w->cfg.buffer_size);
+    w->spare = malloc(w->cfg.buffer_size);
+    if (!w->active || !w->spare) goto fail;
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    pthread_cond_init(&w->space, NULL);
+    if (pthread_create(&w->thread, NULL, flusher_thread, w) != 0) {
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->wake);
+        pthread_cond_destroy(&w->space);
+        goto fail;
+    }
+    return 0;
+
+fail:
+    // leave it closed: a later log_writer_close() must not join or close again
+    free(w->active);
+    free(w->spare);
+    w->active = w->spare = NULL;
+    close(w->fd);
+    w->fd = -1;
+    return -1;
+}
+
+// Reserve len bytes in the active buffer (lock held on return)
+static char *reserve(LogWriter *w, size_t len) {
+    pthread_mutex_lock(&w->lock);
+    while (w->active_len + len > w->cfg.buffer_size) {
+        // active buffer full and the flusher still owns the spare one
+        w->stalls++;
+        pthread_cond_signal(&w->wake);
+        pthread_cond_wait(&w->space, &w->lock);
+    }
+    return w->active + w->active_len;
+}
+
+static void commit(LogWriter *w, size_t len) {
+    w->active_len += len;
+    w->active_records++;
+    w->records++;
+    w->bytes += len;
+    if (w->active_len >= w->cfg.buffer_size / 2 || sync_due(w)) pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+}
+
+int log_writer_write(LogWriter *w, const void *data, size_t len) {
+    if (len > w->cfg.buffer_size) return -1;
+    char *dst = reserve(w, len);
+    memcpy(dst, data, len);
+    commit(w, len);
+    return 0;
+}
+
+int log_writer_printf(LogWriter *w, const char *fmt, ...) {
+    va_list ap;
+    char *dst = reserve(w, LOG_WRITER_MAX_RECORD);
+    va_start(ap, fmt);
+    int n = vsnprintf(dst, LOG_WRITER_MAX_RECORD, fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        pthread_mutex_unlock(&w->lock);
+        return -1;
+    }
+    if (n >= LOG_WRITER_MAX_RECORD) n = LOG_WRITER_MAX_RECORD - 1;  // truncated
+    commit(w, (size_t)n);
+    return n;
+}
+
+void log_writer_flush(LogWriter *w) {
+    pthread_mutex_lock(&w->lock);
+    unsigned long long target = w->bytes;
+    while (w->written < target) {
+        pthread_cond_signal(&w->wake);
+        pthread_cond_wait(&w->space, &w->lock);
+    }
+    pthread_mutex_unlock(&w->lock);
+}
+
+void log_writer_close(LogWriter *w) {
+    if (w->fd < 0) return;
+    pthread_mutex_lock(&w->lock);
+    w->closing = 1;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    close(w->fd);
+    w->fd = -1;
+    free(w->active);
+    free(w->spare);
+    w->active = w->spare = NULL;
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->wake);
+    pthread_cond_destroy(&w->space);
+}
@@ -0,0 +1,74 @@
+/*
+ * Log Writer
+ * Author: Evara
+ *
+ * Persistent, batched, asynchronous file writer for the sensor loggers.
+ *  - The file descriptor stays open for the whole run
+ *  - Records are appended to a large in-memory buffer (double-buffered)
+ *  - A background thread writes a buffer out when it reaches the size
+ *    threshold or when flush_ms has elapsed, whichever comes first
+ *  - Durability is configurable: none (page cache only), fdatasync every
+ *    N records, or fdatasync every sync_ms milliseconds. With every:N the
+ *    N-th unsynced record wakes the flusher at once, so at most N records
+ *    (plus any appended while that flush runs) are ever unsynced
+ */
+#ifndef LOG_WRITER_H
+#define LOG_WRITER_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+typedef enum {
+    LOG_SYNC_NONE = 0,     // leave it to the kernel
+    LOG_SYNC_EVERY_N,      // fdatasync after every sync_every records
+    LOG_SYNC_INTERVAL      // fdatasync at most every sync_ms
+} LogSyncPolicy;
+
+typedef struct {
+    size_t        buffer_size;   // bytes per buffer (default 1 MiB)
+    unsigned int  flush_ms;      // max time a record waits in memory (default 100)
+    LogSyncPolicy sync;
+    unsigned long sync_every;    // records, for LOG_SYNC_EVERY_N
+    unsigned int  sync_ms;       // for LOG_SYNC_INTERVAL
+} LogWriterConfig;
+
+typedef struct {
+    int fd;
+    LogWriterConfig cfg;
+
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;        // producer -> flusher: buffer ready / closing
+    pthread_cond_t  space;       // flusher -> producer: buffer swapped out
+    pthread_t       thread;
+
+    char  *active;               // producers append here
+    size_t active_len;
+    unsigned long active_records;
+    char  *spare;                // being written by the flusher
+    unsigned long unsynced;      // records handed to write() since the last fdatasync
+    int    closing;
+
+    // Statistics
+    unsigned long records;
+    unsigned long long bytes;
+    unsigned long long written;  // bytes handed to write() so far
+    unsigned long flushes;       // write() batches
+    unsigned long syncs;         // fdatasync() calls
+    unsigned long stalls;        // producer waited for the flusher
+    int  error;                  // first errno from write/fdatasync
+} LogWriter;
+
+#define LOG_WRITER_MAX_RECORD 512   // longest record accepted by log_writer_printf
+
+void log_writer_default_config(LogWriterConfig *cfg);
+int  log_writer_parse_sync(LogWriterConfig *cfg, const char *spec); // "none", "every:N", "interval:MS"
+
+// truncate != 0 starts a new file, otherwise appends. Returns 0 on success.
+int  log_writer_open(LogWriter *w, const char *path, int truncate, const LogWriterConfig *cfg);
+int  log_writer_write(LogWriter *w, const void *data, size_t len);  // one record
+int  log_writer_printf(LogWriter *w, const char *fmt, ...)
+         __attribute__((format(printf, 2, 3)));
+void log_writer_flush(LogWriter *w);   // write everything buffered so far, then return
+void log_writer_close(LogWriter *w);   // flush, final sync, close fd, join thread
+
+#endif
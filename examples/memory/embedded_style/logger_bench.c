@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "logger_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Exact below 2 * SUB ns, then SUB buckets per power of two
+static unsigned bucket_of(uint64_t v) {
+    if (v < 2 * LOGGER_BENCH_SUB) return (unsigned)v;
+    unsigned e = 63u - (unsigned)__builtin_clzll(v);          // >= 5
+    return 2 * LOGGER_BENCH_SUB + (e - 5) * LOGGER_BENCH_SUB +
+           (unsigned)((v >> (e - 4)) & (LOGGER_BENCH_SUB - 1));
+}
+
+// Middle of a bucket's range
+static uint64_t bucket_value(unsigned b) {
+    if (b < 2 * LOGGER_BENCH_SUB) return b;
+    unsigned k = b - 2 * LOGGER_BENCH_SUB, e = 5 + k / LOGGER_BENCH_SUB;
+    uint64_t lo = (uint64_t)(LOGGER_BENCH_SUB + k % LOGGER_BENCH_SUB) << (e - 4);
+    return lo + (((uint64_t)1 << (e - 4)) >> 1);
+}
+
+const char *logger_bench_usage(void) {
+    return "[--bench N [--buffer N] [--rate HZ]]";
+}
+
+int logger_bench_arg(LoggerBench *b, int argc, char *argv[], int *i) {
+    const char *opt = argv[*i];
+    if (strcmp(opt, "--bench") != 0 && strcmp(opt, "--buffer") != 0 && strcmp(opt, "--rate") != 0)
+        return 0;
+    if (*i + 1 >= argc) return -1;
+    const char *val = argv[++*i];
+    char *end;
+    if (strcmp(opt, "--rate") == 0) {
+        double hz = strtod(val, &end);
+        if (*end || hz < 0) return -1;
+        b->rate_hz = hz;
+        return 1;
+    }
+    long n = strtol(val, &end, 10);
+    if (*end || n <= 0 || n > INT_MAX) return -1;   // the loggers count readings in int
+    if (strcmp(opt, "--bench") == 0) {
+        b->enabled = 1;
+        b->count = (unsigned long)n;
+    } else {
+        b->buffer = (int)n;
+    }
+    return 1;
+}
+
+int logger_bench_parse(LoggerBench *b, int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (logger_bench_arg(b, argc, argv, &i) != 1) {
+            fprintf(stderr, "Usage: %s %s\n", argv[0], logger_bench_usage());
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void logger_bench_start(LoggerBench *b) {
+    b->samples = 0;
+    b->lat_sum_ns = b->lat_max_ns = 0;
+    memset(b->hist, 0, sizeof(b->hist));
+    b->start_ns = b->sample_ns = now_ns();
+}
+
+void logger_bench_pace(LoggerBench *b) {
+    if (b->rate_hz > 0) {
+        uint64_t due = b->start_ns + (uint64_t)((double)b->samples * 1e9 / b->rate_hz);
+        struct timespec ts = { (time_t)(due / 1000000000ull), (long)(due % 1000000000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+    b->sample_ns = now_ns();
+}
+
+void logger_bench_done(LoggerBench *b) {
+    uint64_t lat = now_ns() - b->sample_ns;
+    b->hist[bucket_of(lat)]++;
+    b->lat_sum_ns += lat;
+    if (lat > b->lat_max_ns) b->lat_max_ns = lat;
+    b->samples++;
+}
+
+void logger_bench_stop(LoggerBench *b) {
+    b->end_ns = now_ns();
+}
+
+uint64_t logger_bench_percentile(const LoggerBench *b, double pct) {
+    uint64_t total = 0, seen = 0;
+    for (unsigned i = 0; i < LOGGER_BENCH_BUCKETS; i++) total += b->hist[i];
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)(pct / 100.0 * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+    for (unsigned i = 0; i < LOGGER_BENCH_BUCKETS; i++) {
+        seen += b->hist[i];
+        if (seen >= rank) {
+            uint64_t v = bucket_value(i);
+            return v < b->lat_max_ns ? v : b->lat_max_ns;
+        }
+    }
+    return b->lat_max_ns;
+}
+
+void logger_bench_stage(LoggerBench *b, const char *name, unsigned long dropped) {
+    if (b->stages == LOGGER_BENCH_MAX_STAGES) return;
+    b->stage_name[b->stages] = name;
+    b->stage_dropped[b->stages++] = dropped;
+}
+
+void logger_bench_report(const LoggerBench *b, const char *logger) {
+    struct rusage ru;
+    double elapsed = (double)(b->end_ns - b->start_ns) / 1e9;
+    getrusage(RUSAGE_SELF, &ru);     // ru_maxrss is in KiB on Linux
+
+    printf("{\"logger\":\"%s\",\"samples\":%lu,\"buffer\":%d,\"rate_hz\":%.1f,"
+           "\"elapsed_s\":%.6f,\"samples_per_s\":%.1f,"
+           "\"latency_ns\":{\"mean\":%.1f,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu},"
+           "\"bytes_written\":%llu,\"alarms\":%lu,\"dropped\":%lu,\"peak_rss_kb\":%ld",
+           logger, b->samples, b->buffer, b->rate_hz, elapsed,
+           elapsed > 0 ? (double)(b->samples - b->dropped) / elapsed : 0.0,
+           b->samples ? (double)b->lat_sum_ns / (double)b->samples : 0.0,
+           (unsigned long long)logger_bench_percentile(b, 50.0),
+           (unsigned long long)logger_bench_percentile(b, 90.0),
+           (unsigned long long)logger_bench_percentile(b, 99.0),
+           (unsigned long long)logger_bench_percentile(b, 99.9),
+           (unsigned long long)b->lat_max_ns, b->bytes_written, b->alarms, b->dropped,
+           (long)ru.ru_maxrss);
+    if (b->stages) {
+        printf(",\"dropped_by_stage\":{");
+        for (int i = 0; i < b->stages; i++)
+            printf("%s\"%s\":%lu", i ? "," : "", b->stage_name[i], b->stage_dropped[i]);
+        printf("}");
+    }
+    printf("}\n");
+    fflush(stdout);
+}
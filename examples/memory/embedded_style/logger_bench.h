@@ -0,0 +1,84 @@
+/*
+ * Headless Benchmark Mode for the Sensor Loggers
+ * Author: Evara
+ *
+ * Lets every logger be load-tested from the command line instead of the
+ * interactive scanf()/sleep(1) loop:
+ *   --bench N      simulate N readings without prompting and without
+ *                  per-sample terminal output
+ *   --buffer N     circular buffer size (default: the logger's fixed size,
+ *                  or LOGGER_BENCH_DEFAULT_BUFFER where it would prompt)
+ *   --rate HZ      target sampling rate; 0 (default) runs unthrottled
+ *
+ * The logger brackets each reading with logger_bench_pace() and
+ * logger_bench_done(). Pacing uses absolute deadlines, so a slow sample is
+ * caught up rather than shifting every later one. Per-sample latency (pace
+ * to done) goes into a log-linear histogram (1/16 octave, ~6 % error) so
+ * percentiles cost O(1) memory at any sample count.
+ *
+ * logger_bench_report() prints one JSON object on one line to stdout:
+ *   {"logger":..., "samples":..., "buffer":..., "rate_hz":...,
+ *    "elapsed_s":..., "samples_per_s":...,
+ *    "latency_ns":{"mean","p50","p90","p99","p999","max"},
+ *    "bytes_written":..., "alarms":..., "dropped":..., "peak_rss_kb":...
+ *    [, "dropped_by_stage":{"<stage>":..., ...}]}
+ * samples_per_s counts the readings that were not dropped (from the data
+ * log), over the whole run including the final log flush. A pipelined
+ * logger lists what every stage lost with logger_bench_stage(), so alarms
+ * missed by a lossy alarm stage show up too.
+ */
+#ifndef LOGGER_BENCH_H
+#define LOGGER_BENCH_H
+
+#include <stdint.h>
+
+#define LOGGER_BENCH_DEFAULT_BUFFER  100   // --buffer for loggers that prompt for one
+#define LOGGER_BENCH_SUB             16    // histogram buckets per octave
+#define LOGGER_BENCH_BUCKETS         (2 * LOGGER_BENCH_SUB + 59 * LOGGER_BENCH_SUB)
+#define LOGGER_BENCH_MAX_STAGES      8
+
+typedef struct {
+    int enabled;                  // --bench given
+    unsigned long count;          // readings to simulate
+    int buffer;                   // --buffer, 0 = logger default
+    double rate_hz;               // 0 = unthrottled
+
+    // Run state
+    uint64_t start_ns;
+    uint64_t sample_ns;           // when the current reading started
+    uint64_t end_ns;
+    unsigned long samples;        // readings completed
+
+    // Latency histogram
+    uint64_t hist[LOGGER_BENCH_BUCKETS];
+    uint64_t lat_sum_ns;
+    uint64_t lat_max_ns;
+
+    // Filled in by the logger before the report
+    unsigned long long bytes_written;
+    unsigned long alarms;
+    unsigned long dropped;        // readings lost (pipelined logger only)
+    const char *stage_name[LOGGER_BENCH_MAX_STAGES];
+    unsigned long stage_dropped[LOGGER_BENCH_MAX_STAGES];
+    int stages;
+} LoggerBench;
+
+// Consumes argv[*i] (and its value) if it is a bench option: returns 1 and
+// advances *i, 0 if it is not one, -1 on a bad value (counts and buffer
+// sizes must fit an int: the loggers loop over readings with one).
+int  logger_bench_arg(LoggerBench *b, int argc, char *argv[], int *i);
+// For loggers without options of their own: 0 on success, -1 after usage
+int  logger_bench_parse(LoggerBench *b, int argc, char *argv[]);
+const char *logger_bench_usage(void);    // "[--bench N [--buffer N] [--rate HZ]]"
+
+void logger_bench_start(LoggerBench *b);
+void logger_bench_pace(LoggerBench *b);  // wait for the next reading's slot
+void logger_bench_done(LoggerBench *b);  // reading handled
+void logger_bench_stop(LoggerBench *b);  // end of the measured run
+void logger_bench_stage(LoggerBench *b, const char *name, unsigned long dropped);  // per-stage loss
+
+// Value below which `pct` percent of the latencies fall
+uint64_t logger_bench_percentile(const LoggerBench *b, double pct);
+void logger_bench_report(const LoggerBench *b, const char *logger);
+
+#endif
@@ -0,0 +1,322 @@
+#include "packed_history.h"
+#include <string.h>
+
+#define PACK_SCALES  4
+static const float pack_scale[PACK_SCALES] = { 1.0f, 10.0f, 100.0f, 1000.0f };
+
+// Worst-case column sizes: timestamps as frame-of-reference at width 64,
+// channels as Gorilla XOR (quantized channels never need more)
+#define PACK_TS_MAX_BYTES   ((78u + 64u * PACKED_HISTORY_BLOCK + 7u) / 8u)
+#define PACK_XOR_MAX_BYTES  GORILLA_F32_MAX_BYTES(PACKED_HISTORY_BLOCK)
+
+typedef struct {
+    uint8_t codec;                 // PACK_* | scale index << 4
+    uint8_t width;
+    size_t  bytes;                 // exact size, or the XOR worst case
+} ColumnPlan;
+
+static unsigned bit_width(uint64_t v) {
+    return v ? 64u - (unsigned)__builtin_clzll(v) : 0u;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1u);
+}
+
+// Signed field: 7-bit length, then the zigzag value in that many bits
+static void put_signed(GorillaBitWriter *bw, int64_t v) {
+    uint64_t zz = zigzag(v);
+    unsigned n = bit_width(zz);
+    gorilla_put_bits(bw, n, 7);
+    gorilla_put_bits(bw, zz, n);
+}
+
+static int64_t get_signed(GorillaBitReader *br) {
+    unsigned n = (unsigned)gorilla_get_bits(br, 7);
+    return unzigzag(gorilla_get_bits(br, n));
+}
+
+static size_t signed_bits(int64_t v) {
+    return 7u + bit_width(zigzag(v));
+}
+
+static float channel_value(const SensorData *d, int c) {
+    return c == 0 ? d->temperature : c == 1 ? d->pressure : d->flow;
+}
+
+// v as an integer count of 1/scale steps that converts back to exactly v
+static int quantize(float v, float scale, int64_t *q) {
+    double x = (double)v * scale;
+    if (!(x > -16777216.0 && x < 16777216.0)) return 0;   // also rejects NaN
+    int64_t r = (int64_t)(x < 0 ? x - 0.5 : x + 0.5);
+    float back = (float)r / scale;
+    uint32_t a, b;
+    memcpy(&a, &back, sizeof(a));
+    memcpy(&b, &v, sizeof(b));
+    if (a != b) return 0;                                   // also rejects -0
+    *q = r;
+    return 1;
+}
+
+// Fill h->column with column c as integers; 0 if a channel is not exact at this scale
+static int load_column(PackedHistory *h, int c, int scale) {
+    uint32_t n = h->open_count;
+    if (c == 0) {
+        for (uint32_t i = 0; i < n; i++) h->column[i] = (int64_t)h->open[i].timestamp;
+        return 1;
+    }
+    for (uint32_t i = 0; i < n; i++)
+        if (!quantize(channel_value(&h->open[i], c - 1), pack_scale[scale], &h->column[i])) return 0;
+    return 1;
+}
+
+// Frame-of-reference or delta packing of h->column, whichever is smaller.
+// All arithmetic is modulo 2^64, so any timestamp sequence round-trips.
+static void plan_int(const PackedHistory *h, int scale, ColumnPlan *p) {
+    const int64_t *v = h->column;
+    uint32_t n = h->open_count;
+    int64_t lo = v[0], hi = v[0], dlo = 0, dhi = 0;
+    for (uint32_t i = 1; i < n; i++) {
+        int64_t d = (int64_t)((uint64_t)v[i] - (uint64_t)v[i - 1]);
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+        if (i == 1 || d < dlo) dlo = d;
+        if (i == 1 || d > dhi) dhi = d;
+    }
+    unsigned fw = bit_width((uint64_t)hi - (uint64_t)lo);
+    unsigned dw = bit_width((uint64_t)dhi - (uint64_t)dlo);
+    size_t for_bits = signed_bits(lo) + 7u + (size_t)n * fw;
+    size_t delta_bits = signed_bits(v[0]) + signed_bits(dlo) + 7u + (size_t)(n - 1) * dw;
+
+    int delta = delta_bits < for_bits;
+    p->codec = (uint8_t)((delta ? PACK_DELTA : PACK_FOR) | scale << 4);
+    p->width = (uint8_t)(delta ? dw : fw);
+    p->bytes = ((delta ? delta_bits : for_bits) + 7u) / 8u;
+}
+
+static void plan_column(PackedHistory *h, int c, ColumnPlan *p) {
+    for (int s = 0; s < (c == 0 ? 1 : PACK_SCALES); s++) {
+        if (load_column(h, c, s)) {
+            plan_int(h, s, p);
+            return;
+        }
+    }
+    p->codec = PACK_XOR;
+    p->width = 0;
+    p->bytes = PACK_XOR_MAX_BYTES;
+}
+
+static void encode_column(PackedHistory *h, int c, const ColumnPlan *p, GorillaBitWriter *bw) {
+    uint32_t n = h->open_count;
+    if ((p->codec & 15) == PACK_XOR) {
+        GorillaF32State st = { 0, 0, 0, 0 };
+        for (uint32_t i = 0; i < n; i++) gorilla_encode_f32(&st, bw, channel_value(&h->open[i], c - 1));
+        h->xor_columns++;
+        return;
+    }
+    load_column(h, c, p->codec >> 4);
+    const int64_t *v = h->column;
+    if ((p->codec & 15) == PACK_FOR) {
+        int64_t lo = v[0];
+        for (uint32_t i = 1; i < n; i++)
+            if (v[i] < lo) lo = v[i];
+        put_signed(bw, lo);
+        gorilla_put_bits(bw, p->width, 7);
+        for (uint32_t i = 0; i < n; i++) gorilla_put_bits(bw, (uint64_t)v[i] - (uint64_t)lo, p->width);
+    } else {
+        int64_t dlo = 0;
+        for (uint32_t i = 1; i < n; i++) {
+            int64_t d = (int64_t)((uint64_t)v[i] - (uint64_t)v[i - 1]);
+            if (i == 1 || d < dlo) dlo = d;
+        }
+        put_signed(bw, v[0]);
+        put_signed(bw, dlo);
+        gorilla_put_bits(bw, p->width, 7);
+        for (uint32_t i = 1; i < n; i++)
+            gorilla_put_bits(bw, (uint64_t)v[i] - (uint64_t)v[i - 1] - (uint64_t)dlo, p->width);
+    }
+}
+
+static void evict_oldest(PackedHistory *h) {
+    PackedBlockHeader hdr;
+    memcpy(&hdr, h->arena + h->tail, sizeof(hdr));
+    h->tail += hdr.bytes;
+    if (h->tail == h->wrap_end) {
+        h->tail = 0;
+        h->wrap_end = 0;
+    }
+    h->blocks--;
+    h->used -= hdr.bytes;
+    h->held -= hdr.count;
+    h->evicted += hdr.count;
+}
+
+// Contiguous room for need bytes, dropping the oldest blocks as required.
+// Live data is [tail, head), or [tail, wrap_end) + [0, head) once wrapped.
+static size_t reserve(PackedHistory *h, size_t need) {
+    for (;;) {
+        if (h->blocks == 0) {
+            h->tail = h->head = h->wrap_end = 0;
+            return 0;
+        }
+        if (h->head > h->tail) {
+            if (h->arena_bytes - h->head >= need) return h->head;
+            if (h->tail >= need) {
+                h->wrap_end = h->head;
+                h->head = 0;
+                return 0;
+            }
+        } else if (h->tail - h->head >= need) {
+            return h->head;
+        }
+        evict_oldest(h);
+    }
+}
+
+static void pack_open(PackedHistory *h) {
+    PackedBlockHeader hdr;
+    ColumnPlan plan[PACKED_HISTORY_COLUMNS];
+    size_t need = sizeof(hdr);
+    memset(&hdr, 0, sizeof(hdr));
+    for (int c = 0; c < PACKED_HISTORY_COLUMNS; c++) {
+        plan_column(h, c, &plan[c]);
+        need += plan[c].bytes;
+    }
+
+    size_t off = reserve(h, need);
+    uint8_t *block = h->arena + off, *p = block + sizeof(hdr);
+    for (int c = 0; c < PACKED_HISTORY_COLUMNS; c++) {
+        GorillaBitWriter bw;
+        gorilla_writer_init(&bw, p, plan[c].bytes);
+        encode_column(h, c, &plan[c], &bw);
+        hdr.codec[c] = plan[c].codec;
+        hdr.column_bytes[c] = (uint16_t)gorilla_writer_bytes(&bw);
+        p += hdr.column_bytes[c];
+    }
+    hdr.count = (uint16_t)h->open_count;
+    hdr.bytes = (uint16_t)(p - block);
+    memcpy(block, &hdr, sizeof(hdr));
+
+    h->head = off + hdr.bytes;
+    h->blocks++;
+    h->used += hdr.bytes;
+    h->held += hdr.count;
+    h->open_count = 0;
+}
+
+size_t packed_history_min_arena(void) {
+    return sizeof(PackedBlockHeader) + PACK_TS_MAX_BYTES + (PACKED_HISTORY_COLUMNS - 1) * PACK_XOR_MAX_BYTES;
+}
+
+int packed_history_init(PackedHistory *h, uint8_t *arena, size_t arena_bytes) {
+    memset(h, 0, sizeof(*h));
+    if (!arena || arena_bytes < packed_history_min_arena()) return -1;
+    h->arena = arena;
+    h->arena_bytes = arena_bytes;
+    return 0;
+}
+
+void packed_history_push(PackedHistory *h, const SensorData *d) {
+    h->open[h->open_count++] = *d;
+    h->pushed++;
+    if (h->open_count == PACKED_HISTORY_BLOCK) pack_open(h);
+}
+
+size_t packed_history_count(const PackedHistory *h) {
+    return (size_t)h->held + h->open_count;
+}
+
+size_t packed_history_bytes(const PackedHistory *h) {
+    return h->used;
+}
+
+// ---- Iterator ----
+
+static void column_open(PackedColumnReader *r, uint8_t codec, const uint8_t *data, size_t len) {
+    memset(r, 0, sizeof(*r));
+    gorilla_reader_init(&r->br, data, len);
+    r->codec = codec;
+    r->scale = pack_scale[(codec >> 4) % PACK_SCALES];
+    switch (codec & 15) {
+    case PACK_FOR:
+        r->base = get_signed(&r->br);
+        r->width = (uint8_t)gorilla_get_bits(&r->br, 7);
+        break;
+    case PACK_DELTA:
+        r->prev = get_signed(&r->br);
+        r->base = get_signed(&r->br);
+        r->width = (uint8_t)gorilla_get_bits(&r->br, 7);
+        r->first = 1;
+        break;
+    default:
+        break;
+    }
+}
+
+static int64_t column_int(PackedColumnReader *r) {
+    if ((r->codec & 15) == PACK_FOR)
+        return (int64_t)((uint64_t)r->base + gorilla_get_bits(&r->br, r->width));
+    if (r->first) {
+        r->first = 0;
+        return r->prev;
+    }
+    r->prev = (int64_t)((uint64_t)r->prev + (uint64_t)r->base + gorilla_get_bits(&r->br, r->width));
+    return r->prev;
+}
+
+static float column_float(PackedColumnReader *r) {
+    if ((r->codec & 15) == PACK_XOR) return gorilla_decode_f32(&r->xor_state, &r->br);
+    return (float)column_int(r) / r->scale;
+}
+
+static void open_block(PackedHistoryIter *it) {
+    const PackedHistory *h = it->h;
+    const uint8_t *block = h->arena + it->next_off;
+    PackedBlockHeader hdr;
+    memcpy(&hdr, block, sizeof(hdr));
+
+    const uint8_t *p = block + sizeof(hdr);
+    for (int c = 0; c < PACKED_HISTORY_COLUMNS; c++) {
+        column_open(&it->col[c], hdr.codec[c], p, hdr.column_bytes[c]);
+        p += hdr.column_bytes[c];
+    }
+    it->pos = 0;
+    it->count = hdr.count;
+    it->next_off += hdr.bytes;
+    if (it->next_off == h->wrap_end) it->next_off = 0;
+    it->block++;
+}
+
+void packed_history_iter_begin(const PackedHistory *h, PackedHistoryIter *it) {
+    memset(it, 0, sizeof(*it));
+    it->h = h;
+    it->next_off = h->tail;
+}
+
+int packed_history_next(PackedHistoryIter *it, SensorData *out) {
+    const PackedHistory *h = it->h;
+    if (it->pos == it->count) {
+        if (it->block < h->blocks) {
+            open_block(it);
+        } else if (it->block == h->blocks) {   // then the open block, as is
+            it->block++;
+            it->pos = 0;
+            it->count = h->open_count;
+        }
+        if (it->pos == it->count) return 0;
+    }
+    if (it->block > h->blocks) {
+        *out = h->open[it->pos++];
+        return 1;
+    }
+    out->timestamp = (uint64_t)column_int(&it->col[0]);
+    out->temperature = column_float(&it->col[1]);
+    out->pressure = column_float(&it->col[2]);
+    out->flow = column_float(&it->col[3]);
+    it->pos++;
+    return 1;
+}
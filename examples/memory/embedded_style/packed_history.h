@@ -0,0 +1,103 @@
+/*
+ * Block-Compressed Sample History
+ * Author: Evara
+ *
+ * Keeps several times more readings in a fixed RAM budget than an array of
+ * SensorData. Samples are appended to an uncompressed open block; when it
+ * holds PACKED_HISTORY_BLOCK samples it is packed column by column into a
+ * caller-provided byte arena and the open block starts over:
+ *  - timestamps: delta + frame-of-reference bit-packing, 0 bits per sample
+ *    at a steady rate, a few bits with jitter
+ *  - channels: values that are exact decimals (the logger's 0.1 / 0.01
+ *    readings) become scaled integers, stored either frame-of-reference or
+ *    as deltas, whichever is smaller, at a fixed width per block
+ *  - anything else (NaN, -0, full precision floats) falls back to the
+ *    Gorilla XOR codec (firmware/inc/gorilla.h); decoding is always
+ *    bit-exact
+ *
+ * The arena is a ring of variable-size blocks: when a packed block does
+ * not fit, the oldest blocks are dropped, so the history always holds the
+ * newest readings that fit in the budget. No allocation after init, so the
+ * same module runs on the MCU.
+ *
+ * Reading goes through an iterator that decodes on the fly, one sample at
+ * a time from per-column bit readers: no decode buffer, and the cost per
+ * sample is bounded by the fixed widths of its block.
+ *
+ * Single owner: push and iterate from the same thread; a push invalidates
+ * live iterators.
+ */
+#ifndef PACKED_HISTORY_H
+#define PACKED_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gorilla.h"
+#include "sensor_data.h"
+
+#define PACKED_HISTORY_BLOCK    128     // samples per packed block
+#define PACKED_HISTORY_COLUMNS  4       // timestamp, temperature, pressure, flow
+
+// Column codecs (low nibble of PackedBlockHeader.codec; high nibble = decimal scale)
+enum { PACK_FOR = 0, PACK_DELTA = 1, PACK_XOR = 2 };
+
+typedef struct {
+    uint16_t bytes;                             // header + column data
+    uint16_t count;                             // samples in the block
+    uint8_t  codec[PACKED_HISTORY_COLUMNS];
+    uint16_t column_bytes[PACKED_HISTORY_COLUMNS];
+} PackedBlockHeader;
+
+typedef struct {
+    uint8_t *arena;
+    size_t   arena_bytes;
+    size_t   tail;                  // offset of the oldest block
+    size_t   head;                  // offset where the next block goes
+    size_t   wrap_end;              // end of the data before a wrap to 0 (0 = none)
+    size_t   blocks;                // packed blocks held
+    size_t   used;                  // arena bytes held by them
+
+    SensorData open[PACKED_HISTORY_BLOCK];
+    uint32_t open_count;
+
+    // Statistics
+    unsigned long long held;        // samples in packed blocks
+    unsigned long long pushed;
+    unsigned long long evicted;     // samples dropped with their block
+    unsigned long xor_columns;      // channel columns that needed the XOR fallback
+
+    int64_t column[PACKED_HISTORY_BLOCK];   // packing scratch
+} PackedHistory;
+
+typedef struct {
+    GorillaBitReader br;
+    uint8_t codec;
+    uint8_t width;
+    int     first;                  // PACK_DELTA: next value is the stored first one
+    int64_t base;                   // PACK_FOR: block minimum; PACK_DELTA: minimum delta
+    int64_t prev;                   // PACK_DELTA: last value
+    float   scale;
+    GorillaF32State xor_state;
+} PackedColumnReader;
+
+typedef struct {
+    const PackedHistory *h;
+    size_t block;                   // packed blocks started so far
+    size_t next_off;                // offset of the next packed block
+    uint32_t pos, count;            // sample within the current block
+    PackedColumnReader col[PACKED_HISTORY_COLUMNS];
+} PackedHistoryIter;
+
+// Worst-case size of one packed block; the arena must hold at least one.
+size_t packed_history_min_arena(void);
+// Returns 0 on success, -1 if arena_bytes < packed_history_min_arena()
+int    packed_history_init(PackedHistory *h, uint8_t *arena, size_t arena_bytes);
+void   packed_history_push(PackedHistory *h, const SensorData *d);
+size_t packed_history_count(const PackedHistory *h);       // samples retained
+size_t packed_history_bytes(const PackedHistory *h);       // arena bytes held by packed blocks
+
+// Oldest to newest: packed blocks first, then the open block
+void packed_history_iter_begin(const PackedHistory *h, PackedHistoryIter *it);
+int  packed_history_next(PackedHistoryIter *it, SensorData *out);  // 1 = sample, 0 = end
+
+#endif
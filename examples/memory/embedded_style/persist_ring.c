@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "persist_ring.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RECORD_CRC_BYTES offsetof(PersistRecord, crc)
+#define HEADER_CRC_BYTES offsetof(PersistRingHeader, crc)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void persist_ring_default_config(PersistRingConfig *cfg) {
+    cfg->capacity = 65536;
+    cfg->checkpoint_every = 256;
+    cfg->sync = PERSIST_SYNC_ASYNC;
+}
+
+static int header_valid(const PersistRingHeader *h, off_t file_bytes) {
+    return h->magic == PERSIST_RING_MAGIC && h->version == PERSIST_RING_VERSION &&
+           h->record_size == sizeof(PersistRecord) && h->capacity > 0 &&
+           (off_t)(PERSIST_RING_DATA_OFF + h->capacity * sizeof(PersistRecord)) == file_bytes &&
+           h->tail <= h->head && h->head - h->tail <= h->capacity &&
+           crc32_update(0, h, HEADER_CRC_BYTES) == h->crc;
+}
+
+// Valid copy with the highest generation: 0 if there is one. *magic is
+// set when either copy at least starts with the ring's magic number.
+static int read_header(int fd, off_t file_bytes, PersistRingHeader *out, int *magic) {
+    PersistRingHeader h[2];
+    int found = 0;
+    *magic = 0;
+    for (int k = 0; k < 2; k++) {
+        off_t off = k ? PERSIST_RING_HDR_B : 0;
+        if (pread(fd, &h[k], sizeof(h[k]), off) != (ssize_t)sizeof(h[k])) continue;
+        if (h[k].magic == PERSIST_RING_MAGIC) *magic = 1;
+        if (file_bytes < PERSIST_RING_DATA_OFF || !header_valid(&h[k], file_bytes)) continue;
+        if (!found || h[k].generation > out->generation) *out = h[k];
+        found = 1;
+    }
+    return found ? 0 : -1;
+}
+
+static int record_ok(const PersistRecord *p, uint64_t seq) {
+    return p->seq == seq && crc32_update(0, p, RECORD_CRC_BYTES) == p->crc;
+}
+
+// Both header copies damaged: the records validate themselves, so the
+// newest intact one is the head and the run of intact predecessors the tail
+static void rebuild_from_records(PersistRing *r) {
+    uint64_t newest = 0;
+    for (uint64_t slot = 0; slot < r->capacity; slot++) {
+        const PersistRecord *p = &r->rec[slot];
+        if (p->seq > newest && p->seq % r->capacity == slot && record_ok(p, p->seq))
+            newest = p->seq;
+    }
+    r->head = r->tail = newest + 1;
+    if (newest == 0) {                    // nothing intact: an empty ring
+        r->head = r->tail = 1;
+        return;
+    }
+    while (r->tail > 1 && r->head - (r->tail - 1) <= r->capacity &&
+           record_ok(&r->rec[(r->tail - 1) % r->capacity], r->tail - 1))
+        r->tail--;
+}
+
+int persist_ring_open(PersistRing *r, const char *path, const PersistRingConfig *cfg) {
+    uint64_t t0 = now_ns();
+    struct stat st;
+    PersistRingHeader hdr;
+
+    memset(r, 0, sizeof(*r));
+    memset(&hdr, 0, sizeof(hdr));
+    r->cfg = *cfg;
+    if (r->cfg.capacity == 0) r->cfg.capacity = 1;
+    if (r->cfg.checkpoint_every == 0) r->cfg.checkpoint_every = 1;
+
+    r->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (r->fd < 0) return -1;
+    if (fstat(r->fd, &st) != 0) goto fail;
+
+    int magic;
+    r->recovered = read_header(r->fd, st.st_size, &hdr, &magic) == 0;
+    if (r->recovered) {
+        r->capacity = hdr.capacity;
+    } else if (st.st_size == 0) {
+        r->capacity = r->cfg.capacity;
+    } else if (magic && st.st_size > PERSIST_RING_DATA_OFF &&
+               (st.st_size - PERSIST_RING_DATA_OFF) % (off_t)sizeof(PersistRecord) == 0) {
+        // our file, both headers damaged: keep it and scan the records
+        r->rebuilt = 1;
+        r->capacity = (uint64_t)(st.st_size - PERSIST_RING_DATA_OFF) / sizeof(PersistRecord);
+    } else {
+        goto fail;                        // not a ring: never overwrite someone's file
+    }
+    r->map_bytes = PERSIST_RING_DATA_OFF + (size_t)r->capacity * sizeof(PersistRecord);
+    if (!r->recovered && !r->rebuilt) {
+        // new file, all zeros: no slot can pass as a record
+        if (posix_fallocate(r->fd, 0, (off_t)r->map_bytes) != 0 &&
+            ftruncate(r->fd, (off_t)r->map_bytes) != 0)
+            goto fail;
+    }
+
+    void *map = mmap(NULL, r->map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+    if (map == MAP_FAILED) goto fail;
+    r->map = (uint8_t *)map;
+    r->rec = (PersistRecord *)(r->map + PERSIST_RING_DATA_OFF);
+
+    if (r->recovered) {
+        // Roll forward over the records written after the last checkpoint
+        r->generation = hdr.generation;
+        r->head = hdr.head;
+        while (r->head - hdr.head < r->capacity) {
+            const PersistRecord *p = &r->rec[r->head % r->capacity];
+            if (!record_ok(p, r->head)) {
+                r->torn = p->seq == r->head;
+                break;
+            }
+            r->head++;
+        }
+        r->rolled_forward = r->head - hdr.head;
+        r->tail = r->head - hdr.tail > r->capacity ? r->head - r->capacity : hdr.tail;
+    } else if (r->rebuilt) {
+        rebuild_from_records(r);
+        r->recovered = 1;
+        persist_ring_checkpoint(r);      // both header copies
+    } else {
+        // seq 0 is never used, so an all-zero slot never looks valid
+        r->head = r->tail = 1;
+        persist_ring_checkpoint(r);      // both header copies
+    }
+    persist_ring_checkpoint(r);
+    r->recover_ns = now_ns() - t0;
+    return 0;
+
+fail:
+    close(r->fd);
+    r->fd = -1;
+    return -1;
+}
+
+void persist_ring_push(PersistRing *r, const SensorData *d) {
+    PersistRecord v;
+    v.seq = r->head;
+    v.timestamp = d->timestamp;
+    v.temperature = d->temperature;
+    v.pressure = d->pressure;
+    v.flow = d->flow;
+    v.crc = crc32_update(0, &v, RECORD_CRC_BYTES);
+    r->rec[r->head % r->capacity] = v;
+
+    r->head++;
+    if (r->head - r->tail > r->capacity) r->tail = r->head - r->capacity;
+    r->pushed++;
+    if (++r->since_checkpoint >= r->cfg.checkpoint_every) persist_ring_checkpoint(r);
+}
+
+void persist_ring_checkpoint(PersistRing *r) {
+    PersistRingHeader h;
+    memset(&h, 0, sizeof(h));
+    if (r->cfg.sync == PERSIST_SYNC_FULL)   // records reach the disk before the header names them
+        msync(r->map, r->map_bytes, MS_SYNC);
+
+    h.magic = PERSIST_RING_MAGIC;
+    h.version = PERSIST_RING_VERSION;
+    h.record_size = (uint16_t)sizeof(PersistRecord);
+    h.capacity = r->capacity;
+    h.generation = ++r->generation;
+    h.head = r->head;
+    h.tail = r->tail;
+    h.crc = crc32_update(0, &h, HEADER_CRC_BYTES);
+    // alternate copies: a torn header write leaves the previous one intact
+    memcpy(r->map + ((h.generation & 1) ? PERSIST_RING_HDR_B : 0), &h, sizeof(h));
+
+    if (r->cfg.sync != PERSIST_SYNC_NONE)
+        msync(r->map, r->cfg.sync == PERSIST_SYNC_FULL ? PERSIST_RING_DATA_OFF : r->map_bytes,
+              r->cfg.sync == PERSIST_SYNC_FULL ? MS_SYNC : MS_ASYNC);
+    r->since_checkpoint = 0;
+    r->checkpoints++;
+}
+
+void persist_ring_close(PersistRing *r) {
+    if (!r->map) return;
+    persist_ring_checkpoint(r);
+    if (r->cfg.sync != PERSIST_SYNC_NONE) msync(r->map, r->map_bytes, MS_SYNC);
+    munmap(r->map, r->map_bytes);
+    close(r->fd);
+    r->map = NULL;
+    r->rec = NULL;
+    r->fd = -1;
+}
+
+size_t persist_ring_count(const PersistRing *r) {
+    return (size_t)(r->head - r->tail);
+}
+
+int persist_ring_get(PersistRing *r, size_t i, SensorData *out) {
+    uint64_t seq = r->tail + i;
+    const PersistRecord *p = &r->rec[seq % r->capacity];
+    if (seq >= r->head || !record_ok(p, seq)) {
+        r->bad_reads++;
+        return -1;
+    }
+    out->temperature = p->temperature;
+    out->pressure = p->pressure;
+    out->flow = p->flow;
+    out->timestamp = p->timestamp;
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Crash-Safe Persistent Ring
+ * Author: Evara
+ *
+ * The newest `capacity` readings kept in an mmap'd file, so a logger that
+ * dies (crash, kill -9, power loss) gets its buffer back on restart instead
+ * of losing it or re-parsing data_log.csv.
+ *
+ * File layout:
+ *   0      header copy A     PersistRingHeader, own CRC
+ *   512    header copy B     (separate sector)
+ *   4096   capacity x 32-byte records, record `seq` in slot seq % capacity
+ *
+ * Each record carries its sequence number and a CRC-32 (crc32.h) over
+ * itself, so it is self-validating: a torn or half-written record fails
+ * the CRC, and a slot still holding the previous lap has the wrong seq.
+ * Records are written straight into the mapping; nothing else is touched
+ * per record. Every `checkpoint_every` records the head and tail go into
+ * the older header copy with a new generation number, so a torn header
+ * write always leaves the other copy intact.
+ *
+ * Recovery takes the valid header with the highest generation and rolls
+ * forward from its head while the next slot holds the next seq with a good
+ * CRC: at most checkpoint_every records are read, whatever the capacity.
+ * Older records are not re-verified at open; persist_ring_get() checks
+ * each one as it is read and reports the ones that fail. If both header
+ * copies are damaged the head and tail are rebuilt by scanning every
+ * record for the newest intact seq (O(capacity), once).
+ *
+ * Only a missing or empty file is initialised. A non-empty file that is
+ * not a ring (no magic number, or a size that does not fit the layout) is
+ * left untouched and persist_ring_open() fails.
+ *
+ * Durability: a process crash loses nothing written (the page cache keeps
+ * the mapping). Against power loss, `sync` msyncs at every checkpoint;
+ * records after the last synced checkpoint may be lost, never corrupted.
+ *
+ * Single writer; readers must not run concurrently with push.
+ */
+#ifndef PERSIST_RING_H
+#define PERSIST_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_data.h"
+
+#define PERSIST_RING_MAGIC     0x474e5250u   // "PRNG"
+#define PERSIST_RING_VERSION   1
+#define PERSIST_RING_DATA_OFF  4096          // records start here
+#define PERSIST_RING_HDR_B     512           // offset of header copy B
+
+typedef struct {
+    uint64_t seq;
+    uint64_t timestamp;
+    float    temperature, pressure, flow;
+    uint32_t crc;                 // CRC-32 of the 28 bytes before it
+} PersistRecord;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint64_t capacity;            // records
+    uint64_t generation;          // checkpoint number, picks the newer copy
+    uint64_t head;                // next seq to write at the checkpoint
+    uint64_t tail;                // oldest seq kept
+    uint32_t crc;                 // CRC-32 of the fields above
+    uint32_t pad;
+} PersistRingHeader;
+
+typedef enum {
+    PERSIST_SYNC_NONE = 0,        // survive process crashes only
+    PERSIST_SYNC_ASYNC,           // msync(MS_ASYNC) at each checkpoint
+    PERSIST_SYNC_FULL             // msync(MS_SYNC) at each checkpoint
+} PersistSync;
+
+typedef struct {
+    size_t capacity;              // records (new files; an existing file keeps its own)
+    unsigned checkpoint_every;    // records between header updates (default 256)
+    PersistSync sync;             // default PERSIST_SYNC_ASYNC
+} PersistRingConfig;
+
+typedef struct {
+    PersistRingConfig cfg;
+    int fd;
+    uint8_t *map;
+    size_t map_bytes;
+    PersistRecord *rec;
+    uint64_t capacity;
+    uint64_t head, tail;          // seq range [tail, head) held
+    uint64_t generation;
+    unsigned since_checkpoint;
+
+    // What open found
+    int recovered;                // 1: existing ring reopened, 0: new file
+    uint64_t rolled_forward;      // records found past the checkpoint
+    int torn;                     // the slot after the head had this seq but a bad CRC
+    int rebuilt;                  // both headers were bad: rebuilt from a record scan
+    uint64_t recover_ns;          // open + recovery time
+
+    // Statistics
+    unsigned long long pushed;
+    unsigned long checkpoints;
+    unsigned long bad_reads;      // persist_ring_get() records that failed the check
+} PersistRing;
+
+void persist_ring_default_config(PersistRingConfig *cfg);
+
+// Open or create `path`. An existing ring is recovered (see above); a
+// missing or empty file becomes an empty ring. -1 for any other file.
+int  persist_ring_open(PersistRing *r, const char *path, const PersistRingConfig *cfg);
+void persist_ring_push(PersistRing *r, const SensorData *d);
+void persist_ring_checkpoint(PersistRing *r);
+void persist_ring_close(PersistRing *r);   // final checkpoint, unmap
+
+size_t persist_ring_count(const PersistRing *r);
+// i-th oldest record held: 0 if it is intact, -1 if torn or stale
+int  persist_ring_get(PersistRing *r, size_t i, SensorData *out);
+
+#endif
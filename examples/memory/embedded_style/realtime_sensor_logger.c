@@ -2,37 +2,40 @@
 >Author: Evara
 >Title: Real-Time Sensor Data Logger with Embedded-Style Memory Management in C
 >Description: This program simulates real-time sensor data logging with embedded-style memory management in C.
+>Load test: --bench N [--buffer N] [--rate HZ] runs N readings silently and prints a JSON summary (logger_bench.h).
 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>  // for sleep()
 
+#include "spsc_ring.h"
+#include "timebase.h"
+#include "logger_bench.h"
+#include "sensor_data.h"
+#include "sensor_sim.h"
+
 #define MEMORY_WARNING_THRESHOLD 0.8  // 80%
 #define BUFFER_CAPACITY 10
 
 typedef struct {
-    float temperature;
-    float pressure;
-    float flow;
-} SensorData;
-
-typedef struct {
-    SensorData *buffer;
+    SpscRing ring;       // lock-free ring (firmware/inc/spsc_ring.h)
+    SensorData *buffer;  // power-of-two slots
     int capacity;
-    int head;
-    int count;
 } CircularBuffer;
 
+static int quiet = 0;                 // --bench: no per-reading output
+static unsigned long alarms_raised = 0;
+
 void initBuffer(CircularBuffer *cb, int capacity) {
-    cb->buffer = malloc(sizeof(SensorData) * capacity);
+    size_t slots = spsc_round_capacity((size_t)capacity);
+    cb->buffer = malloc(sizeof(SensorData) * slots);
     if (!cb->buffer) {
         printf("[ERROR] Memory allocation failed.\n");
         exit(1);
     }
+    spsc_init(&cb->ring, cb->buffer, slots, sizeof(SensorData));
     cb->capacity = capacity;
-    cb->head = 0;
-    cb->count = 0;
 }
 
 void freeBuffer(CircularBuffer *cb) {
@@ -40,33 +43,37 @@ void freeBuffer(CircularBuffer *cb) {
     cb->buffer = NULL;
 }
 
+static SensorSim sim;                 // simulated plant (sensor_sim.h), 1 Hz
+
 SensorData simulateSensor() {
-    SensorData d;
-    d.temperature = 60.0 + (rand() % 50);
-    d.pressure = 5.0 + (rand() % 10);
-    d.flow = 20.0 + (rand() % 30);
+    SensorData d = sensor_sim_next(&sim);
+    d.timestamp = timebase_wall_ns();
     return d;
 }
 
 void addReading(CircularBuffer *cb, SensorData d) {
-    if (cb->count < cb->capacity) {
-        cb->buffer[(cb->head + cb->count) % cb->capacity] = d;
-        cb->count++;
-    } else {
-        cb->buffer[cb->head] = d;
-        cb->head = (cb->head + 1) % cb->capacity;
+    if (spsc_count(&cb->ring) >= (size_t)cb->capacity)
+        spsc_consume(&cb->ring, 1);  // overwrite oldest
+    spsc_push(&cb->ring, &d);
+
+    if (!quiet) {
+        float usage = (float)spsc_count(&cb->ring) / cb->capacity;
+        if (usage >= MEMORY_WARNING_THRESHOLD)
+            printf("[ALERT] Memory usage high: %.0f%%\n", usage * 100);
     }
 
-    float usage = (float)cb->count / cb->capacity;
-    if (usage >= MEMORY_WARNING_THRESHOLD)
-        printf("[ALERT] Memory usage high: %.0f%%\n", usage * 100);
-
-    if (d.temperature > 80.0)
-        printf("[TEMP ALARM] %.2f°C exceeds limit!\n", d.temperature);
-    if (d.pressure > 9.0)
-        printf("[PRESSURE ALARM] %.2f bar exceeds limit!\n", d.pressure);
-    if (d.flow > 45.0)
-        printf("[FLOW ALARM] %.2f L/min exceeds limit!\n", d.flow);
+    if (d.temperature > 80.0) {
+        alarms_raised++;
+        if (!quiet) printf("[TEMP ALARM] %.2f°C exceeds limit!\n", d.temperature);
+    }
+    if (d.pressure > 9.0) {
+        alarms_raised++;
+        if (!quiet) printf("[PRESSURE ALARM] %.2f bar exceeds limit!\n", d.pressure);
+    }
+    if (d.flow > 45.0) {
+        alarms_raised++;
+        if (!quiet) printf("[FLOW ALARM] %.2f L/min exceeds limit!\n", d.flow);
+    }
 }
 
 void displayLastReading(const SensorData *d, int index) {
@@ -74,11 +81,36 @@ void displayLastReading(const SensorData *d, int index) {
            index, d->temperature, d->pressure, d->flow);
 }
 
-int main() {
-    srand(time(NULL));
+int main(int argc, char *argv[]) {
+    static LoggerBench bench;
+    if (logger_bench_parse(&bench, argc, argv) != 0)
+        return 1;
+    timebase_init(TIMEBASE_AUTO);
+
+    SimConfig sim_cfg;
+    sensor_sim_default_config(&sim_cfg);
+    if (bench.enabled && bench.rate_hz > 0) sim_cfg.rate_hz = bench.rate_hz;
+    sensor_sim_init(&sim, &sim_cfg, (uint64_t)time(NULL));
 
     CircularBuffer cb;
-    initBuffer(&cb, BUFFER_CAPACITY);
+    initBuffer(&cb, bench.buffer ? bench.buffer : BUFFER_CAPACITY);
+
+    if (bench.enabled) {
+        quiet = 1;
+        bench.buffer = cb.capacity;
+        logger_bench_start(&bench);
+        for (unsigned long i = 0; i < bench.count; i++) {
+            logger_bench_pace(&bench);
+            SensorData d = simulateSensor();
+            addReading(&cb, d);
+            logger_bench_done(&bench);
+        }
+        logger_bench_stop(&bench);
+        bench.alarms = alarms_raised;
+        logger_bench_report(&bench, "realtime_sensor_logger");
+        freeBuffer(&cb);
+        return 0;
+    }
 
     printf("Starting real-time sensor simulation... (Ctrl+C to stop)\n");
 
@@ -90,7 +122,7 @@ int main() {
 
         printf("\n--- Reading #%d ---\n", readingCount);
         displayLastReading(&d, readingCount);
-        printf("Buffer usage: %d/%d\n", cb.count, cb.capacity);
+        printf("Buffer usage: %zu/%d\n", spsc_count(&cb.ring), cb.capacity);
 
         sleep(1); // wait 1 second between readings
     }
@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "rollup.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROLLUP_DEFAULT_1S  3600u      // one hour of seconds
+#define ROLLUP_DEFAULT_1M  10080u     // one week of minutes
+#define ROLLUP_DEFAULT_1H  8760u      // one year of hours
+
+#define ROLLUP_HEADER "start,count,temp_min,temp_max,temp_mean,press_min,press_max,press_mean," \
+                      "flow_min,flow_max,flow_mean\n"
+
+static const char *tier_names[ROLLUP_TIERS] = { "1s", "1m", "1h" };
+static const unsigned long tier_seconds[ROLLUP_TIERS] = { 1, 60, 3600 };
+
+const char *rollup_tier_name(int tier) {
+    return tier >= 0 && tier < ROLLUP_TIERS ? tier_names[tier] : "?";
+}
+
+void rollup_default_config(RollupConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->capacity[ROLLUP_1S] = ROLLUP_DEFAULT_1S;
+    cfg->capacity[ROLLUP_1M] = ROLLUP_DEFAULT_1M;
+    cfg->capacity[ROLLUP_1H] = ROLLUP_DEFAULT_1H;
+    seg_log_default_config(&cfg->disk);
+    cfg->disk.segment_bytes = 4u << 20;
+}
+
+int rollup_init(Rollup *r, double ticks_per_s, const RollupConfig *cfg) {
+    RollupConfig def;
+    if (!cfg) {
+        rollup_default_config(&def);
+        cfg = &def;
+    }
+    memset(r, 0, sizeof(*r));
+    if (ticks_per_s <= 0) ticks_per_s = 1.0;
+
+    for (int t = 0; t < ROLLUP_TIERS; t++) {
+        RollupTier *tier = &r->tier[t];
+        uint64_t width = (uint64_t)(ticks_per_s * (double)tier_seconds[t] + 0.5);
+        tier->width = width ? width : 1;
+        tier->capacity = cfg->capacity[t] ? cfg->capacity[t]
+                       : t == ROLLUP_1S ? ROLLUP_DEFAULT_1S : t == ROLLUP_1M ? ROLLUP_DEFAULT_1M
+                       : ROLLUP_DEFAULT_1H;
+        tier->ring = malloc(tier->capacity * sizeof(RollupRow));
+        if (!tier->ring) {
+            rollup_free(r);
+            return -1;
+        }
+        if (cfg->disk_base) {
+            SegLogConfig seg = cfg->disk;
+            char base[200];
+            snprintf(base, sizeof(base), "%s_%s", cfg->disk_base, tier_names[t]);
+            seg.header = ROLLUP_HEADER;
+            if (seg_log_open(&tier->disk, base, "csv", &seg) != 0) {
+                rollup_free(r);
+                return -1;
+            }
+            tier->on_disk = 1;
+        }
+    }
+    return 0;
+}
+
+static void open_bucket(RollupTier *tier, uint64_t start) {
+    memset(&tier->open, 0, sizeof(tier->open));
+    memset(tier->sum, 0, sizeof(tier->sum));
+    tier->open.start = start;
+}
+
+// Add count samples with the given min/max/sum to the open bucket
+static void accumulate(RollupTier *tier, uint32_t count, const float *mn, const float *mx,
+                       const double *sum) {
+    RollupRow *o = &tier->open;
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        if (o->count == 0 || mn[c] < o->min[c]) o->min[c] = mn[c];
+        if (o->count == 0 || mx[c] > o->max[c]) o->max[c] = mx[c];
+        tier->sum[c] += sum[c];
+    }
+    o->count += count;
+}
+
+static void write_row(RollupTier *tier, const RollupRow *row) {
+    seg_log_printf(&tier->disk, "%" PRIu64 ",%u,%.2f,%.2f,%.3f,%.2f,%.2f,%.3f,%.2f,%.2f,%.3f\n",
+                   row->start, row->count,
+                   row->min[0], row->max[0], row->mean[0],
+                   row->min[1], row->max[1], row->mean[1],
+                   row->min[2], row->max[2], row->mean[2]);
+}
+
+// Store the open bucket of tier t and fold it into tier t + 1
+static void close_bucket(Rollup *r, int t) {
+    RollupTier *tier = &r->tier[t];
+    RollupRow *o = &tier->open;
+    if (o->count == 0) return;
+    for (int c = 0; c < SENSOR_CHANNELS; c++) o->mean[c] = (float)(tier->sum[c] / o->count);
+
+    tier->ring[tier->head % tier->capacity] = *o;
+    tier->head++;
+    if (tier->on_disk) write_row(tier, o);
+
+    if (t + 1 < ROLLUP_TIERS) {
+        RollupTier *up = &r->tier[t + 1];
+        uint64_t start = o->start - o->start % up->width;
+        if (up->open.count && start != up->open.start) close_bucket(r, t + 1);
+        if (up->open.count == 0) open_bucket(up, start);
+        accumulate(up, o->count, o->min, o->max, tier->sum);
+    }
+    o->count = 0;
+}
+
+void rollup_add(Rollup *r, const SensorData *d) {
+    RollupTier *sec = &r->tier[ROLLUP_1S];
+    const float v[SENSOR_CHANNELS] = { d->temperature, d->pressure, d->flow };
+    const double s[SENSOR_CHANNELS] = { d->temperature, d->pressure, d->flow };
+    r->samples++;
+
+    // common case: same second as the previous sample, no division
+    if (sec->open.count && d->timestamp - sec->open.start < sec->width &&
+        d->timestamp >= sec->open.start) {
+        accumulate(sec, 1, v, v, s);
+        return;
+    }
+
+    uint64_t start = d->timestamp - d->timestamp % sec->width;
+    if (sec->open.count && start != sec->open.start) {
+        if (start > sec->open.start) close_bucket(r, ROLLUP_1S);
+        else r->late++;               // clock stepped back: keep it in the open bucket
+    }
+    if (sec->open.count == 0) open_bucket(sec, start);
+    accumulate(sec, 1, v, v, s);
+}
+
+void rollup_flush(Rollup *r) {
+    for (int t = 0; t < ROLLUP_TIERS; t++) close_bucket(r, t);
+}
+
+void rollup_free(Rollup *r) {
+    rollup_flush(r);
+    for (int t = 0; t < ROLLUP_TIERS; t++) {
+        RollupTier *tier = &r->tier[t];
+        if (tier->on_disk) seg_log_close(&tier->disk);
+        tier->on_disk = 0;
+        free(tier->ring);
+        tier->ring = NULL;
+    }
+}
+
+size_t rollup_count(const Rollup *r, int tier) {
+    const RollupTier *t = &r->tier[tier];
+    return t->head < t->capacity ? t->head : t->capacity;
+}
+
+// i-th oldest row still in the ring
+static const RollupRow *row_at(const RollupTier *t, size_t oldest, size_t i) {
+    return &t->ring[(oldest + i) % t->capacity];
+}
+
+size_t rollup_query(const Rollup *r, int tier, uint64_t from, uint64_t to,
+                    RollupRow *out, size_t max) {
+    const RollupTier *t = &r->tier[tier];
+    size_t n = rollup_count(r, tier), oldest = t->head - n;
+
+    // rows are in start order: binary search the first that ends after from
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (row_at(t, oldest, mid)->start + t->width <= from) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t k = 0;
+    for (size_t i = lo; i < n && k < max; i++) {
+        const RollupRow *row = row_at(t, oldest, i);
+        if (row->start > to) break;
+        out[k++] = *row;
+    }
+    return k;
+}
+
+int rollup_pick_tier(const Rollup *r, uint64_t from, uint64_t to, size_t max_rows) {
+    for (int t = 0; t < ROLLUP_TIERS - 1; t++) {
+        const RollupTier *tier = &r->tier[t];
+        size_t n = rollup_count(r, t);
+        if (n == 0) continue;
+        uint64_t oldest = row_at(tier, tier->head - n, 0)->start;
+        uint64_t rows = to >= from ? (to - from) / tier->width + 1 : 1;
+        if (oldest <= from && rows <= max_rows) return t;
+    }
+    return ROLLUP_TIERS - 1;
+}
+
+void rollup_merge(RollupRow *acc, const RollupRow *row) {
+    if (row->count == 0) return;
+    if (acc->count == 0) {
+        *acc = *row;
+        return;
+    }
+    double n = (double)acc->count + (double)row->count;
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        if (row->min[c] < acc->min[c]) acc->min[c] = row->min[c];
+        if (row->max[c] > acc->max[c]) acc->max[c] = row->max[c];
+        acc->mean[c] = (float)(((double)acc->mean[c] * acc->count +
+                                (double)row->mean[c] * row->count) / n);
+    }
+    acc->count += row->count;
+}
@@ -0,0 +1,88 @@
+/*
+ * Rollup Tiers
+ * Author: Evara
+ *
+ * Long-term retention without keeping every raw sample. Samples are
+ * aggregated incrementally into three tiers of fixed-width buckets:
+ *   1 s   ->  1 min  ->  1 h
+ * Each bucket (RollupRow) keeps count, min, max and mean per channel. A
+ * sample only touches the open 1 s bucket; when a bucket closes it is
+ * stored in its tier and folded into the open bucket of the next tier, so
+ * the cost per sample stays O(1) and coarse tiers never rescan raw data.
+ *
+ * Every tier has its own bounded ring (oldest rows are overwritten, like
+ * the circular buffers) and can also append its rows to rotating on-disk
+ * segments (seg_log.h: rollup_1s.NNNNNN.csv, ...), so each resolution gets
+ * its own retention.
+ *
+ * A query over a long range reads one row per hour instead of thousands of
+ * samples: rollup_pick_tier() chooses the finest tier that still covers
+ * the range within a row budget.
+ *
+ * Single producer: rollup_add() must be called from one thread.
+ */
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_data.h"
+#include "sensor_history.h"
+#include "seg_log.h"
+
+typedef enum { ROLLUP_1S = 0, ROLLUP_1M, ROLLUP_1H, ROLLUP_TIERS } RollupTierId;
+
+typedef struct {
+    uint64_t start;                    // bucket start, SensorData.timestamp units
+    uint32_t count;                    // samples in the bucket
+    float min[SENSOR_CHANNELS];
+    float max[SENSOR_CHANNELS];
+    float mean[SENSOR_CHANNELS];
+} RollupRow;
+
+typedef struct {
+    size_t capacity[ROLLUP_TIERS];     // rows kept in memory per tier (0 = default)
+    const char *disk_base;             // e.g. "rollup": rollup_1s.NNNNNN.csv; NULL = memory only
+    SegLogConfig disk;                 // segment size / files kept per tier
+} RollupConfig;
+
+typedef struct {
+    uint64_t width;                    // bucket width in timestamp units
+    RollupRow *ring;
+    size_t capacity;
+    size_t head;                       // rows closed so far, free-running
+
+    RollupRow open;                    // bucket being filled (open.count > 0)
+    double sum[SENSOR_CHANNELS];       // exact running sums behind open.mean
+
+    SegLog disk;
+    int on_disk;
+} RollupTier;
+
+typedef struct {
+    RollupTier tier[ROLLUP_TIERS];
+    unsigned long samples;
+    unsigned long late;                // samples older than the open 1 s bucket
+} Rollup;
+
+void rollup_default_config(RollupConfig *cfg);
+// ticks_per_s: SensorData.timestamp units per second. Returns 0 on success.
+int  rollup_init(Rollup *r, double ticks_per_s, const RollupConfig *cfg);
+void rollup_add(Rollup *r, const SensorData *d);
+void rollup_flush(Rollup *r);          // close all open buckets (end of run)
+void rollup_free(Rollup *r);           // flush, close disk segments, free rings
+
+const char *rollup_tier_name(int tier);   // "1s", "1m", "1h"
+size_t rollup_count(const Rollup *r, int tier);   // rows held in the ring
+
+// Closed rows of one tier overlapping [from, to], oldest first; returns how
+// many. A bucket still open (the current hour in the 1 h tier) is only
+// visible through the finer tiers until it closes or rollup_flush().
+size_t rollup_query(const Rollup *r, int tier, uint64_t from, uint64_t to,
+                    RollupRow *out, size_t max);
+// Finest tier that still holds `from` and needs at most max_rows rows
+int    rollup_pick_tier(const Rollup *r, uint64_t from, uint64_t to, size_t max_rows);
+// Fold row into acc (acc->count == 0 starts a new aggregate)
+void   rollup_merge(RollupRow *acc, const RollupRow *row);
+
+#endif
@@ -0,0 +1,300 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "seg_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+static double monotonic_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+void seg_log_default_config(SegLogConfig *cfg) {
+    cfg->segment_bytes = 16u << 20;
+    cfg->rotate_s = 0;
+    cfg->max_segments = 8;
+    cfg->sync_ms = 1000;
+    cfg->header = NULL;
+}
+
+int seg_log_parse(SegLogConfig *cfg, const char *spec) {
+    char *end;
+    unsigned long long size = strtoull(spec, &end, 10);
+    if (*end == 'k' || *end == 'K') { size <<= 10; end++; }
+    else if (*end == 'm' || *end == 'M') { size <<= 20; end++; }
+    if (size == 0) return -1;
+    cfg->segment_bytes = (size_t)size;
+    if (*end == ',') {
+        cfg->max_segments = (unsigned int)strtoul(end + 1, &end, 10);
+        if (*end == ',') cfg->rotate_s = (unsigned int)strtoul(end + 1, &end, 10);
+    }
+    return *end == '\0' ? 0 : -1;
+}
+
+static void segment_path(const SegLog *w, unsigned long seq, char *out, size_t len) {
+    snprintf(out, len, "%s.%06lu.%s", w->base, seq, w->ext);
+}
+
+static void set_error(SegLog *w, int err) {
+    if (!w->error) w->error = err;
+}
+
+// Trim the current segment to what was written and release it (lock held)
+static void close_segment(SegLog *w) {
+    if (!w->map) return;
+    size_t used = __atomic_load_n(&w->used, __ATOMIC_ACQUIRE);
+    msync(w->map, w->cfg.segment_bytes, MS_ASYNC);
+    munmap(w->map, w->cfg.segment_bytes);
+    if (ftruncate(w->fd, (off_t)used) != 0) set_error(w, errno);
+    close(w->fd);
+    w->map = NULL;
+    w->fd = -1;
+}
+
+// name is "<prefix>.<digits>.<ext>": store the digits in *seq
+static int parse_segment_name(const char *name, const char *prefix, const char *ext,
+                              unsigned long *seq) {
+    size_t plen = strlen(prefix);
+    if (strncmp(name, prefix, plen) != 0 || name[plen] != '.') return 0;
+    const char *p = name + plen + 1, *digits = p;
+    unsigned long v = 0;
+    while (*p >= '0' && *p <= '9') v = v * 10 + (unsigned long)(*p++ - '0');
+    if (p == digits || *p != '.' || strcmp(p + 1, ext) != 0) return 0;
+    *seq = v;
+    return 1;
+}
+
+// Continue numbering after the highest segment already on disk, so a
+// restart neither truncates segment 0 nor leaves newer segments of an
+// earlier run behind; segments outside the retention window are removed
+static void resume_seq(SegLog *w) {
+    char dir[256];
+    const char *prefix = strrchr(w->base, '/');
+    if (prefix) {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(prefix - w->base), w->base);
+        if (dir[0] == '\0') snprintf(dir, sizeof(dir), "/");
+        prefix++;
+    } else {
+        snprintf(dir, sizeof(dir), ".");
+        prefix = w->base;
+    }
+    DIR *d = opendir(dir);
+    if (!d) return;
+
+    struct dirent *e;
+    unsigned long seq, top = 0;
+    int found = 0;
+    while ((e = readdir(d)) != NULL) {
+        if (!parse_segment_name(e->d_name, prefix, w->ext, &seq)) continue;
+        if (!found || seq > top) top = seq;
+        found = 1;
+    }
+    if (found) w->seq = top + 1;
+
+    if (found && w->cfg.max_segments) {
+        char path[300];
+        rewinddir(d);
+        while ((e = readdir(d)) != NULL) {
+            if (!parse_segment_name(e->d_name, prefix, w->ext, &seq)) continue;
+            if (seq + w->cfg.max_segments > w->seq) continue;   // still in the window
+            segment_path(w, seq, path, sizeof(path));
+            if (unlink(path) == 0) w->removed++;
+        }
+    }
+    closedir(d);
+}
+
+// Create, preallocate and map segment w->seq (lock held)
+static int open_segment(SegLog *w) {
+    char path[300];
+    segment_path(w, w->seq, path, sizeof(path));
+
+    w->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (w->fd < 0) {
+        set_error(w, errno);
+        return -1;
+    }
+    int rc = posix_fallocate(w->fd, 0, (off_t)w->cfg.segment_bytes);
+    if (rc != 0 && ftruncate(w->fd, (off_t)w->cfg.segment_bytes) != 0) {
+        set_error(w, rc);
+        close(w->fd);
+        w->fd = -1;
+        return -1;
+    }
+    void *map = mmap(NULL, w->cfg.segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, w->fd, 0);
+    if (map == MAP_FAILED) {
+        set_error(w, errno);
+        close(w->fd);
+        w->fd = -1;
+        return -1;
+    }
+
+    w->map = (char *)map;
+    __atomic_store_n(&w->used, 0, __ATOMIC_RELEASE);
+    w->synced = 0;
+    w->opened_s = monotonic_s();
+    w->segments++;
+
+    // retention: drop the segment that just fell out of the window
+    if (w->cfg.max_segments && w->seq >= w->cfg.max_segments) {
+        segment_path(w, w->seq - w->cfg.max_segments, path, sizeof(path));
+        if (unlink(path) == 0) w->removed++;
+    }
+
+    if (w->cfg.header) {
+        size_t len = strlen(w->cfg.header);
+        if (len < w->cfg.segment_bytes) {
+            memcpy(w->map, w->cfg.header, len);
+            __atomic_store_n(&w->used, len, __ATOMIC_RELEASE);
+        }
+    }
+    return 0;
+}
+
+static int rotate(SegLog *w) {
+    pthread_mutex_lock(&w->lock);
+    close_segment(w);
+    w->seq++;
+    int rc = open_segment(w);
+    __atomic_store_n(&w->rotate_due, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&w->lock);
+    return rc;
+}
+
+static void *flusher_thread(void *arg) {
+    SegLog *w = (SegLog *)arg;
+    long page = sysconf(_SC_PAGESIZE);
+    double last_sync = monotonic_s();
+    // wake often enough to notice the rotation deadline within 100 ms
+    unsigned int tick_ms = w->cfg.sync_ms ? w->cfg.sync_ms : 100;
+    if (w->cfg.rotate_s && tick_ms > 100) tick_ms = 100;
+
+    pthread_mutex_lock(&w->lock);
+    while (!w->closing) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        long ns = until.tv_nsec + (long)(tick_ms % 1000) * 1000000L;
+        until.tv_sec += (time_t)(tick_ms / 1000) + ns / 1000000000L;
+        until.tv_nsec = ns % 1000000000L;
+        pthread_cond_timedwait(&w->wake, &w->lock, &until);
+        if (w->closing || !w->map) continue;
+
+        if (w->cfg.rotate_s && monotonic_s() - w->opened_s >= w->cfg.rotate_s &&
+            !__atomic_load_n(&w->rotate_due, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&w->rotate_due, 1, __ATOMIC_RELAXED);
+            w->time_rotations++;
+        }
+
+        size_t used = __atomic_load_n(&w->used, __ATOMIC_ACQUIRE);
+        if (w->cfg.sync_ms && used > w->synced &&
+            monotonic_s() - last_sync >= w->cfg.sync_ms / 1e3) {
+            size_t start = w->synced & ~((size_t)page - 1);   // msync needs page alignment
+            if (msync(w->map + start, used - start, MS_ASYNC) != 0) set_error(w, errno);
+            w->synced = used;
+            w->msyncs++;
+            last_sync = monotonic_s();
+        }
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+int seg_log_open(SegLog *w, const char *base, const char *ext, const SegLogConfig *cfg) {
+    memset(w, 0, sizeof(*w));
+    if (cfg) w->cfg = *cfg;
+    else seg_log_default_config(&w->cfg);
+    if (w->cfg.segment_bytes < 4 * SEG_LOG_MAX_RECORD) w->cfg.segment_bytes = 4 * SEG_LOG_MAX_RECORD;
+    snprintf(w->base, sizeof(w->base), "%s", base);
+    snprintf(w->ext, sizeof(w->ext), "%s", ext);
+    w->fd = -1;
+
+    resume_seq(w);
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    if (open_segment(w) != 0) goto fail;
+    if (pthread_create(&w->thread, NULL, flusher_thread, w) != 0) {
+        close_segment(w);
+        goto fail;
+    }
+    return 0;
+
+fail:
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->wake);
+    return -1;
+}
+
+// Make room for len bytes in the current segment, rotating if needed
+static char *reserve(SegLog *w, size_t len) {
+    if (!w->map) return NULL;
+    if (__atomic_load_n(&w->rotate_due, __ATOMIC_RELAXED) ||
+        w->used + len > w->cfg.segment_bytes) {
+        if (rotate(w) != 0) return NULL;
+        if (w->used + len > w->cfg.segment_bytes) return NULL;
+    }
+    return w->map + w->used;
+}
+
+static void commit(SegLog *w, size_t len) {
+    __atomic_store_n(&w->used, w->used + len, __ATOMIC_RELEASE);
+    w->records++;
+    w->bytes += len;
+}
+
+int seg_log_write(SegLog *w, const void *data, size_t len) {
+    char *dst = reserve(w, len);
+    if (!dst) {
+        w->dropped++;
+        return -1;
+    }
+    memcpy(dst, data, len);
+    commit(w, len);
+    return 0;
+}
+
+int seg_log_printf(SegLog *w, const char *fmt, ...) {
+    va_list ap;
+    // format in place; rotate only when the record did not fit
+    for (int attempt = 0; attempt < 2 && w->map; attempt++) {
+        if (__atomic_load_n(&w->rotate_due, __ATOMIC_RELAXED) && rotate(w) != 0) break;
+        size_t room = w->cfg.segment_bytes - w->used;
+        if (room > SEG_LOG_MAX_RECORD) room = SEG_LOG_MAX_RECORD;
+        va_start(ap, fmt);
+        int n = vsnprintf(w->map + w->used, room, fmt, ap);
+        va_end(ap);
+        if (n < 0) break;
+        if ((size_t)n < room) {
+            commit(w, (size_t)n);
+            return n;
+        }
+        if (room == SEG_LOG_MAX_RECORD) {   // too long for any segment: truncate
+            commit(w, room - 1);
+            return (int)room - 1;
+        }
+        // the partial record lies past `used`: close_segment() trims it off
+        if (rotate(w) != 0) break;
+    }
+    w->dropped++;
+    return -1;
+}
+
+void seg_log_close(SegLog *w) {
+    pthread_mutex_lock(&w->lock);
+    w->closing = 1;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    close_segment(w);
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->wake);
+}
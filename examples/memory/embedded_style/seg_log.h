@@ -0,0 +1,79 @@
+/*
+ * Memory-Mapped Segment Log
+ * Author: Evara
+ *
+ * Log backend that writes records straight into mmap'd, preallocated
+ * segment files instead of calling write():
+ *  - each segment is created at its full size with posix_fallocate, so the
+ *    file system allocates blocks once instead of on every append
+ *  - records are formatted directly into the mapping: no syscall per record
+ *  - a new segment is started at the size limit or after rotate_s seconds,
+ *    and only the newest max_segments files are kept
+ *  - a background thread issues msync(MS_ASYNC) every sync_ms so dirty
+ *    pages are handed to writeback without blocking the producer
+ *
+ * Files are named <base>.<seq>.<ext> (seq = 000000, 000001, ...). Opening
+ * continues after the highest seq already on disk, so earlier runs are
+ * neither overwritten nor interleaved, and applies max_segments to them. A
+ * closed segment is truncated to the bytes actually written; a segment left
+ * behind by a crash keeps its zero-filled tail.
+ *
+ * Single producer: seg_log_write/printf must be called from one thread.
+ */
+#ifndef SEG_LOG_H
+#define SEG_LOG_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+typedef struct {
+    size_t       segment_bytes;  // preallocated size per segment (default 16 MiB)
+    unsigned int rotate_s;       // also rotate after this many seconds, 0 = size only
+    unsigned int max_segments;   // files kept on disk (default 8), 0 = unbounded
+    unsigned int sync_ms;        // msync(MS_ASYNC) cadence (default 1000), 0 = never
+    const char  *header;         // written at the start of every segment, may be NULL
+} SegLogConfig;
+
+typedef struct {
+    SegLogConfig cfg;
+    char   base[256];
+    char   ext[16];
+
+    int    fd;
+    char  *map;                  // current segment mapping
+    size_t used;                 // bytes written into it (published to the flusher)
+    size_t synced;               // flusher: bytes already passed to msync
+    unsigned long seq;           // current segment number
+    double opened_s;             // CLOCK_MONOTONIC time the segment was opened
+    int    rotate_due;           // set by the flusher when rotate_s elapsed
+
+    pthread_mutex_t lock;        // segment switch vs. flusher
+    pthread_cond_t  wake;
+    pthread_t       thread;
+    int    closing;
+
+    // Statistics
+    unsigned long records;
+    unsigned long long bytes;
+    unsigned long segments;      // segments opened
+    unsigned long time_rotations;
+    unsigned long removed;       // old segments deleted by the retention limit
+    unsigned long msyncs;
+    unsigned long dropped;       // records larger than a whole segment
+    int  error;                  // first errno from open/fallocate/mmap/msync
+} SegLog;
+
+#define SEG_LOG_MAX_RECORD 512   // longest record accepted by seg_log_printf
+
+void seg_log_default_config(SegLogConfig *cfg);
+int  seg_log_parse(SegLogConfig *cfg, const char *spec);  // "SIZE[k|m][,MAX[,SECONDS]]"
+
+// base "data_log", ext "csv" -> data_log.000000.csv, ... Returns 0 on success;
+// on failure nothing is left open and seg_log_close() must not be called.
+int  seg_log_open(SegLog *w, const char *base, const char *ext, const SegLogConfig *cfg);
+int  seg_log_write(SegLog *w, const void *data, size_t len);   // one record
+int  seg_log_printf(SegLog *w, const char *fmt, ...)
+         __attribute__((format(printf, 2, 3)));
+void seg_log_close(SegLog *w);   // stop flusher, trim and unmap current segment
+
+#endif
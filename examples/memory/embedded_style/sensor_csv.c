@@ -0,0 +1,269 @@
+#include "sensor_csv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Decimal digits of v, two per table lookup, written back to front
+static size_t write_u64(char *dst, uint64_t v) {
+    char tmp[20];
+    char *p = tmp + sizeof(tmp);
+    while (v >= 100) {
+        unsigned r = (unsigned)(v % 100);
+        v /= 100;
+        p -= 2;
+        memcpy(p, &digit_pairs[r * 2], 2);
+    }
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, &digit_pairs[v * 2], 2);
+    } else {
+        *--p = (char)('0' + v);
+    }
+    size_t len = (size_t)(tmp + sizeof(tmp) - p);
+    memcpy(dst, p, len);
+    return len;
+}
+
+size_t sensor_csv_u64(char *dst, uint64_t v) {
+    return write_u64(dst, v);
+}
+
+size_t sensor_csv_fixed2(char *dst, float v) {
+    double x = (double)v * 100.0;   // exact for every finite float
+    int negative = x < 0.0 || (x == 0.0 && 1.0 / x < 0.0);   // printf keeps "-0.00"
+    double ax = negative ? -x : x;
+
+    if (!(ax < 9.0e18)) {   // NaN, inf, or too wide for uint64 cents
+        char tmp[64];
+        int n = snprintf(tmp, sizeof(tmp), "%.2f", (double)v);
+        memcpy(dst, tmp, (size_t)n);
+        return (size_t)n;
+    }
+
+    uint64_t cents = (uint64_t)ax;
+    double frac = ax - (double)cents;   // exact: removing the integer part never rounds
+    if (frac > 0.5 || (frac == 0.5 && (cents & 1u))) cents++;
+
+    char *p = dst;
+    if (negative) *p++ = '-';
+    p += write_u64(p, cents / 100);
+    *p++ = '.';
+    memcpy(p, &digit_pairs[(cents % 100) * 2], 2);
+    return (size_t)(p + 2 - dst);
+}
+
+size_t sensor_csv_row(char *dst, const SensorData *d) {
+    char *p = dst;
+    p += sensor_csv_fixed2(p, d->temperature);
+    *p++ = ',';
+    p += sensor_csv_fixed2(p, d->pressure);
+    *p++ = ',';
+    p += sensor_csv_fixed2(p, d->flow);
+    *p++ = ',';
+    p += sensor_csv_u64(p, d->timestamp);
+    *p++ = '\n';
+    return (size_t)(p - dst);
+}
+
+// ---- Parser ----
+
+static const double pow10_neg[5] = { 1.0, 10.0, 100.0, 1000.0, 10000.0 };
+
+// Field in the slow lane: let the C library decide
+static int parse_float_slow(const char *p, const char *end, float *out) {
+    char tmp[64];
+    size_t n = (size_t)(end - p);
+    if (n == 0 || n >= sizeof(tmp)) return 0;
+    memcpy(tmp, p, n);
+    tmp[n] = '\0';
+    char *stop;
+    *out = strtof(tmp, &stop);
+    return stop == tmp + n;
+}
+
+// [-]digits[.digits] as an integer mantissa and a power of ten
+static int parse_float(const char *p, const char *end, float *out) {
+    const char *start = p;
+    int neg = 0;
+    if (p < end && *p == '-') {
+        neg = 1;
+        p++;
+    }
+    uint64_t m = 0;
+    int digits = 0, frac = 0;
+    while (p < end && (unsigned)(*p - '0') < 10) {
+        m = m * 10 + (uint64_t)(*p++ - '0');
+        digits++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && (unsigned)(*p - '0') < 10) {
+            m = m * 10 + (uint64_t)(*p++ - '0');
+            digits++;
+            frac++;
+        }
+    }
+    if (p != end || digits == 0 || digits > 15 || frac > 4)
+        return parse_float_slow(start, end, out);
+    double v = (double)m / pow10_neg[frac];
+    *out = (float)(neg ? -v : v);
+    return 1;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define CSV_SWAR 1
+
+// Eight ASCII digits, first character in the lowest byte, to their value
+// (three multiplies instead of eight dependent steps)
+static inline uint32_t swar_digits8(uint64_t x) {
+    x -= 0x3030303030303030ULL;
+    x = (x * 10) + (x >> 8);
+    x = (((x & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((x >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return (uint32_t)x;
+}
+
+static inline int swar_all_digits(uint64_t x) {
+    return ((x & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+// "[-]d{1,5}.dd", the encoder's own output, from one 8-byte load ending at
+// the field's last character; lo is the first byte that may be read
+static inline int parse_fixed2_swar(const char *p, const char *end, const char *lo, float *out) {
+    int neg = *p == '-';
+    p += neg;
+    size_t n = (size_t)(end - p);
+    if (n < 4 || n > 8 || end[-3] != '.' || end - 8 < lo) return 0;
+
+    uint64_t x;
+    memcpy(&x, end - 8, 8);
+    // drop the '.' (byte 5): the integer digits move up next to the fraction
+    x = (x & 0xFFFF000000000000ULL) | ((x & 0x000000FFFFFFFFFFULL) << 8);
+    // bytes in front of the field become leading zeros
+    uint64_t field = ~0ULL << (64 - 8 * (n - 1));
+    x = (x & field) | (0x3030303030303030ULL & ~field);
+    if (!swar_all_digits(x)) return 0;
+
+    double v = (double)swar_digits8(x) / 100.0;
+    *out = (float)(neg ? -v : v);
+    return 1;
+}
+#endif
+
+static int parse_u64(const char *p, const char *end, uint64_t *out) {
+    uint64_t v = 0;
+    if (p == end || end - p > 20) return 0;
+#ifdef CSV_SWAR
+    // epoch timestamps (seconds or nanoseconds): a short scalar prefix,
+    // then eight digits at a time; 19 digits cannot overflow
+    if (end - p >= 8 && end - p <= 19) {
+        const char *lead = p + (end - p) % 8;
+        while (p < lead) {
+            unsigned d = (unsigned)(*p++ - '0');
+            if (d >= 10) return 0;
+            v = v * 10 + d;
+        }
+        for (; p < end; p += 8) {
+            uint64_t x;
+            memcpy(&x, p, 8);
+            if (!swar_all_digits(x)) return 0;
+            v = v * 100000000ULL + swar_digits8(x);
+        }
+        *out = v;
+        return 1;
+    }
+#endif
+    while (p < end) {
+        unsigned d = (unsigned)(*p++ - '0');
+        if (d >= 10 || v > (UINT64_MAX - d) / 10) return 0;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return 1;
+}
+
+// Bit i set where p[i] is ',' or '\n', for 64 bytes (or the n < 64 left)
+static inline uint64_t separator_mask(const char *p, size_t n) {
+    uint64_t mask = 0;
+#ifdef __SSE2__
+    if (n == 64) {
+        const __m128i comma = _mm_set1_epi8(','), nl = _mm_set1_epi8('\n');
+        for (int k = 0; k < 4; k++) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(p + 16 * k));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, nl));
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(hit) << (16 * k);
+        }
+        return mask;
+    }
+#endif
+    for (size_t i = 0; i < n; i++)
+        if (p[i] == ',' || p[i] == '\n') mask |= 1ULL << i;
+    return mask;
+}
+
+size_t sensor_csv_parse(const char *buf, size_t len, SensorData *out, size_t max,
+                        size_t *used, unsigned long *bad_rows) {
+    size_t rows = 0;
+    const char *row_start = buf, *field = buf;
+    int f = 0, bad = 0;
+    float vals[3];
+
+    for (size_t base = 0; base < len && rows < max; base += 64) {
+        size_t n = len - base < 64 ? len - base : 64;
+        uint64_t mask = separator_mask(buf + base, n);
+
+        while (mask) {
+            const char *sep = buf + base + (size_t)__builtin_ctzll(mask);
+            mask &= mask - 1;
+
+            if (*sep == ',') {
+                if (f < 3 && !bad) {
+#ifdef CSV_SWAR
+                    if (!parse_fixed2_swar(field, sep, buf, &vals[f]))
+#endif
+                        bad = !parse_float(field, sep, &vals[f]);
+                } else {
+                    bad = 1;
+                }
+                f++;
+                field = sep + 1;
+                continue;
+            }
+
+            // end of row; tolerate CRLF line endings
+            const char *end = sep > field && sep[-1] == '\r' ? sep - 1 : sep;
+            SensorData *d = &out[rows];
+            if (!bad && f == 3 && parse_u64(field, end, &d->timestamp)) {
+                d->temperature = vals[0];
+                d->pressure = vals[1];
+                d->flow = vals[2];
+                rows++;
+            } else if (end > row_start) {
+                (*bad_rows)++;      // blank lines are not errors
+            }
+            row_start = field = sep + 1;
+            f = 0;
+            bad = 0;
+            if (rows == max) break;
+        }
+    }
+    *used = (size_t)(row_start - buf);
+    return rows;
+}
@@ -0,0 +1,39 @@
+/*
+ * Sensor CSV Encoder
+ * Author: Evara
+ *
+ * Formats SensorData rows for data_log.csv without printf. Output is
+ * byte-identical to fprintf("%.2f,%.2f,%.2f,%lu\n") in the C locale:
+ *  - a float scaled by 100 is exact in a double (24-bit mantissa x 7 bits),
+ *    so rounding to two decimals is done on the exact value, with ties to
+ *    even like glibc's printf
+ *  - digits come from a two-digits-per-lookup table, written straight into
+ *    the caller's buffer
+ * NaN, infinities and values beyond 64-bit fixed point fall back to snprintf.
+ *
+ * sensor_csv_parse() reads such rows back for offline replay: separators
+ * are located 64 bytes at a time with SSE2 compares (a bitmask per block,
+ * walked with count-trailing-zeros), and fields in the fixed-point form
+ * the encoder writes are converted without strtod. Anything else (more
+ * than 15 digits, exponents, nan) goes through strtof.
+ */
+#ifndef SENSOR_CSV_H
+#define SENSOR_CSV_H
+
+#include <stddef.h>
+#include "sensor_data.h"
+
+#define SENSOR_CSV_MAX_ROW 160   // worst case: three FLT_MAX fields + 20-digit timestamp
+
+size_t sensor_csv_fixed2(char *dst, float v);          // "%.2f"
+size_t sensor_csv_u64(char *dst, uint64_t v);          // "%" PRIu64
+size_t sensor_csv_row(char *dst, const SensorData *d); // full row incl. '\n', no NUL
+
+// Parse complete "temp,press,flow,timestamp\n" rows from buf[0..len) into
+// out[], at most max rows. Stops before a trailing row without '\n'; *used
+// is set to the bytes consumed. Malformed rows are skipped and counted in
+// *bad_rows. Returns the number of rows stored.
+size_t sensor_csv_parse(const char *buf, size_t len, SensorData *out, size_t max,
+                        size_t *used, unsigned long *bad_rows);
+
+#endif
@@ -0,0 +1,17 @@
+/*
+ * Sensor sample shared by the logger, the binary log format and the tools
+ * Author: Evara
+ */
+#ifndef SENSOR_DATA_H
+#define SENSOR_DATA_H
+
+#include <stdint.h>
+
+typedef struct {
+    float temperature;        // °C
+    float pressure;           // bar
+    float flow;               // L/min
+    uint64_t timestamp;       // loggers: ns since the Unix epoch (timebase.h)
+} SensorData;
+
+#endif
@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_history.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void *aligned_array(size_t n, size_t elem) {
+    void *p = NULL;
+    if (posix_memalign(&p, SENSOR_HISTORY_ALIGN, n * elem) != 0) return NULL;
+    return p;
+}
+
+int history_init(SensorHistory *h, size_t window, double ticks_per_s) {
+    memset(h, 0, sizeof(*h));
+    if (window == 0) return 0;
+
+    size_t cap = 1;
+    while (cap < window) cap <<= 1;
+
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        h->channel[c] = (float *)aligned_array(cap, sizeof(float));
+        if (!h->channel[c]) {
+            history_free(h);
+            return 0;
+        }
+    }
+    h->timestamp = (uint64_t *)aligned_array(cap, sizeof(uint64_t));
+    if (!h->timestamp) {
+        history_free(h);
+        return 0;
+    }
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        h->roll[c].min_q = (size_t *)malloc(cap * sizeof(size_t));
+        h->roll[c].max_q = (size_t *)malloc(cap * sizeof(size_t));
+        if (!h->roll[c].min_q || !h->roll[c].max_q) {
+            history_free(h);
+            return 0;
+        }
+    }
+    h->capacity = cap;
+    h->mask = cap - 1;
+    h->window = window;
+    h->ticks_per_s = ticks_per_s;
+    return 1;
+}
+
+void history_free(SensorHistory *h) {
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        free(h->channel[c]);
+        free(h->roll[c].min_q);
+        free(h->roll[c].max_q);
+    }
+    free(h->timestamp);
+    memset(h, 0, sizeof(*h));
+}
+
+static float value_at(const SensorHistory *h, int c, size_t index) {
+    return h->channel[c][index & h->mask];
+}
+
+// Oldest reading leaves the window: undo its Welford step, expire deques
+static void roll_remove(SensorHistory *h, int c, size_t index, size_t n_after) {
+    RollingChannel *r = &h->roll[c];
+    double x = value_at(h, c, index);
+    if (n_after == 0) {
+        r->mean = 0.0;
+        r->m2 = 0.0;
+    } else {
+        double delta = x - r->mean;
+        r->mean -= delta / (double)n_after;
+        r->m2 -= delta * (x - r->mean);
+        if (r->m2 < 0.0) r->m2 = 0.0;   // rounding
+    }
+    if (r->min_front != r->min_back && r->min_q[r->min_front & h->mask] == index) r->min_front++;
+    if (r->max_front != r->max_back && r->max_q[r->max_front & h->mask] == index) r->max_front++;
+}
+
+// New reading (already stored) enters the window
+static void roll_add(SensorHistory *h, int c, size_t index, size_t n_after) {
+    RollingChannel *r = &h->roll[c];
+    float v = value_at(h, c, index);
+    double delta = v - r->mean;
+    r->mean += delta / (double)n_after;
+    r->m2 += delta * (v - r->mean);
+
+    // drop entries the new value dominates; each index is popped at most once
+    while (r->min_back != r->min_front && value_at(h, c, r->min_q[(r->min_back - 1) & h->mask]) >= v)
+        r->min_back--;
+    r->min_q[r->min_back++ & h->mask] = index;
+    while (r->max_back != r->max_front && value_at(h, c, r->max_q[(r->max_back - 1) & h->mask]) <= v)
+        r->max_back--;
+    r->max_q[r->max_back++ & h->mask] = index;
+}
+
+// Feed the new reading to the rebase accumulators. After `window` pushes
+// they hold exactly the current window, computed with additions only, and
+// replace the sliding mean/m2 so its rounding drift never outlives one
+// window. Shifting by the pass's first value keeps the sums well
+// conditioned (values sit near it), and costs no division per push.
+static void roll_rebase_step(SensorHistory *h, size_t index) {
+    if (h->rebase_n == 0)
+        for (int c = 0; c < SENSOR_CHANNELS; c++) {
+            RollingChannel *r = &h->roll[c];
+            r->shift = value_at(h, c, index);
+            r->s1 = 0.0;
+            r->s2 = 0.0;
+        }
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        RollingChannel *r = &h->roll[c];
+        double d = value_at(h, c, index) - r->shift;
+        r->s1 += d;
+        r->s2 += d * d;
+    }
+    if (++h->rebase_n < h->window) return;
+
+    // the pass spans `window` pushes, so it is exactly the current window
+    double n = (double)h->window;
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        RollingChannel *r = &h->roll[c];
+        r->mean = r->shift + r->s1 / n;
+        r->m2 = r->s2 - r->s1 * r->s1 / n;
+        if (r->m2 < 0.0) r->m2 = 0.0;
+    }
+    h->rebase_n = 0;
+}
+
+void history_push(SensorHistory *h, const SensorData *d) {
+    // Window full — drop the oldest reading
+    if (h->head - h->tail >= h->window) {
+        for (int c = 0; c < SENSOR_CHANNELS; c++)
+            roll_remove(h, c, h->tail, h->window - 1);
+        h->tail++;
+        h->overwrite_count++;
+    }
+    size_t slot = h->head & h->mask;
+    h->channel[SENSOR_CH_TEMPERATURE][slot] = d->temperature;
+    h->channel[SENSOR_CH_PRESSURE][slot] = d->pressure;
+    h->channel[SENSOR_CH_FLOW][slot] = d->flow;
+    h->timestamp[slot] = d->timestamp;
+    size_t n = history_count(h) + 1;
+    for (int c = 0; c < SENSOR_CHANNELS; c++)
+        roll_add(h, c, h->head, n);
+    roll_rebase_step(h, h->head);
+    h->head++;
+}
+
+size_t history_count(const SensorHistory *h) {
+    return h->head - h->tail;
+}
+
+int history_get(const SensorHistory *h, size_t i, SensorData *out) {
+    if (i >= history_count(h)) return 0;
+    size_t slot = (h->tail + i) & h->mask;
+    out->temperature = h->channel[SENSOR_CH_TEMPERATURE][slot];
+    out->pressure = h->channel[SENSOR_CH_PRESSURE][slot];
+    out->flow = h->channel[SENSOR_CH_FLOW][slot];
+    out->timestamp = h->timestamp[slot];
+    return 1;
+}
+
+// Split the window into [first, end of array) and [0, rest)
+static size_t split(const SensorHistory *h, size_t *first, size_t *n0, size_t *n1) {
+    size_t count = history_count(h);
+    *first = h->tail & h->mask;
+    *n0 = count < h->capacity - *first ? count : h->capacity - *first;
+    *n1 = count - *n0;
+    return count;
+}
+
+size_t history_channel_spans(const SensorHistory *h, SensorChannel ch, ChannelSpan spans[2]) {
+    size_t first, n0, n1;
+    size_t count = split(h, &first, &n0, &n1);
+    spans[0].data = h->channel[ch] + first;
+    spans[0].count = n0;
+    spans[1].data = h->channel[ch];
+    spans[1].count = n1;
+    return count;
+}
+
+size_t history_timestamp_spans(const SensorHistory *h, TimestampSpan spans[2]) {
+    size_t first, n0, n1;
+    size_t count = split(h, &first, &n0, &n1);
+    spans[0].data = h->timestamp + first;
+    spans[0].count = n0;
+    spans[1].data = h->timestamp;
+    spans[1].count = n1;
+    return count;
+}
+
+int history_stats(const SensorHistory *h, SensorChannel ch, ChannelStats *out) {
+    size_t n = history_count(h);
+    memset(out, 0, sizeof(*out));
+    if (n == 0) return 0;
+
+    const RollingChannel *r = &h->roll[ch];
+    out->count = n;
+    out->mean = (float)r->mean;
+    out->variance = n > 1 ? (float)(r->m2 / (double)(n - 1)) : 0.0f;
+    out->min = value_at(h, ch, r->min_q[r->min_front & h->mask]);
+    out->max = value_at(h, ch, r->max_q[r->max_front & h->mask]);
+    out->first = value_at(h, ch, h->tail);
+    out->last = value_at(h, ch, h->head - 1);
+
+    uint64_t t0 = h->timestamp[h->tail & h->mask];
+    uint64_t t1 = h->timestamp[(h->head - 1) & h->mask];
+    out->rate_per_s = t1 > t0 ? (float)((double)(out->last - out->first) * h->ticks_per_s /
+                                        (double)(t1 - t0))
+                              : 0.0f;
+    return 1;
+}
+
+size_t history_copy_channel(const SensorHistory *h, SensorChannel ch, float *out) {
+    ChannelSpan spans[2];
+    size_t count = history_channel_spans(h, ch, spans);
+    memcpy(out, spans[0].data, spans[0].count * sizeof(float));
+    memcpy(out + spans[0].count, spans[1].data, spans[1].count * sizeof(float));
+    return count;
+}
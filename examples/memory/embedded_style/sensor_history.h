@@ -0,0 +1,109 @@
+/*
+ * Structure-of-Arrays Sensor History
+ * Author: Evara
+ *
+ * Ring buffer of SensorData stored one array per channel instead of one
+ * array of structs, so scanning a single channel (all temperatures in the
+ * window) streams only that channel through the cache:
+ *  - each channel array is 64-byte aligned and `capacity` (power of two)
+ *    elements long; the same slot index addresses all channels
+ *  - ring semantics match the loggers' CircularBuffer: head/tail are
+ *    free-running indices, `window` readings are kept and pushing into a
+ *    full window drops the oldest one and counts it in overwrite_count
+ *  - span accessors return the window as at most two contiguous runs per
+ *    channel (oldest first); runs of different channels line up index for
+ *    index, so they can be fed straight to alarm_eval() and friends
+ *  - rolling statistics per channel (mean, variance, min, max, rate of
+ *    change) are maintained on every push in O(1): a sliding Welford
+ *    update for mean/variance and monotonic deques for min/max, so
+ *    history_stats() costs the same for any window size
+ *  - the sliding update drifts by rounding, so a second accumulator sums
+ *    each window's readings as they arrive (shifted sums, no removals)
+ *    and replaces mean/variance once it covers a whole window: still O(1)
+ *    per push, with no periodic rescan
+ *
+ * Single owner: push and read from the same thread.
+ */
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stddef.h>
+#include "sensor_data.h"
+
+typedef enum {
+    SENSOR_CH_TEMPERATURE = 0,
+    SENSOR_CH_PRESSURE,
+    SENSOR_CH_FLOW,
+    SENSOR_CHANNELS
+} SensorChannel;
+
+#define SENSOR_HISTORY_ALIGN 64   // bytes, one cache line
+
+// Per-channel rolling state, updated by history_push()
+typedef struct {
+    double mean;                      // Welford accumulators over the window
+    double m2;
+    size_t *min_q;                    // monotonic deques of free-running indices:
+    size_t *max_q;                    // front = index of the window min / max
+    size_t min_front, min_back;
+    size_t max_front, max_back;
+    double shift;                     // rebase accumulator: first value of the pass,
+    double s1, s2;                    // sums of (x - shift) and (x - shift)^2
+} RollingChannel;
+
+typedef struct {
+    size_t count;
+    float mean;
+    float variance;                   // sample variance (n - 1)
+    float min;
+    float max;
+    float first;                      // oldest value in the window
+    float last;                       // newest value
+    float rate_per_s;                 // (last - first) per second, 0 if no time passed
+} ChannelStats;
+
+typedef struct {
+    float *channel[SENSOR_CHANNELS];  // aligned per-channel arrays
+    uint64_t *timestamp;              // aligned like the channels
+    size_t capacity;                  // slots, power of two >= window
+    size_t mask;
+    size_t window;                    // readings kept (user-defined size)
+    double ticks_per_s;               // SensorData.timestamp units per second
+    size_t head;                      // next write, free-running
+    size_t tail;                      // oldest reading, free-running
+    unsigned long overwrite_count;
+    size_t rebase_n;                  // readings in the rebase accumulators
+    RollingChannel roll[SENSOR_CHANNELS];
+} SensorHistory;
+
+// A contiguous run of one channel
+typedef struct {
+    const float *data;
+    size_t count;
+} ChannelSpan;
+
+typedef struct {
+    const uint64_t *data;
+    size_t count;
+} TimestampSpan;
+
+// ticks_per_s: SensorData.timestamp units per second (for rate_per_s).
+// Returns 1 on success, like initBuffer.
+int    history_init(SensorHistory *h, size_t window, double ticks_per_s);
+void   history_free(SensorHistory *h);
+void   history_push(SensorHistory *h, const SensorData *d);
+size_t history_count(const SensorHistory *h);
+int    history_get(const SensorHistory *h, size_t i, SensorData *out);   // i = 0 is oldest
+
+// Window of one channel as up to two runs, oldest first; returns total count
+size_t history_channel_spans(const SensorHistory *h, SensorChannel ch, ChannelSpan spans[2]);
+size_t history_timestamp_spans(const SensorHistory *h, TimestampSpan spans[2]);
+
+// Copy the window of one channel into out[] (oldest first); returns count
+size_t history_copy_channel(const SensorHistory *h, SensorChannel ch, float *out);
+
+// Rolling statistics of one channel over the current window, O(1).
+// Returns 0 (and zeroes out) when the window is empty.
+int    history_stats(const SensorHistory *h, SensorChannel ch, ChannelStats *out);
+
+#endif
@@ -22,15 +22,99 @@
  * Author: Evara
  *
  * Features:
- *  - Dynamic circular buffer (user-defined size)
- *  - File logging (data_log.csv)
+ *  - Dynamic circular buffer (user-defined size), stored per channel
+ *    (sensor_history.h) so window analytics stream one channel at a time
+ *  - File logging (data_log.csv) through a buffered async log writer, with
+ *    a sparse time index beside it (data_log.csv.idx, time_index.h) for
+ *    tools/log_query range queries
  *  - Real-time alarm checks for over/under thresholds
+ *  - Readings are stamped in nanoseconds since the Unix epoch from the
+ *    calibrated TSC / vDSO timebase (firmware/inc/timebase.h)
+ *  - Pipeline: the sampling thread only generates readings and hands them
+ *    to the alarm, persistence and display stages through bounded SPSC
+ *    queues, so slow disk or terminal writes never stall sampling
+ *  - The alarm stage drains its queue in batches and runs them through the
+ *    alarm rule engine (alarm_rules.h): hysteresis, debounce and rate
+ *    limits, and only state transitions (RAISE/CLEAR) are reported
+ *
+ * Options:
+ *  --period-ms N   sampling period (default 1000)
+ *  --slow-disk MS  add MS of latency to every data_log.csv write, to show
+ *                  that sampling keeps its cadence while persistence lags
+ *  --sync SPEC     log durability: none (default), every:N records (samples
+ *                  for --format bin, which closes segments early to match),
+ *                  interval:MS
+ *  --format FMT    csv (default) writes data_log.csv; bin writes the
+ *                  compressed columnar data_log.bin (binlog.h), which
+ *                  tools/log2csv turns back into CSV; mmap writes CSV into
+ *                  preallocated rotating data_log.NNNNNN.csv segments
+ *                  (seg_log.h)
+ *  --segment SPEC  mmap segments: SIZE[k|m][,MAX_FILES[,ROTATE_SECONDS]]
+ *                  (default 16m,8)
+ *  --rules FILE    load alarm rules (see alarm_rules.conf); default is the
+ *                  TEMP/PRESS/FLOW limits below without hysteresis
+ *  --raw-alarms    old behaviour: report every sample over a limit, using
+ *                  the SIMD alarm kernel (firmware/inc/alarm_kernel.h)
+ *  --rollup        keep 1 s / 1 min / 1 h min/max/mean/count tiers
+ *                  (rollup.h) and write them to rollup_1s.NNNNNN.csv, ...
+ *  --history KB    keep every reading that fits in KB of RAM, block
+ *                  compressed (packed_history.h), and summarise it at exit
+ *  --bench N       headless load test (logger_bench.h): N readings, no
+ *                  prompts or terminal output, paced by --rate HZ (0 =
+ *                  unthrottled, the default) instead of --period-ms, with
+ *                  --buffer N as buffer size; prints a JSON summary with
+ *                  the readings each stage lost. Without --overflow the
+ *                  stages use block, so the load test measures what the
+ *                  pipeline sustains rather than how much it drops
+ *  --dashboard FPS show the buffer as a fixed screen region redrawn at
+ *                  most FPS times a second, only the changed rows
+ *                  (dashboard.h), instead of reprinting it every reading;
+ *                  alarms appear in its alarm line (and alarms_log.txt).
+ *                  At most 32 rows are shown: a larger buffer shows its
+ *                  newest 32 readings and the status line says so
+ *  --persist FILE[,N]  mirror the newest N readings (default 65536) into a
+ *                  crash-safe mmap'd ring file (persist_ring.h); on start
+ *                  an existing FILE is recovered and refills the buffer
+ *  --overflow [STAGE=]POLICY  what a full stage queue does with a new
+ *                  reading, for every stage or just alarms, persistence or
+ *                  display (policy_ring.h): newest (default, block under
+ *                  --bench) drops it,
+ *                  oldest evicts the oldest queued one, block[:MS] makes
+ *                  the sampler wait up to MS (default 100), decimate[:K]
+ *                  keeps every 2nd..Kth reading (default 8) once the queue
+ *                  is 3/4 full. While alarms or persistence are above that
+ *                  mark the sampler stops feeding the display stage
+ *  --seed N        seed of the signal simulator (sensor_sim.h: drift, sine,
+ *                  noise, spikes and step faults per channel); the same
+ *                  seed gives the same readings. Default: from the clock
  */
+#define _POSIX_C_SOURCE 200809L
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <pthread.h>
+
+#include "policy_ring.h"
+#include "sensor_data.h"
+#include "log_writer.h"
+#include "binlog.h"
+#include "seg_log.h"
+#include "sensor_csv.h"
+#include "alarm_kernel.h"
+#include "sensor_history.h"
+#include "alarm_rules.h"
+#include "time_index.h"
+#include "rollup.h"
+#include "packed_history.h"
+#include "logger_bench.h"
+#include "dashboard.h"
+#include "sensor_sim.h"
+#include "timebase.h"
+#include "persist_ring.h"
 
 // ===============================
 // --- Configuration Section -----
@@ -39,105 +123,191 @@
 #define PRESS_HIGH_LIMIT   9.0f   // bar
 #define FLOW_LOW_LIMIT    10.0f   // L/min
 
+// Pipeline queues between the sampling thread and each stage
+#define STAGE_QUEUE_SIZE  1024    // samples, power of two
+#define STAGE_BATCH       64      // max samples handed to a batch handler
+#define STAGE_WAKE_DEPTH  32      // unpaced: wake a sleeping stage at this depth
+
 // ANSI color codes for terminal highlighting
 #define RED     "\x1b[31m"
 #define YELLOW  "\x1b[33m"
+#define GREEN   "\x1b[32m"
 #define RESET   "\x1b[0m"
 
 // ===============================
 // --- Data Structures -----------
 // ===============================
 typedef struct {
-    float temperature;
-    float pressure;
-    float flow;
-    unsigned long timestamp;
-} SensorData;
-
-typedef struct {
-    SensorData *buffer;
-    int capacity;
-    int head;
-    int tail;
-    int count;
-    unsigned long overwrite_count;
+    SensorHistory hist;     // structure-of-arrays ring: window, head/tail, overwrite_count
 } CircularBuffer;
 
+// One pipeline stage: a consumer thread fed by its own SPSC queue
+typedef struct Stage {
+    const char *name;
+    void (*handle)(struct Stage *st, SensorData data);
+    void (*handle_batch)(struct Stage *st, const SensorData *data, size_t n); // optional
+    PolicyRing queue;             // overflow policy and per-cause counters
+    SensorData slots[STAGE_QUEUE_SIZE];
+    pthread_t thread;
+    pthread_mutex_t lock;         // an idle stage sleeps on wake until a push
+    pthread_cond_t wake;
+    int sleeping;                 // atomic: the stage is (about to be) waiting
+
+    // Statistics (written by the stage thread, read after join)
+    unsigned long processed;
+    double busy_s;
+    double end_s;                 // when the stage drained its queue
+    // Statistics (written by the sampling thread)
+    int pressure;                 // queue above its high watermark
+    unsigned long shed;           // not offered: another stage was under pressure
+    size_t max_depth;
+    unsigned long long depth_sum; // sum of depths seen at each push
+} Stage;
+
+enum { ST_ALARM, ST_PERSIST, ST_DISPLAY };
+static const char *const stage_names[] = { "alarms", "persistence", "display" };
+
 // ===============================
 // --- Function Prototypes -------
 // ===============================
 int initBuffer(CircularBuffer *cb, int capacity);
 void freeBuffer(CircularBuffer *cb);
 void addReading(CircularBuffer *cb, SensorData data);
-void printBuffer(const CircularBuffer *cb);
+void printBuffer(CircularBuffer *cb);
+int bufferStats(CircularBuffer *cb, SensorChannel ch, ChannelStats *out);
+void printWindowStats(CircularBuffer *cb);
 SensorData generateSensorData(void);
 void logToFile(SensorData data);
 void checkAlarms(SensorData data); // <--- NEW
+void checkAlarmsBatch(const SensorData *data, size_t n);
 
 // ===============================
 // --- Function Implementations ---
 // ===============================
 int initBuffer(CircularBuffer *cb, int capacity) {
-    cb->buffer = (SensorData *)malloc(capacity * sizeof(SensorData));
-    if (!cb->buffer) {
+    if (capacity <= 0) {
+        fprintf(stderr, "Error: Buffer size must be positive.\n");
+        return 0;
+    }
+    if (!history_init(&cb->hist, (size_t)capacity, (double)TIMEBASE_NS_PER_S)) {
         fprintf(stderr, "Error: Memory allocation failed.\n");
         return 0;
     }
-    cb->capacity = capacity;
-    cb->head = cb->tail = cb->count = 0;
-    cb->overwrite_count = 0;
     return 1;
 }
 
 void freeBuffer(CircularBuffer *cb) {
-    if (cb->buffer) free(cb->buffer);
+    history_free(&cb->hist);
 }
 
 void addReading(CircularBuffer *cb, SensorData data) {
-    cb->buffer[cb->head] = data;
-    cb->head = (cb->head + 1) % cb->capacity;
-
-    if (cb->count < cb->capacity)
-        cb->count++;
-    else {
-        cb->tail = (cb->tail + 1) % cb->capacity;
-        cb->overwrite_count++;
-    }
+    // Buffer full — the history drops the oldest reading and counts it
+    history_push(&cb->hist, &data);
 }
 
-void printBuffer(const CircularBuffer *cb) {
+void printBuffer(CircularBuffer *cb) {
+    size_t count = history_count(&cb->hist);
+
     printf("\n========================================\n");
-    printf("BUFFER STATUS: %d/%d filled | Overwrites: %lu\n",
-           cb->count, cb->capacity, cb->overwrite_count);
+    printf("BUFFER STATUS: %zu/%zu filled | Overwrites: %lu\n",
+           count, cb->hist.window, cb->hist.overwrite_count);
     printf("----------------------------------------\n");
     printf("Idx | Temp (°C) | Press (bar) | Flow (L/min) | Timestamp\n");
     printf("----------------------------------------\n");
 
-    int index = cb->tail;
-    for (int i = 0; i < cb->count; i++) {
-        SensorData d = cb->buffer[index];
-        printf("%3d | %9.2f | %10.2f | %12.2f | %lu\n",
+    SensorData d;
+    for (size_t i = 0; history_get(&cb->hist, i, &d); i++) {
+        printf("%3zu | %9.2f | %10.2f | %12.2f | %" PRIu64 "\n",
                i + 1, d.temperature, d.pressure, d.flow, d.timestamp);
-        index = (index + 1) % cb->capacity;
     }
+    printWindowStats(cb);
     printf("========================================\n");
 }
 
+// Rolling statistics kept by the buffer itself: O(1) whatever the window size
+int bufferStats(CircularBuffer *cb, SensorChannel ch, ChannelStats *out) {
+    return history_stats(&cb->hist, ch, out);
+}
+
+void printWindowStats(CircularBuffer *cb) {
+    static const char *names[SENSOR_CHANNELS] = { "Temp", "Press", "Flow" };
+    ChannelStats st;
+
+    printf("----------------------------------------\n");
+    printf("Stat  |     Mean |  Variance |      Min |      Max |   Rate/s\n");
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        if (!bufferStats(cb, (SensorChannel)c, &st)) continue;
+        printf("%-5s | %8.2f | %9.2f | %8.2f | %8.2f | %8.2f\n",
+               names[c], st.mean, st.variance, st.min, st.max, st.rate_per_s);
+    }
+}
+
+// Simulated plant (sensor_sim.h), advanced at the sampling rate
+static SensorSim sim;
+
 SensorData generateSensorData(void) {
-    SensorData d;
-    d.temperature = 20.0f + (rand() % 800) / 10.0f; // 20–100°C
-    d.pressure    = 1.0f + (rand() % 90) / 10.0f;   // 1–10 bar
-    d.flow        = (rand() % 1000) / 10.0f;        // 0–100 L/min
-    d.timestamp   = (unsigned long)time(NULL);
+    SensorData d = sensor_sim_next(&sim);   // 20–100°C, 1–10 bar, 0–100 L/min
+    d.timestamp = timebase_wall_ns();
     return d;
 }
 
+// --bench / --dashboard: no per-reading terminal output from the stages
+static LoggerBench bench;
+static int quiet = 0;
+static unsigned long alarms_raised = 0;   // written by the alarm stage, atomically
+
+// Log files stay open for the whole run (see log_writer.h)
+static LogWriter data_log;
+static LogWriter alarm_log;
+static BinlogWriter data_bin;
+static SegLog data_seg;
+static TimeIndexWriter data_idx;   // data_log.csv.idx, CSV format only
+static enum { FORMAT_CSV, FORMAT_BIN, FORMAT_MMAP } data_format = FORMAT_CSV;
+
+#define CSV_HEADER "Temperature (°C),Pressure (bar),Flow (L/min),Timestamp\n"
+
 void logToFile(SensorData data) {
-    FILE *file = fopen("data_log.csv", "a");
-    if (!file) return;
-    fprintf(file, "%.2f,%.2f,%.2f,%lu\n",
-            data.temperature, data.pressure, data.flow, data.timestamp);
-    fclose(file);
+    char row[SENSOR_CSV_MAX_ROW];
+
+    switch (data_format) {
+    case FORMAT_BIN:
+        binlog_append(&data_bin, &data);
+        break;
+    case FORMAT_MMAP:
+        seg_log_write(&data_seg, row, sensor_csv_row(row, &data));
+        break;
+    default: {
+        // same bytes as "%.2f,%.2f,%.2f,%" PRIu64 "\n", without printf (sensor_csv.h)
+        size_t len = sensor_csv_row(row, &data);
+        log_writer_write(&data_log, row, len);
+        time_index_add(&data_idx, data.timestamp, len);
+        break;
+    }
+    }
+}
+
+static const AlarmLimits alarm_limits = { TEMP_HIGH_LIMIT, PRESS_HIGH_LIMIT, FLOW_LOW_LIMIT };
+
+// Print and log the alarms flagged in mask (ALARM_* bits)
+static void emitAlarms(SensorData data, unsigned mask) {
+    unsigned long n = ((mask & ALARM_TEMP_HIGH) != 0) + ((mask & ALARM_PRESS_HIGH) != 0) +
+                      ((mask & ALARM_FLOW_LOW) != 0);
+    __atomic_fetch_add(&alarms_raised, n, __ATOMIC_RELAXED);
+
+    if (mask & ALARM_TEMP_HIGH) {
+        if (!quiet) printf(RED "⚠️  HIGH TEMP ALARM: %.2f °C\n" RESET, data.temperature);
+        log_writer_printf(&alarm_log, "High Temp Alarm: %.2f °C at %" PRIu64 "\n", data.temperature, data.timestamp);
+    }
+
+    if (mask & ALARM_PRESS_HIGH) {
+        if (!quiet) printf(RED "⚠️  HIGH PRESSURE ALARM: %.2f bar\n" RESET, data.pressure);
+        log_writer_printf(&alarm_log, "High Pressure Alarm: %.2f bar at %" PRIu64 "\n", data.pressure, data.timestamp);
+    }
+
+    if (mask & ALARM_FLOW_LOW) {
+        if (!quiet) printf(YELLOW "⚠️  LOW FLOW WARNING: %.2f L/min\n" RESET, data.flow);
+        log_writer_printf(&alarm_log, "Low Flow Warning: %.2f L/min at %" PRIu64 "\n", data.flow, data.timestamp);
+    }
 }
 
 /*
@@ -146,65 +316,662 @@ void logToFile(SensorData data) {
  *   Prints warning and logs to 'alarms_log.txt' if triggered.
  */
 void checkAlarms(SensorData data) {
-    FILE *file = fopen("alarms_log.txt", "a");
-    if (!file) return;
+    uint8_t mask;
+    alarm_eval_scalar(&alarm_limits, &data.temperature, &data.pressure, &data.flow, 1, &mask);
+    if (mask) emitAlarms(data, mask);
+}
+
+/*
+ * checkAlarmsBatch:
+ *   Same as checkAlarms for up to STAGE_BATCH samples: the readings are
+ *   split into per-channel arrays, evaluated by the vectorised kernel, and
+ *   only the samples with a non-zero mask are printed/logged.
+ */
+void checkAlarmsBatch(const SensorData *data, size_t n) {
+    float temp[STAGE_BATCH], press[STAGE_BATCH], flow[STAGE_BATCH];
+    uint8_t mask[STAGE_BATCH];
+
+    while (n > 0) {
+        size_t k = n < STAGE_BATCH ? n : STAGE_BATCH;
+        for (size_t i = 0; i < k; i++) {
+            temp[i] = data[i].temperature;
+            press[i] = data[i].pressure;
+            flow[i] = data[i].flow;
+        }
+        if (alarm_eval(&alarm_limits, temp, press, flow, k, mask)) {
+            for (size_t i = 0; i < k; i++)
+                if (mask[i]) emitAlarms(data[i], mask[i]);
+        }
+        data += k;
+        n -= k;
+    }
+}
+
+/*
+ * Rule engine path: alarms are stateful, so only transitions are printed
+ * and logged instead of every sample over the limit.
+ */
+static AlarmRules alarm_rules;
+static int raw_alarms = 0;
+
+static void emitRuleEvent(const AlarmEvent *ev) {
+    int r = ev->rule;
+    const char *channel = alarm_rules_channel_name(alarm_rules.channel[r]);
+    const char *op = alarm_rules_op_name((RuleOp)alarm_rules.op[r]);
+
+    if (ev->type == ALARM_EVENT_RAISE) {
+        __atomic_fetch_add(&alarms_raised, 1, __ATOMIC_RELAXED);
+        if (!quiet)
+            printf(RED "⚠️  ALARM %s: %s %.2f %s %.2f\n" RESET,
+                   alarm_rules.name[r], channel, ev->value, op, alarm_rules.threshold[r]);
+        log_writer_printf(&alarm_log, "RAISED %s: %s %.2f %s %.2f at %" PRIu64 "\n",
+                          alarm_rules.name[r], channel, ev->value, op, alarm_rules.threshold[r],
+                          ev->timestamp);
+    } else {
+        if (!quiet) printf(GREEN "✔  CLEARED %s: %s %.2f\n" RESET, alarm_rules.name[r], channel, ev->value);
+        log_writer_printf(&alarm_log, "CLEARED %s: %s %.2f at %" PRIu64 "\n",
+                          alarm_rules.name[r], channel, ev->value, ev->timestamp);
+    }
+}
+
+void evaluateRules(const SensorData *data, size_t n) {
+    AlarmEvent events[STAGE_BATCH * 2];
+    while (n > 0) {
+        size_t k = n < STAGE_BATCH ? n : STAGE_BATCH;
+        size_t nev = alarm_rules_eval(&alarm_rules, data, k, events, STAGE_BATCH * 2);
+        for (size_t e = 0; e < nev; e++) emitRuleEvent(&events[e]);
+        data += k;
+        n -= k;
+    }
+}
+
+static void printRuleReport(void) {
+    printf("\n========================================\n");
+    printf("ALARM RULES\n");
+    printf("----------------------------------------\n");
+    printf("Rule             | Condition            | Hyst  | Raised | Muted | Cleared | State\n");
+    for (size_t r = 0; r < alarm_rules.count; r++) {
+        static const char *states[] = { "clear", "pending", "ACTIVE" };
+        char cond[32];
+        snprintf(cond, sizeof(cond), "%s %s %.2f", alarm_rules_channel_name(alarm_rules.channel[r]),
+                 alarm_rules_op_name((RuleOp)alarm_rules.op[r]), alarm_rules.threshold[r]);
+        printf("%-16s | %-20s | %5.2f | %6lu | %5lu | %7lu | %s\n",
+               alarm_rules.name[r], cond, alarm_rules.hysteresis[r], alarm_rules.raised[r],
+               alarm_rules.suppressed[r], alarm_rules.cleared[r], states[alarm_rules.state[r]]);
+    }
+    if (alarm_rules.events_dropped)
+        printf("Events dropped: %lu\n", alarm_rules.events_dropped);
+    printf("========================================\n");
+}
+
+// ===============================
+// --- Pipeline Section ----------
+// ===============================
+static CircularBuffer display_cb;         // owned by the display stage
+static unsigned int slow_disk_ms = 0;
+static volatile int sampling_done = 0;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void sleep_ms(unsigned int ms) {
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// Long-term retention tiers, fed by the persistence stage (--rollup)
+static Rollup rollup;
+static int rollup_enabled = 0;
+
+// Compressed in-memory history of every reading (--history)
+static PackedHistory packed;
+static uint8_t *packed_arena = NULL;
+
+// --persist: crash-safe copy of the newest readings, written by the persistence stage
+static PersistRing persist;
+static const char *persist_path = NULL;
+
+static void persistStage(Stage *st, SensorData data) {
+    (void)st;
+    if (slow_disk_ms) sleep_ms(slow_disk_ms);   // simulated slow disk
+    logToFile(data);
+    if (rollup_enabled) rollup_add(&rollup, &data);
+    if (packed_arena) packed_history_push(&packed, &data);
+    if (persist_path) persist_ring_push(&persist, &data);
+}
 
-    if (data.temperature > TEMP_HIGH_LIMIT) {
-        printf(RED "⚠️  HIGH TEMP ALARM: %.2f °C\n" RESET, data.temperature);
-        fprintf(file, "High Temp Alarm: %.2f °C at %lu\n", data.temperature, data.timestamp);
+// What the history still holds, decoded on the fly
+static void printHistoryReport(void) {
+    PackedHistoryIter it;
+    SensorData d, first, last;
+    float tmin = 0.0f, tmax = 0.0f;
+    size_t n = 0;
+    packed_history_iter_begin(&packed, &it);
+    while (packed_history_next(&it, &d)) {
+        if (n == 0) first = d;
+        if (n == 0 || d.temperature < tmin) tmin = d.temperature;
+        if (n == 0 || d.temperature > tmax) tmax = d.temperature;
+        last = d;
+        n++;
     }
+    printf("\nPacked history: %zu of %llu readings in %zu KiB (%.2f B/reading packed, %.1fx a SensorData ring)\n",
+           n, packed.pushed, packed.arena_bytes / 1024,
+           packed.held ? (double)packed_history_bytes(&packed) / (double)packed.held : 0.0,
+           (double)n / (double)(packed.arena_bytes / sizeof(SensorData)));
+    if (n) printf("Covers %" PRIu64 "..%" PRIu64 " | temp %.2f..%.2f\n", first.timestamp, last.timestamp, tmin, tmax);
+}
+
+// Tier sizes and the whole run summarised from the coarsest usable tier
+static void printRollupReport(void) {
+    rollup_flush(&rollup);
+    printf("\nRollup: %lu samples ->", rollup.samples);
+    for (int t = 0; t < ROLLUP_TIERS; t++)
+        printf(" %s: %zu rows%s", rollup_tier_name(t), rollup_count(&rollup, t),
+               t + 1 < ROLLUP_TIERS ? "," : "\n");
+
+    const RollupTier *sec = &rollup.tier[ROLLUP_1S];
+    if (rollup_count(&rollup, ROLLUP_1S) == 0) return;
+    uint64_t from = sec->ring[(sec->head - rollup_count(&rollup, ROLLUP_1S)) % sec->capacity].start;
+    uint64_t to = sec->ring[(sec->head - 1) % sec->capacity].start;
+    int tier = rollup_pick_tier(&rollup, from, to, 1000);
+    RollupRow rows[1000], total;
+    size_t n = rollup_query(&rollup, tier, from, to, rows, 1000);
+    memset(&total, 0, sizeof(total));
+    for (size_t i = 0; i < n; i++) rollup_merge(&total, &rows[i]);
+    printf("From %zu %s rows: %u samples | temp %.2f..%.2f mean %.2f | press %.2f..%.2f mean %.2f"
+           " | flow %.2f..%.2f mean %.2f\n", n, rollup_tier_name(tier), total.count,
+           total.min[0], total.max[0], total.mean[0], total.min[1], total.max[1], total.mean[1],
+           total.min[2], total.max[2], total.mean[2]);
+}
+
+static void alarmStage(Stage *st, SensorData data) {
+    (void)st;
+    checkAlarms(data);
+}
+
+static void alarmBatchStage(Stage *st, const SensorData *data, size_t n) {
+    (void)st;
+    if (raw_alarms) checkAlarmsBatch(data, n);
+    else evaluateRules(data, n);
+}
+
+// Live view (--dashboard): owned by the display stage, then by main after join
+static Dashboard dash;
+static int dashboard_enabled = 0;
+static double dashboard_fps = 0.0;
+
+// Refresh the panel and draw a frame if one is due; stats only when drawing
+static void updateDashboard(int force) {
+    double now = now_s();
+    if (!force && !dashboard_due(&dash, now)) return;
 
-    if (data.pressure > PRESS_HIGH_LIMIT) {
-        printf(RED "⚠️  HIGH PRESSURE ALARM: %.2f bar\n" RESET, data.pressure);
-        fprintf(file, "High Pressure Alarm: %.2f bar at %lu\n", data.pressure, data.timestamp);
+    ChannelStats st;
+    for (int c = 0; c < SENSOR_CHANNELS; c++)
+        if (bufferStats(&display_cb, (SensorChannel)c, &st)) dashboard_stats(&dash, (SensorChannel)c, &st);
+    char shown[32] = "";
+    if ((size_t)dash.rows < display_cb.hist.window)
+        snprintf(shown, sizeof(shown), " | Showing newest %d", dash.rows);
+    dashboard_status(&dash, "%zu/%zu filled | Overwrites: %lu | Readings: %lu%s",
+                     history_count(&display_cb.hist), display_cb.hist.window,
+                     display_cb.hist.overwrite_count, dash.seq, shown);
+
+    // rule states are written by the alarm stage; a slightly stale view is fine
+    char active[DASHBOARD_COLS] = "";
+    size_t len = 0;
+    for (size_t r = 0; !raw_alarms && r < alarm_rules.count && len + 20 < sizeof(active); r++) {
+        if (__atomic_load_n(&alarm_rules.state[r], __ATOMIC_RELAXED) == RULE_ACTIVE)
+            len += (size_t)snprintf(active + len, sizeof(active) - len, "%s%.16s",
+                                    len ? ", " : "", alarm_rules.name[r]);
     }
+    dashboard_alarms(&dash, "%lu raised%s%s", __atomic_load_n(&alarms_raised, __ATOMIC_RELAXED),
+                     len ? " | ACTIVE: " : "", active);
+    dashboard_render(&dash, now, force);
+}
 
-    if (data.flow < FLOW_LOW_LIMIT) {
-        printf(YELLOW "⚠️  LOW FLOW WARNING: %.2f L/min\n" RESET, data.flow);
-        fprintf(file, "Low Flow Warning: %.2f L/min at %lu\n", data.flow, data.timestamp);
+static void displayStage(Stage *st, SensorData data) {
+    (void)st;
+    addReading(&display_cb, data);
+    if (dashboard_enabled) {
+        dashboard_push(&dash, &data);
+        updateDashboard(0);
+    } else if (!quiet) {
+        printBuffer(&display_cb);
     }
+}
 
-    fclose(file);
+// Sleep until the sampler wakes the stage. sleeping is published before the
+// queue is checked again and the sampler checks sleeping after its push
+// (both behind full fences), so a wake is never lost. The sampler wakes a
+// stage after each reading when paced, and once STAGE_WAKE_DEPTH readings
+// are queued when unthrottled, so a busy pipeline does not pay a wakeup
+// per sample. The timeout is a backstop.
+static void stageIdle(Stage *st) {
+    struct timespec until;
+    pthread_mutex_lock(&st->lock);
+    __atomic_store_n(&st->sleeping, 1, __ATOMIC_SEQ_CST);
+    if (policy_ring_count(&st->queue) == 0 && !__atomic_load_n(&sampling_done, __ATOMIC_SEQ_CST)) {
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += 10000000L;   // 10 ms
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&st->wake, &st->lock, &until);
+    }
+    __atomic_store_n(&st->sleeping, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&st->lock);
+}
+
+static void wakeStage(Stage *st) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&st->sleeping, __ATOMIC_RELAXED)) return;
+    pthread_mutex_lock(&st->lock);
+    pthread_cond_signal(&st->wake);
+    pthread_mutex_unlock(&st->lock);
+}
+
+static void *stageThread(void *arg) {
+    Stage *st = (Stage *)arg;
+    SensorData batch[STAGE_BATCH];
+
+    for (;;) {
+        size_t n = policy_ring_pop_batch(&st->queue, batch, st->handle_batch ? STAGE_BATCH : 1);
+        if (n > 0) {
+            double t0 = now_s();
+            if (st->handle_batch) st->handle_batch(st, batch, n);
+            else st->handle(st, batch[0]);
+            st->busy_s += now_s() - t0;
+            st->processed += n;
+        } else if (__atomic_load_n(&sampling_done, __ATOMIC_ACQUIRE)) {
+            if (policy_ring_count(&st->queue) == 0) break;   // drained
+        } else {
+            stageIdle(st);
+        }
+    }
+    st->end_s = now_s();
+    return NULL;
+}
+
+// High watermark crossings, called from the sampling thread
+static void stagePressure(void *ctx, int high, size_t fill) {
+    (void)fill;
+    ((Stage *)ctx)->pressure = high;
+}
+
+static int startStage(Stage *st, const char *name, void (*handle)(Stage *, SensorData),
+                      void (*handle_batch)(Stage *, const SensorData *, size_t),
+                      const PolicyRingConfig *overflow) {
+    PolicyRingConfig cfg = *overflow;
+    memset(st, 0, sizeof(*st));
+    st->name = name;
+    st->handle = handle;
+    st->handle_batch = handle_batch;
+    cfg.on_watermark = stagePressure;
+    cfg.ctx = st;
+    policy_ring_init(&st->queue, st->slots, STAGE_QUEUE_SIZE, sizeof(SensorData), &cfg);
+    pthread_mutex_init(&st->lock, NULL);
+    pthread_cond_init(&st->wake, NULL);
+    return pthread_create(&st->thread, NULL, stageThread, st) == 0;
+}
+
+// Hand a sample to a stage; only the block policy can make the sampler wait
+static void feedStage(Stage *st, SensorData data) {
+    size_t depth = policy_ring_count(&st->queue);
+    if (depth > st->max_depth) st->max_depth = depth;
+    st->depth_sum += depth;
+    policy_ring_push(&st->queue, &data);
+    if (depth + 1 >= STAGE_WAKE_DEPTH) wakeStage(st);
+}
+
+static void printPipelineReport(Stage *stages, int nstages, unsigned long samples,
+                                double start, double elapsed, unsigned int period_ms,
+                                double mean_interval_ms, double max_late_ms) {
+    printf("\n========================================\n");
+    printf("PIPELINE REPORT: %lu samples in %.2f s (target period %u ms)\n",
+           samples, elapsed, period_ms);
+    printf("----------------------------------------\n");
+    printf("Stage       | Processed |  Items/s | Busy %% | Avg depth | Max depth |    Lost\n");
+    printf("sampling    | %9lu | %8.1f |      - |         - |         - |       -\n",
+           samples, elapsed > 0 ? samples / elapsed : 0.0);
+    for (int i = 0; i < nstages; i++) {
+        Stage *st = &stages[i];
+        double span = st->end_s - start;
+        printf("%-11s | %9lu | %8.1f | %6.1f | %9.1f | %9zu | %7llu\n",
+               st->name, st->processed,
+               span > 0 ? st->processed / span : 0.0,
+               span > 0 ? 100.0 * st->busy_s / span : 0.0,
+               samples ? (double)st->depth_sum / samples : 0.0,
+               st->max_depth, policy_ring_lost(&st->queue));
+    }
+    printf("----------------------------------------\n");
+    printf("Overflow    | Policy   | Newest | Oldest | Decimated | Timeouts | Blocked | Wait ms | High | Shed\n");
+    for (int i = 0; i < nstages; i++) {
+        const PolicyRingStats *ps = &stages[i].queue.stats;
+        printf("%-11s | %-8s | %6llu | %6llu | %9llu | %8llu | %7llu | %7.1f | %4lu | %4lu\n",
+               stages[i].name, policy_ring_name(stages[i].queue.cfg.policy), ps->dropped_newest,
+               ps->dropped_oldest, ps->decimated, ps->timeouts, ps->blocked, (double)ps->wait_ns / 1e6,
+               ps->high_events, stages[i].shed);
+    }
+    printf("----------------------------------------\n");
+    printf("Sampling cadence: mean interval %.3f ms | max lateness %.3f ms\n",
+           mean_interval_ms, max_late_ms);
+    printf("========================================\n");
+}
+
+// --overflow [STAGE=]POLICY: one stage's queue, or all three
+static int parseOverflow(PolicyRingConfig *overflow, const char *spec) {
+    const char *eq = strchr(spec, '=');
+    for (int k = 0; k < 3; k++) {
+        if (!eq) {
+            if (policy_ring_parse(&overflow[k], spec) != 0) return -1;
+        } else if (strlen(stage_names[k]) == (size_t)(eq - spec) &&
+                   strncmp(spec, stage_names[k], (size_t)(eq - spec)) == 0) {
+            return policy_ring_parse(&overflow[k], eq + 1);
+        }
+    }
+    return eq ? -1 : 0;
+}
+
+// Reopen the ring and put its newest readings back into the buffer
+static int recoverPersistRing(const PersistRingConfig *cfg, int buffer_size) {
+    if (persist_ring_open(&persist, persist_path, cfg) != 0) {
+        fprintf(stderr, "Error: cannot open persistent ring '%s' (not a ring file?).\n", persist_path);
+        return 0;
+    }
+    size_t n = persist_ring_count(&persist), first = n > (size_t)buffer_size ? n - (size_t)buffer_size : 0;
+    size_t restored = 0;
+    for (size_t i = first; i < n; i++) {
+        SensorData d;
+        if (persist_ring_get(&persist, i, &d) == 0) {
+            addReading(&display_cb, d);
+            if (dashboard_enabled) dashboard_push(&dash, &d);
+            restored++;
+        }
+    }
+    if (persist.recovered && !quiet)
+        printf("Recovered %zu readings from '%s' in %.3f ms (%llu past the checkpoint%s), "
+               "%zu back in the buffer\n", n, persist_path, (double)persist.recover_ns / 1e6,
+               (unsigned long long)persist.rolled_forward,
+               persist.rebuilt ? ", headers rebuilt" : persist.torn ? ", torn tail dropped" : "",
+               restored);
+    return 1;
 }
 
 // ===============================
 // --- Main Function -------------
 // ===============================
-int main(void) {
-    srand((unsigned int)time(NULL));
-    CircularBuffer cb;
+int main(int argc, char *argv[]) {
     int buffer_size, total_readings;
+    unsigned int period_ms = 1000;
+    const char *rules_path = NULL;
+    uint64_t seed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+    PersistRingConfig persist_cfg;
+    persist_ring_default_config(&persist_cfg);
+    PolicyRingConfig overflow[3];
+    for (int k = 0; k < 3; k++) policy_ring_default_config(&overflow[k]);
+    int overflow_set = 0;
+    LogWriterConfig log_cfg;
+    SegLogConfig seg_cfg;
+    log_writer_default_config(&log_cfg);
+    seg_log_default_config(&seg_cfg);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--period-ms") == 0 && i + 1 < argc) {
+            period_ms = (unsigned int)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--slow-disk") == 0 && i + 1 < argc) {
+            slow_disk_ms = (unsigned int)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sync") == 0 && i + 1 < argc &&
+                   log_writer_parse_sync(&log_cfg, argv[i + 1]) == 0) {
+            i++;
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc &&
+                   (strcmp(argv[i + 1], "csv") == 0 || strcmp(argv[i + 1], "bin") == 0 ||
+                    strcmp(argv[i + 1], "mmap") == 0)) {
+            i++;
+            data_format = strcmp(argv[i], "bin") == 0  ? FORMAT_BIN
+                        : strcmp(argv[i], "mmap") == 0 ? FORMAT_MMAP : FORMAT_CSV;
+        } else if (strcmp(argv[i], "--segment") == 0 && i + 1 < argc &&
+                   seg_log_parse(&seg_cfg, argv[i + 1]) == 0) {
+            i++;
+        } else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) {
+            rules_path = argv[++i];
+        } else if (strcmp(argv[i], "--raw-alarms") == 0) {
+            raw_alarms = 1;
+        } else if (strcmp(argv[i], "--rollup") == 0) {
+            rollup_enabled = 1;
+        } else if (strcmp(argv[i], "--history") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            size_t bytes = (size_t)atoi(argv[++i]) * 1024;
+            packed_arena = malloc(bytes);
+            if (!packed_arena || packed_history_init(&packed, packed_arena, bytes) != 0) {
+                fprintf(stderr, "Error: --history needs at least %zu KiB.\n",
+                        (packed_history_min_arena() + 1023) / 1024);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--dashboard") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            dashboard_fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--persist") == 0 && i + 1 < argc) {
+            static char persist_buf[256];
+            snprintf(persist_buf, sizeof(persist_buf), "%s", argv[++i]);
+            char *comma = strrchr(persist_buf, ',');
+            if (comma) {
+                *comma = '\0';
+                persist_cfg.capacity = (size_t)strtoul(comma + 1, NULL, 10);
+            }
+            persist_path = persist_buf;
+        } else if (strcmp(argv[i], "--overflow") == 0 && i + 1 < argc &&
+                   parseOverflow(overflow, argv[i + 1]) == 0) {
+            overflow_set = 1;
+            i++;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (logger_bench_arg(&bench, argc, argv, &i) != 1) {
+            fprintf(stderr, "Usage: %s [--period-ms N] [--slow-disk MS] [--sync none|every:N|interval:MS]\n"
+                            "          [--format csv|bin|mmap] [--segment SIZE[,MAX[,SECONDS]]]\n"
+                            "          [--rules FILE | --raw-alarms] [--rollup] [--history KB]\n"
+                            "          [--dashboard FPS (shows at most %d rows)]\n"
+                            "          [--persist FILE[,N]] [--overflow [STAGE=]newest|oldest|block[:MS]|decimate[:K]]\n"
+                            "          [--seed N] %s\n",
+                    argv[0], DASHBOARD_MAX_ROWS, logger_bench_usage());
+            return EXIT_FAILURE;
+        }
+    }
 
-    printf("Enter circular buffer size: ");
-    scanf("%d", &buffer_size);
-    printf("Enter number of readings to simulate: ");
-    scanf("%d", &total_readings);
+    // SensorData.timestamp counts nanoseconds since the Unix epoch
+    timebase_init(TIMEBASE_AUTO);
+    alarm_rules_init(&alarm_rules, (double)TIMEBASE_NS_PER_S);
+    if (rules_path) {
+        char err[256];
+        if (alarm_rules_load(&alarm_rules, rules_path, err, sizeof(err)) != 0) {
+            fprintf(stderr, "Error: %s\n", err);
+            return EXIT_FAILURE;
+        }
+    } else {
+        alarm_rules_add(&alarm_rules, "high_temp", SENSOR_CH_TEMPERATURE, RULE_GT, TEMP_HIGH_LIMIT, 0, 0, 0);
+        alarm_rules_add(&alarm_rules, "high_press", SENSOR_CH_PRESSURE, RULE_GT, PRESS_HIGH_LIMIT, 0, 0, 0);
+        alarm_rules_add(&alarm_rules, "low_flow", SENSOR_CH_FLOW, RULE_LT, FLOW_LOW_LIMIT, 0, 0, 0);
+    }
+
+    if (bench.enabled) {
+        quiet = 1;
+        buffer_size = bench.buffer = bench.buffer ? bench.buffer : LOGGER_BENCH_DEFAULT_BUFFER;
+        total_readings = (int)bench.count;
+        for (int k = 0; !overflow_set && k < 3; k++) policy_ring_parse(&overflow[k], "block");
+    } else {
+        printf("Enter circular buffer size: ");
+        scanf("%d", &buffer_size);
+        printf("Enter number of readings to simulate: ");
+        scanf("%d", &total_readings);
+    }
 
-    if (!initBuffer(&cb, buffer_size))
+    if (!initBuffer(&display_cb, buffer_size))
+        return EXIT_FAILURE;
+    if (dashboard_fps > 0 && !bench.enabled) {   // bench mode keeps stdout for its summary
+        dashboard_enabled = quiet = 1;
+        dashboard_init(&dash, STDOUT_FILENO, buffer_size, dashboard_fps);
+        fflush(stdout);                              // prompts before the first frame
+    }
+    if (persist_path && !recoverPersistRing(&persist_cfg, buffer_size))
         return EXIT_FAILURE;
 
+    // The simulated plant advances one nominal sampling period per reading
+    SimConfig sim_cfg;
+    sensor_sim_default_config(&sim_cfg);
+    sim_cfg.rate_hz = bench.enabled && bench.rate_hz > 0 ? bench.rate_hz
+                                                         : 1000.0 / (period_ms ? period_ms : 1);
+    sensor_sim_init(&sim, &sim_cfg, seed);
+
     // Prepare log files
-    FILE *datafile = fopen("data_log.csv", "w");
-    fprintf(datafile, "Temperature (°C),Pressure (bar),Flow (L/min),Timestamp\n");
-    fclose(datafile);
+    const char *data_path = data_format == FORMAT_BIN  ? "data_log.bin"
+                          : data_format == FORMAT_MMAP ? "data_log.NNNNNN.csv" : "data_log.csv";
+    int data_ok;
+    if (data_format == FORMAT_BIN) {
+        data_ok = binlog_open(&data_bin, data_path, 0, BINLOG_TICK_NS, &log_cfg) == 0;
+    } else if (data_format == FORMAT_MMAP) {
+        seg_cfg.header = CSV_HEADER;   // every segment is a standalone CSV file
+        data_ok = seg_log_open(&data_seg, "data_log", "csv", &seg_cfg) == 0;
+    } else {
+        data_ok = log_writer_open(&data_log, data_path, 1, &log_cfg) == 0 &&
+                  time_index_open(&data_idx, "data_log.csv.idx", sizeof(CSV_HEADER) - 1, 0) == 0;
+        if (data_ok) log_writer_printf(&data_log, CSV_HEADER);
+    }
+    if (!data_ok || log_writer_open(&alarm_log, "alarms_log.txt", 1, &log_cfg) != 0) {
+        fprintf(stderr, "Error: cannot open log files.\n");
+        return EXIT_FAILURE;
+    }
+    log_writer_printf(&alarm_log, "=== Alarm Log ===\n");
 
-    FILE *alarmfile = fopen("alarms_log.txt", "w");
-    fprintf(alarmfile, "=== Alarm Log ===\n");
-    fclose(alarmfile);
+    if (!quiet) printf("\nStarting Sensor Data Simulation...\n");
 
-    printf("\nStarting Sensor Data Simulation...\n");
+    // Stages are large (queue storage inline), keep them off the stack
+    static Stage stages[3];
+    if (rollup_enabled) {
+        RollupConfig rollup_cfg;
+        rollup_default_config(&rollup_cfg);
+        rollup_cfg.disk_base = "rollup";
+        if (rollup_init(&rollup, (double)TIMEBASE_NS_PER_S, &rollup_cfg) != 0) {
+            fprintf(stderr, "Error: cannot open rollup segments.\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!startStage(&stages[ST_ALARM], stage_names[ST_ALARM], alarmStage, alarmBatchStage, &overflow[ST_ALARM]) ||
+        !startStage(&stages[ST_PERSIST], stage_names[ST_PERSIST], persistStage, NULL, &overflow[ST_PERSIST]) ||
+        !startStage(&stages[ST_DISPLAY], stage_names[ST_DISPLAY], displayStage, NULL, &overflow[ST_DISPLAY])) {
+        fprintf(stderr, "Error: cannot start pipeline threads.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Sampling stage: absolute deadlines so slow stages cannot shift it
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    double start = now_s(), prev = start, interval_sum = 0.0, max_late = 0.0;
+    if (bench.enabled) logger_bench_start(&bench);
 
     for (int i = 0; i < total_readings; i++) {
+        if (bench.enabled) {
+            logger_bench_pace(&bench);
+        } else if (i > 0) {
+            long ns = next.tv_nsec + (long)(period_ms % 1000) * 1000000L;
+            next.tv_sec += (time_t)(period_ms / 1000) + ns / 1000000000L;
+            next.tv_nsec = ns % 1000000000L;
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+            double t = now_s();
+            double deadline = (double)next.tv_sec + (double)next.tv_nsec / 1e9;
+            if (t - deadline > max_late) max_late = t - deadline;
+            interval_sum += t - prev;
+            prev = t;
+        }
+
         SensorData data = generateSensorData();
-        addReading(&cb, data);
-        logToFile(data);
-        checkAlarms(data);     // <--- NEW ALARM CHECK
-        printBuffer(&cb);
-        sleep(1);
+        feedStage(&stages[ST_ALARM], data);     // <--- NEW ALARM CHECK
+        feedStage(&stages[ST_PERSIST], data);
+        if (stages[ST_ALARM].pressure || stages[ST_PERSIST].pressure)
+            stages[ST_DISPLAY].shed++;          // the display can wait, the log cannot
+        else
+            feedStage(&stages[ST_DISPLAY], data);
+        if (!bench.enabled || bench.rate_hz > 0)        // the sampler idles next
+            for (int k = 0; k < 3; k++) wakeStage(&stages[k]);
+        if (bench.enabled) logger_bench_done(&bench);   // hand-off cost of the sampler
+    }
+    double sampling_end = now_s();
+
+    __atomic_store_n(&sampling_done, 1, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < 3; i++) wakeStage(&stages[i]);
+    for (int i = 0; i < 3; i++) {
+        pthread_join(stages[i].thread, NULL);
+        pthread_mutex_destroy(&stages[i].lock);
+        pthread_cond_destroy(&stages[i].wake);
+    }
+    if (dashboard_enabled) {
+        updateDashboard(1);
+        dashboard_close(&dash, now_s());
     }
 
-    printf("\nSimulation complete. Logs saved to 'data_log.csv' and 'alarms_log.txt'.\n");
-    freeBuffer(&cb);
+    if (!bench.enabled) {
+        printPipelineReport(stages, 3, (unsigned long)(total_readings > 0 ? total_readings : 0),
+                            start, sampling_end - start, period_ms,
+                            total_readings > 1 ? 1e3 * interval_sum / (total_readings - 1) : 0.0,
+                            1e3 * max_late);
+        if (!raw_alarms) printRuleReport();
+    }
+    if (rollup_enabled) {
+        if (!bench.enabled) printRollupReport();
+        rollup_free(&rollup);
+    }
+    if (packed_arena) {
+        if (!bench.enabled) printHistoryReport();
+        free(packed_arena);
+    }
+    if (persist_path) {
+        persist_ring_close(&persist);
+        if (!bench.enabled)
+            printf("Persistent ring: %zu readings in '%s', %llu written this run, %lu checkpoints\n",
+                   persist_ring_count(&persist), persist_path, persist.pushed, persist.checkpoints);
+    }
+
+    unsigned long long data_bytes;
+    if (data_format == FORMAT_BIN) {
+        binlog_close(&data_bin);
+        data_bytes = data_bin.bytes;
+        if (!bench.enabled)
+            printf("Binary log: %lu samples in %lu segments, %llu bytes (%.2f B/sample)\n",
+                   data_bin.samples, data_bin.segments, data_bin.bytes,
+                   data_bin.samples ? (double)data_bin.bytes / data_bin.samples : 0.0);
+    } else if (data_format == FORMAT_MMAP) {
+        seg_log_close(&data_seg);
+        data_bytes = data_seg.bytes;
+        if (!bench.enabled)
+            printf("Segment log: %lu records, %llu bytes, %lu segments (%lu removed, %lu by time), "
+                   "%lu msyncs, %lu dropped\n",
+                   data_seg.records, data_seg.bytes, data_seg.segments, data_seg.removed,
+                   data_seg.time_rotations, data_seg.msyncs, data_seg.dropped);
+    } else {
+        log_writer_close(&data_log);
+        time_index_close(&data_idx);
+        data_bytes = data_log.bytes;
+        if (!bench.enabled)
+            printf("Time index: %lu entries of %u records in data_log.csv.idx\n",
+                   data_idx.entries, data_idx.stride);
+    }
+    log_writer_close(&alarm_log);
+
+    if (bench.enabled) {
+        // samples/s covers the whole pipeline: sampling until the logs are closed
+        logger_bench_stop(&bench);
+        bench.bytes_written = data_bytes + alarm_log.bytes;
+        bench.alarms = alarms_raised;
+        bench.dropped = policy_ring_lost(&stages[ST_PERSIST].queue);
+        for (int i = 0; i < 3; i++)
+            logger_bench_stage(&bench, stages[i].name,
+                               policy_ring_lost(&stages[i].queue) + stages[i].shed);
+        logger_bench_report(&bench, "sensor_logger_alarm");
+    } else {
+        printf("\nSimulation complete. Logs saved to '%s' and 'alarms_log.txt'.\n", data_path);
+    }
+    freeBuffer(&display_cb);
     return 0;
 }
 
@@ -6,30 +6,32 @@
  *  - User-defined buffer size (dynamic allocation with malloc)
  *  - 3 simulated sensors: temperature, pressure, flow
  *  - Circular buffer behavior (overwrite oldest when full)
- *  - File logging to data_log.csv
+ *  - File logging to data_log.csv (buffered, file kept open)
+ *  - Headless load test: --bench N [--buffer N] [--rate HZ] skips the
+ *    prompts and per-sample output and prints a JSON summary
+ *    (logger_bench.h)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <time.h>
 #include <unistd.h> // for sleep()
 
+#include "spsc_ring.h"
+#include "timebase.h"
+#include "log_writer.h"
+#include "logger_bench.h"
+#include "sensor_data.h"
+#include "sensor_sim.h"
+
 // ===============================
 // --- Data Structures -----------
 // ===============================
 typedef struct {
-    float temperature;
-    float pressure;
-    float flow;
-    unsigned long timestamp;
-} SensorData;
-
-typedef struct {
-    SensorData *buffer;    // dynamically allocated array
-    int capacity;          // max number of records
-    int head;              // next write position
-    int tail;              // oldest record
-    int count;             // current number of items
+    SpscRing ring;          // lock-free ring, power-of-two slots (firmware/inc/spsc_ring.h)
+    SensorData *storage;    // dynamically allocated ring slots
+    int capacity;           // max number of records kept (user-defined)
     unsigned long overwrite_count;
 } CircularBuffer;
 
@@ -39,7 +41,7 @@ typedef struct {
 int initBuffer(CircularBuffer *cb, int capacity);
 void freeBuffer(CircularBuffer *cb);
 void addReading(CircularBuffer *cb, SensorData data);
-void printBuffer(const CircularBuffer *cb);
+void printBuffer(CircularBuffer *cb);
 SensorData generateSensorData(void);
 void logToFile(SensorData data);
 
@@ -47,112 +49,140 @@ void logToFile(SensorData data);
 // --- Function Implementations ---
 // ===============================
 int initBuffer(CircularBuffer *cb, int capacity) {
-    cb->buffer = (SensorData *)malloc(capacity * sizeof(SensorData));
-    if (!cb->buffer) {
+    if (capacity <= 0) {
+        fprintf(stderr, "Error: Buffer size must be positive.\n");
+        return 0;
+    }
+    size_t slots = spsc_round_capacity((size_t)capacity);
+    cb->storage = (SensorData *)malloc(slots * sizeof(SensorData));
+    if (!cb->storage) {
         fprintf(stderr, "Error: Memory allocation failed.\n");
         return 0;
     }
+    spsc_init(&cb->ring, cb->storage, slots, sizeof(SensorData));
     cb->capacity = capacity;
-    cb->head = 0;
-    cb->tail = 0;
-    cb->count = 0;
     cb->overwrite_count = 0;
     return 1;
 }
 
 void freeBuffer(CircularBuffer *cb) {
-    if (cb->buffer) {
-        free(cb->buffer);
-        cb->buffer = NULL;
+    if (cb->storage) {
+        free(cb->storage);
+        cb->storage = NULL;
     }
 }
 
 void addReading(CircularBuffer *cb, SensorData data) {
-    cb->buffer[cb->head] = data;
-    cb->head = (cb->head + 1) % cb->capacity;
-
-    if (cb->count < cb->capacity) {
-        cb->count++;
-    } else {
-        cb->tail = (cb->tail + 1) % cb->capacity;
+    // Buffer full — drop the oldest reading (we are also the consumer)
+    if (spsc_count(&cb->ring) >= (size_t)cb->capacity) {
+        spsc_consume(&cb->ring, 1);
         cb->overwrite_count++;
     }
+    spsc_push(&cb->ring, &data);
 }
 
-void printBuffer(const CircularBuffer *cb) {
+void printBuffer(CircularBuffer *cb) {
+    SpscSpan spans[2];
+    size_t count = spsc_peek(&cb->ring, spans);
+
     printf("\n========================================\n");
-    printf("BUFFER STATUS: %d/%d filled | Overwrites: %lu\n",
-           cb->count, cb->capacity, cb->overwrite_count);
+    printf("BUFFER STATUS: %zu/%d filled | Overwrites: %lu\n",
+           count, cb->capacity, cb->overwrite_count);
     printf("----------------------------------------\n");
     printf("Idx | Temp (°C) | Press (bar) | Flow (L/min) | Timestamp\n");
     printf("----------------------------------------\n");
 
-    int index = cb->tail;
-    for (int i = 0; i < cb->count; i++) {
-        SensorData d = cb->buffer[index];
-        printf("%3d | %9.2f | %10.2f | %12.2f | %lu\n",
-               i + 1, d.temperature, d.pressure, d.flow, d.timestamp);
-        index = (index + 1) % cb->capacity;
+    int idx = 0;
+    for (int s = 0; s < 2; s++) {
+        const SensorData *d = (const SensorData *)spans[s].data;
+        for (size_t i = 0; i < spans[s].count; i++) {
+            printf("%3d | %9.2f | %10.2f | %12.2f | %" PRIu64 "\n",
+                   ++idx, d[i].temperature, d[i].pressure, d[i].flow, d[i].timestamp);
+        }
     }
     printf("========================================\n");
 }
 
+// Simulated plant (sensor_sim.h), advanced at the sampling rate
+static SensorSim sim;
+
 SensorData generateSensorData(void) {
-    SensorData d;
-    d.temperature = 20.0f + (rand() % 800) / 10.0f; // 20–100°C
-    d.pressure = 1.0f + (rand() % 90) / 10.0f;      // 1–10 bar
-    d.flow = (rand() % 1000) / 10.0f;               // 0–100 L/min
-    d.timestamp = (unsigned long)time(NULL);
+    SensorData d = sensor_sim_next(&sim);   // 20–100°C, 1–10 bar, 0–100 L/min
+    d.timestamp = timebase_wall_ns();
     return d;
 }
 
-void logToFile(SensorData data) {
-    FILE *file = fopen("data_log.csv", "a");
-    if (!file) {
-        fprintf(stderr, "Error opening file for writing.\n");
-        return;
-    }
+static LogWriter data_log;   // kept open for the whole run
 
-    fprintf(file, "%.2f,%.2f,%.2f,%lu\n",
-            data.temperature, data.pressure, data.flow, data.timestamp);
-    fclose(file);
+void logToFile(SensorData data) {
+    log_writer_printf(&data_log, "%.2f,%.2f,%.2f,%" PRIu64 "\n",
+                      data.temperature, data.pressure, data.flow, data.timestamp);
 }
 
 // ===============================
 // --- Main Function -------------
 // ===============================
-int main(void) {
-    srand((unsigned int)time(NULL));
+int main(int argc, char *argv[]) {
+    timebase_init(TIMEBASE_AUTO);
 
     CircularBuffer cb;
     int buffer_size, total_readings;
+    static LoggerBench bench;
+    if (logger_bench_parse(&bench, argc, argv) != 0)
+        return EXIT_FAILURE;
 
-    printf("Enter circular buffer size: ");
-    scanf("%d", &buffer_size);
+    if (bench.enabled) {
+        buffer_size = bench.buffer = bench.buffer ? bench.buffer : LOGGER_BENCH_DEFAULT_BUFFER;
+        total_readings = (int)bench.count;
+    } else {
+        printf("Enter circular buffer size: ");
+        scanf("%d", &buffer_size);
+
+        printf("Enter number of readings to simulate: ");
+        scanf("%d", &total_readings);
+    }
 
-    printf("Enter number of readings to simulate: ");
-    scanf("%d", &total_readings);
+    SimConfig sim_cfg;
+    sensor_sim_default_config(&sim_cfg);
+    if (bench.enabled && bench.rate_hz > 0) sim_cfg.rate_hz = bench.rate_hz;
+    sensor_sim_init(&sim, &sim_cfg, (uint64_t)time(NULL));
 
     if (!initBuffer(&cb, buffer_size)) {
         return EXIT_FAILURE;
     }
 
     // Create or overwrite log file header
-    FILE *file = fopen("data_log.csv", "w");
-    fprintf(file, "Temperature (°C),Pressure (bar),Flow (L/min),Timestamp\n");
-    fclose(file);
+    if (log_writer_open(&data_log, "data_log.csv", 1, NULL) != 0) {
+        fprintf(stderr, "Error opening file for writing.\n");
+        freeBuffer(&cb);
+        return EXIT_FAILURE;
+    }
+    log_writer_printf(&data_log, "Temperature (°C),Pressure (bar),Flow (L/min),Timestamp\n");
 
-    printf("\nStarting Sensor Data Simulation...\n");
+    if (bench.enabled) logger_bench_start(&bench);
+    else printf("\nStarting Sensor Data Simulation...\n");
 
     for (int i = 0; i < total_readings; i++) {
+        if (bench.enabled) logger_bench_pace(&bench);
         SensorData data = generateSensorData();
         addReading(&cb, data);
         logToFile(data); // write to CSV
+        if (bench.enabled) {
+            logger_bench_done(&bench);
+            continue;
+        }
         printBuffer(&cb);
         sleep(1); // simulate 1-second sampling
     }
 
-    printf("\nSimulation complete. Data logged to 'data_log.csv'.\n");
+    log_writer_close(&data_log);
+    if (bench.enabled) {
+        logger_bench_stop(&bench);   // includes flushing the log
+        bench.bytes_written = data_log.bytes;
+        logger_bench_report(&bench, "sensor_logger_dynamic");
+    } else {
+        printf("\nSimulation complete. Data logged to 'data_log.csv'.\n");
+    }
     freeBuffer(&cb);
     return 0;
 }
@@ -0,0 +1,290 @@
+#include "sensor_sim.h"
+#include <string.h>
+
+#ifdef SENSOR_SIM_X86
+#include <immintrin.h>
+#endif
+
+#define PI 3.14159265358979323846
+#define SIM_BATCH_WORDS (SENSOR_CHANNELS * SENSOR_SIM_WORDS * SENSOR_SIM_BATCH)
+
+// Word kinds per channel, each SENSOR_SIM_BATCH long
+enum { W_NOISE0, W_NOISE1, W_SPIKE, W_STEP };
+
+static inline uint32_t rotl32(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+void sensor_sim_seed(SimRng *r, uint64_t seed) {
+    uint64_t x = seed;
+    for (int k = 0; k < 4; k++)
+        for (int l = 0; l < SENSOR_SIM_LANES; l += 2) {
+            uint64_t v = splitmix64(&x);
+            r->s[k][l] = (uint32_t)v;
+            r->s[k][l + 1] = (uint32_t)(v >> 32);
+        }
+}
+
+// xoshiro128++, one lane after the other
+void sensor_sim_fill_scalar(SimRng *r, uint32_t *out, size_t steps) {
+    for (size_t i = 0; i < steps; i++) {
+        for (int l = 0; l < SENSOR_SIM_LANES; l++) {
+            uint32_t s0 = r->s[0][l], s1 = r->s[1][l], s2 = r->s[2][l], s3 = r->s[3][l];
+            out[i * SENSOR_SIM_LANES + (size_t)l] = rotl32(s0 + s3, 7) + s0;
+            uint32_t t = s1 << 9;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            r->s[0][l] = s0; r->s[1][l] = s1; r->s[2][l] = s2; r->s[3][l] = rotl32(s3, 11);
+        }
+    }
+}
+
+#ifdef SENSOR_SIM_X86
+
+#define ROTL128(x, k) _mm_or_si128(_mm_slli_epi32((x), (k)), _mm_srli_epi32((x), 32 - (k)))
+#define ROTL256(x, k) _mm256_or_si256(_mm256_slli_epi32((x), (k)), _mm256_srli_epi32((x), 32 - (k)))
+
+/* Lanes 0-3 and 4-7 as two independent 4-wide generators */
+__attribute__((target("sse2")))
+void sensor_sim_fill_sse2(SimRng *r, uint32_t *out, size_t steps) {
+    for (int h = 0; h < SENSOR_SIM_LANES; h += 4) {
+        __m128i s0 = _mm_loadu_si128((const __m128i *)&r->s[0][h]);
+        __m128i s1 = _mm_loadu_si128((const __m128i *)&r->s[1][h]);
+        __m128i s2 = _mm_loadu_si128((const __m128i *)&r->s[2][h]);
+        __m128i s3 = _mm_loadu_si128((const __m128i *)&r->s[3][h]);
+        for (size_t i = 0; i < steps; i++) {
+            __m128i sum = _mm_add_epi32(s0, s3);
+            _mm_storeu_si128((__m128i *)(out + i * SENSOR_SIM_LANES + (size_t)h),
+                             _mm_add_epi32(ROTL128(sum, 7), s0));
+            __m128i t = _mm_slli_epi32(s1, 9);
+            s2 = _mm_xor_si128(s2, s0);
+            s3 = _mm_xor_si128(s3, s1);
+            s1 = _mm_xor_si128(s1, s2);
+            s0 = _mm_xor_si128(s0, s3);
+            s2 = _mm_xor_si128(s2, t);
+            s3 = ROTL128(s3, 11);
+        }
+        _mm_storeu_si128((__m128i *)&r->s[0][h], s0);
+        _mm_storeu_si128((__m128i *)&r->s[1][h], s1);
+        _mm_storeu_si128((__m128i *)&r->s[2][h], s2);
+        _mm_storeu_si128((__m128i *)&r->s[3][h], s3);
+    }
+}
+
+/* All 8 lanes in one register */
+__attribute__((target("avx2")))
+void sensor_sim_fill_avx2(SimRng *r, uint32_t *out, size_t steps) {
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)r->s[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)r->s[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)r->s[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)r->s[3]);
+    for (size_t i = 0; i < steps; i++) {
+        __m256i sum = _mm256_add_epi32(s0, s3);
+        _mm256_storeu_si256((__m256i *)(out + i * SENSOR_SIM_LANES),
+                            _mm256_add_epi32(ROTL256(sum, 7), s0));
+        __m256i t = _mm256_slli_epi32(s1, 9);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = ROTL256(s3, 11);
+    }
+    _mm256_storeu_si256((__m256i *)r->s[0], s0);
+    _mm256_storeu_si256((__m256i *)r->s[1], s1);
+    _mm256_storeu_si256((__m256i *)r->s[2], s2);
+    _mm256_storeu_si256((__m256i *)r->s[3], s3);
+}
+
+static int has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+}
+
+void sensor_sim_fill(SimRng *r, uint32_t *out, size_t steps) {
+    if (has_avx2()) sensor_sim_fill_avx2(r, out, steps);
+    else sensor_sim_fill_sse2(r, out, steps);
+}
+
+const char *sensor_sim_kernel_name(void) {
+    return has_avx2() ? "avx2" : "sse2";
+}
+
+#else
+
+void sensor_sim_fill(SimRng *r, uint32_t *out, size_t steps) {
+    sensor_sim_fill_scalar(r, out, steps);
+}
+
+const char *sensor_sim_kernel_name(void) {
+    return "scalar";
+}
+
+#endif
+
+void sensor_sim_default_config(SimConfig *cfg) {
+    static const SimChannelModel defaults[SENSOR_CHANNELS] = {
+        //  base  drift   amp  period noise spike% spike  step% step   min    max   quantum
+        {  60.0f, 0.0f, 10.0f, 600.0f, 0.5f, 0.002f, 25.0f, 0.0005f,  8.0f, 20.0f, 100.0f, 0.1f },
+        {   5.0f, 0.0f,  1.5f, 300.0f, 0.1f, 0.002f,  4.0f, 0.0005f,  1.5f,  1.0f,  10.0f, 0.1f },
+        {  50.0f, 0.0f, 15.0f, 120.0f, 2.0f, 0.002f, 40.0f, 0.0005f, 20.0f,  0.0f, 100.0f, 0.1f },
+    };
+    memset(cfg, 0, sizeof(*cfg));
+    memcpy(cfg->ch, defaults, sizeof(defaults));
+    cfg->rate_hz = 1.0;
+    cfg->ticks_per_s = 1.0;
+}
+
+// cos and sin of x by Taylor series after reduction to [-pi, pi]; the
+// terms beyond x^23 are below double precision there
+static void cos_sin(double x, double *c, double *s) {
+    x -= 2.0 * PI * (double)(long long)(x / (2.0 * PI));
+    if (x > PI) x -= 2.0 * PI;
+    if (x < -PI) x += 2.0 * PI;
+    double term = 1.0, cs = 0.0, sn = 0.0;
+    for (int k = 0; k < 26; k++) {
+        if (k % 4 == 0) cs += term;
+        else if (k % 4 == 1) sn += term;
+        else if (k % 4 == 2) cs -= term;
+        else sn -= term;
+        term *= x / (double)(k + 1);
+    }
+    *c = cs;
+    *s = sn;
+}
+
+void sensor_sim_init(SensorSim *s, const SimConfig *cfg, uint64_t seed) {
+    memset(s, 0, sizeof(*s));
+    s->cfg = *cfg;
+    if (s->cfg.rate_hz <= 0) s->cfg.rate_hz = 1.0;
+    sensor_sim_seed(&s->rng, seed);
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        const SimChannelModel *m = &s->cfg.ch[c];
+        s->sin_re[c] = 1.0;
+        s->sin_im[c] = 0.0;
+        s->rot_re[c] = 1.0;
+        s->rot_im[c] = 0.0;
+        if (m->sine_period_s > 0)
+            cos_sin(2.0 * PI / ((double)m->sine_period_s * s->cfg.rate_hz), &s->rot_re[c], &s->rot_im[c]);
+        s->qscale[c] = m->quantum > 0 ? 1.0f / m->quantum : 0.0f;
+    }
+}
+
+// Probability -> threshold on a 31-bit uniform
+static uint32_t threshold31(float p) {
+    if (p <= 0) return 0;
+    if (p >= 1) return 0x80000000u;
+    return (uint32_t)((double)p * 2147483648.0);
+}
+
+// One channel of a batch: n <= SENSOR_SIM_BATCH values into v
+static void channel_batch(SensorSim *s, int c, const uint32_t *w, size_t n, float *v) {
+    const SimChannelModel *m = &s->cfg.ch[c];
+    const uint32_t *n0 = w + W_NOISE0 * SENSOR_SIM_BATCH, *n1 = w + W_NOISE1 * SENSOR_SIM_BATCH;
+    const uint32_t *sp = w + W_SPIKE * SENSOR_SIM_BATCH, *st = w + W_STEP * SENSOR_SIM_BATCH;
+
+    // Sequential part: the sine phasor and the step-fault level carry over
+    // from sample to sample. A step event starts a fault (+-step_amp) or
+    // clears the active one.
+    const uint32_t step_thr = threshold31(m->step_prob);
+    const double drift = (double)m->drift_per_s / s->cfg.rate_hz;
+    double re = s->sin_re[c], im = s->sin_im[c];
+    const double rr = s->rot_re[c], ri = s->rot_im[c];
+    float level = s->step_level[c];
+    for (size_t i = 0; i < n; i++) {
+        if ((st[i] >> 1) < step_thr)
+            level = level != 0.0f ? 0.0f : (st[i] & 1) ? m->step_amp : -m->step_amp;
+        v[i] = (float)((double)m->base + drift * (double)(s->n + i) + (double)m->sine_amp * im) + level;
+        double t = re * rr - im * ri;
+        im = re * ri + im * rr;
+        re = t;
+    }
+    // Pull the phasor back onto the unit circle (one Newton step of 1/|z|)
+    double k = (3.0 - (re * re + im * im)) * 0.5;
+    s->sin_re[c] = re * k;
+    s->sin_im[c] = im * k;
+    s->step_level[c] = level;
+
+    // Independent per sample: noise, spikes, clamp (vectorised by the compiler)
+    const float noise = m->noise_sd * (1.7320508f / 65536.0f);   // sqrt(3) / 2^16
+    const uint32_t spike_thr = threshold31(m->spike_prob);
+    const float amp = m->spike_amp, lo = m->min, hi = m->max;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t u = (n0[i] & 0xffff) + (n0[i] >> 16) + (n1[i] & 0xffff) + (n1[i] >> 16);
+        float x = v[i] + noise * ((float)u - 131070.0f);
+        float spike = (sp[i] & 1) ? amp : -amp;
+        x += (sp[i] >> 1) < spike_thr ? spike : 0.0f;
+        x = x < lo ? lo : x;
+        v[i] = x > hi ? hi : x;
+    }
+    // Sensor resolution: round half away from zero to a multiple of quantum
+    const float q = s->qscale[c];
+    if (q > 0)
+        for (size_t i = 0; i < n; i++) {
+            float x = v[i] * q;
+            v[i] = (float)(int32_t)(x + (x < 0 ? -0.5f : 0.5f)) / q;
+        }
+}
+
+// Always whole batches, so the output depends only on the seed and the
+// config, never on how callers split their requests
+static void next_batch(SensorSim *s, SensorData *out) {
+    uint32_t words[SIM_BATCH_WORDS] __attribute__((aligned(32)));
+    float v[SENSOR_CHANNELS][SENSOR_SIM_BATCH];
+
+    sensor_sim_fill(&s->rng, words, SIM_BATCH_WORDS / SENSOR_SIM_LANES);
+    for (int c = 0; c < SENSOR_CHANNELS; c++)
+        channel_batch(s, c, words + (size_t)c * SENSOR_SIM_WORDS * SENSOR_SIM_BATCH,
+                      SENSOR_SIM_BATCH, v[c]);
+
+    const double tick = s->cfg.ticks_per_s / s->cfg.rate_hz;
+    for (size_t i = 0; i < SENSOR_SIM_BATCH; i++) {
+        out[i].temperature = v[SENSOR_CH_TEMPERATURE][i];
+        out[i].pressure = v[SENSOR_CH_PRESSURE][i];
+        out[i].flow = v[SENSOR_CH_FLOW][i];
+        out[i].timestamp = s->cfg.t0 + (uint64_t)((double)(s->n + i) * tick);
+    }
+    s->n += SENSOR_SIM_BATCH;
+}
+
+void sensor_sim_generate(SensorSim *s, SensorData *out, size_t n) {
+    while (n > 0) {
+        if (s->ahead_pos == s->ahead_len) {
+            if (n >= SENSOR_SIM_BATCH) {        // straight into the caller's array
+                next_batch(s, out);
+                out += SENSOR_SIM_BATCH;
+                n -= SENSOR_SIM_BATCH;
+                continue;
+            }
+            next_batch(s, s->ahead);
+            s->ahead_pos = 0;
+            s->ahead_len = SENSOR_SIM_BATCH;
+        }
+        size_t k = s->ahead_len - s->ahead_pos;
+        if (k > n) k = n;
+        memcpy(out, s->ahead + s->ahead_pos, k * sizeof(*out));
+        s->ahead_pos += k;
+        out += k;
+        n -= k;
+    }
+}
+
+SensorData sensor_sim_next(SensorSim *s) {
+    SensorData d;
+    sensor_sim_generate(s, &d, 1);
+    return d;
+}
@@ -0,0 +1,97 @@
+/*
+ * Synthetic Sensor Signal Generator
+ * Author: Evara
+ *
+ * Replacement for generateSensorData()'s three rand() calls per sample:
+ * rand() is slow, its hidden global state serialises threads, and uniform
+ * white noise looks nothing like a plant. A SensorSim produces batches of
+ * readings from a waveform model per channel:
+ *
+ *   value = base + drift * t + amp * sin(2 pi t / period)     deterministic
+ *         + step level      (random step faults that persist)
+ *         + noise_sd * N(0, 1)                                 Gaussian noise
+ *         + spike           (single-sample outliers)
+ *   then clamped to [min, max] and rounded to `quantum` (sensor resolution)
+ *
+ * Randomness comes from xoshiro128++ run as SENSOR_SIM_LANES independent
+ * lanes held in the SensorSim itself: no global state, so every thread
+ * owns its generator and nothing is shared. The lanes are advanced by an
+ * SSE2 or AVX2 kernel chosen at run time (scalar elsewhere); all kernels
+ * produce the same words, so a seed reproduces the same signal on any
+ * machine. Gaussian noise is the sum of four 16-bit uniforms (Irwin-Hall,
+ * tails cut at 3.46 sigma) and the sine is a rotation recurrence, so the
+ * module needs no libm. The per-sample arithmetic is branch-free loops
+ * over the batch that the compiler vectorises.
+ */
+#ifndef SENSOR_SIM_H
+#define SENSOR_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_data.h"
+#include "sensor_history.h"
+
+#define SENSOR_SIM_LANES  8       // xoshiro128++ streams advanced together
+#define SENSOR_SIM_BATCH  64      // samples generated per internal batch
+#define SENSOR_SIM_WORDS  4       // random words per channel and sample
+
+typedef struct {
+    float base;                   // level at t = 0
+    float drift_per_s;            // linear drift
+    float sine_amp;               // 0 = no oscillation
+    float sine_period_s;
+    float noise_sd;               // Gaussian noise standard deviation
+    float spike_prob;             // per sample
+    float spike_amp;              // +- amplitude of a spike
+    float step_prob;              // per sample: the level shifts and stays
+    float step_amp;               // +- size of a step
+    float min, max;               // clamp
+    float quantum;                // round to multiples (e.g. 0.1); 0 = off
+} SimChannelModel;
+
+typedef struct {
+    SimChannelModel ch[SENSOR_CHANNELS];
+    double rate_hz;               // samples per second of simulated time
+    uint64_t t0;                  // timestamp of the first sample
+    double ticks_per_s;           // timestamp units per second
+} SimConfig;
+
+typedef struct {
+    uint32_t s[4][SENSOR_SIM_LANES];          // xoshiro128++ state, lane-major
+} __attribute__((aligned(32))) SimRng;
+
+typedef struct {
+    SimConfig cfg;
+    SimRng rng;
+    uint64_t n;                   // samples generated so far
+
+    // Per-channel waveform state
+    double sin_re[SENSOR_CHANNELS], sin_im[SENSOR_CHANNELS];   // rotating phasor
+    double rot_re[SENSOR_CHANNELS], rot_im[SENSOR_CHANNELS];   // rotation per sample
+    float  step_level[SENSOR_CHANNELS];
+    float  qscale[SENSOR_CHANNELS];            // 1 / quantum, 0 = no rounding
+
+    // sensor_sim_next(): one batch decoded ahead
+    SensorData ahead[SENSOR_SIM_BATCH];
+    size_t ahead_pos, ahead_len;
+} SensorSim;
+
+// Plant-like defaults in the loggers' ranges: 1 Hz, seconds, 0.1 resolution
+void sensor_sim_default_config(SimConfig *cfg);
+void sensor_sim_init(SensorSim *s, const SimConfig *cfg, uint64_t seed);
+void sensor_sim_generate(SensorSim *s, SensorData *out, size_t n);
+SensorData sensor_sim_next(SensorSim *s);
+
+// Random words: SENSOR_SIM_LANES per step, lane order, same for all kernels
+void sensor_sim_seed(SimRng *r, uint64_t seed);
+void sensor_sim_fill(SimRng *r, uint32_t *out, size_t steps);
+const char *sensor_sim_kernel_name(void);
+
+void sensor_sim_fill_scalar(SimRng *r, uint32_t *out, size_t steps);
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SENSOR_SIM_X86 1
+void sensor_sim_fill_sse2(SimRng *r, uint32_t *out, size_t steps);
+void sensor_sim_fill_avx2(SimRng *r, uint32_t *out, size_t steps);
+#endif
+
+#endif
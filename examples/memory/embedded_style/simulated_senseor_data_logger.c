@@ -6,49 +6,50 @@
  *  - Simulates 3 sensors: Temperature, Pressure, and Flow.
  *  - Stores readings in a circular buffer of fixed size.
  *  - Demonstrates memory management without dynamic allocation.
+ *  - --bench N [--buffer N] [--rate HZ]: headless load test with a JSON
+ *    summary (logger_bench.h); --buffer is at most RING_SLOTS.
  *
- * Compile with: gcc sensor_logger.c -o sensor_logger
- * Run: ./sensor_logger
+ * Compile with: make loggers
+ * Run: ./build/simulated_senseor_data_logger
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <time.h>
 #include <unistd.h> 
 
+#include "spsc_ring.h"
+#include "timebase.h"
+#include "logger_bench.h"
+#include "sensor_data.h"
+#include "sensor_sim.h"
+
 // ===============================
 // --- Configuration Section ----
 // ===============================
 #define BUFFER_SIZE 10  // Circular buffer capacity
+#define RING_SLOTS  16  // Power of two >= BUFFER_SIZE (mask indexing)
 #define NUM_READINGS 25 // Total readings to simulate
 
 // ===============================
 // --- Data Structures -----------
 // ===============================
 
-// One sensor record
-typedef struct {
-    float temperature;    // in °C
-    float pressure;       // in bar
-    float flow;           // in L/min
-    unsigned long timestamp; // UNIX time (seconds)
-} SensorData;
-
 // Circular buffer to store sensor readings
 typedef struct {
-    SensorData buffer[BUFFER_SIZE];
-    int head;   // index of next write
-    int tail;   // index of oldest data
-    int count;  // how many items currently in buffer
+    SpscRing ring;                   // lock-free ring (firmware/inc/spsc_ring.h)
+    SensorData buffer[RING_SLOTS];   // static storage, no malloc
+    int capacity;                    // readings kept, <= RING_SLOTS
     unsigned long overwrite_count;
 } CircularBuffer;
 
 // ===============================
 // --- Function Prototypes -------
 // ===============================
-void initBuffer(CircularBuffer *cb);
+void initBuffer(CircularBuffer *cb, int capacity);
 void addReading(CircularBuffer *cb, SensorData data);
-void printBuffer(const CircularBuffer *cb);
+void printBuffer(CircularBuffer *cb);
 SensorData generateSensorData(void);
 
 // ===============================
@@ -56,76 +57,103 @@ SensorData generateSensorData(void);
 // ===============================
 
 // Initialize circular buffer
-void initBuffer(CircularBuffer *cb) {
-    cb->head = 0;
-    cb->tail = 0;
-    cb->count = 0;
+void initBuffer(CircularBuffer *cb, int capacity) {
+    spsc_init(&cb->ring, cb->buffer, RING_SLOTS, sizeof(SensorData));
+    cb->capacity = capacity;
     cb->overwrite_count = 0;
 }
 
 // Add new sensor reading to buffer
 void addReading(CircularBuffer *cb, SensorData data) {
-    cb->buffer[cb->head] = data;
-    cb->head = (cb->head + 1) % BUFFER_SIZE;
-
-    if (cb->count < BUFFER_SIZE) {
-        cb->count++;
-    } else {
+    if (spsc_count(&cb->ring) >= (size_t)cb->capacity) {
         // Buffer full — overwrite oldest data
-        cb->tail = (cb->tail + 1) % BUFFER_SIZE;
+        spsc_consume(&cb->ring, 1);
         cb->overwrite_count++;
     }
+    spsc_push(&cb->ring, &data);
 }
 
 // Print all stored readings
-void printBuffer(const CircularBuffer *cb) {
+void printBuffer(CircularBuffer *cb) {
+    SpscSpan spans[2];
+    size_t count = spsc_peek(&cb->ring, spans);
+
     printf("\n========================================\n");
-    printf("BUFFER STATUS: %d/%d filled\n", cb->count, BUFFER_SIZE);
+    printf("BUFFER STATUS: %zu/%d filled\n", count, cb->capacity);
     printf("Overwrites: %lu\n", cb->overwrite_count);
     printf("----------------------------------------\n");
     printf("Index | Temperature | Pressure | Flow | Timestamp\n");
     printf("----------------------------------------\n");
 
-    int index = cb->tail;
-    for (int i = 0; i < cb->count; i++) {
-        SensorData d = cb->buffer[index];
-        printf("%5d | %10.2f°C | %8.2f bar | %6.2f L/min | %lu\n",
-               i + 1, d.temperature, d.pressure, d.flow, d.timestamp);
-        index = (index + 1) % BUFFER_SIZE;
+    int idx = 0;
+    for (int s = 0; s < 2; s++) {
+        const SensorData *d = (const SensorData *)spans[s].data;
+        for (size_t i = 0; i < spans[s].count; i++) {
+            printf("%5d | %10.2f°C | %8.2f bar | %6.2f L/min | %" PRIu64 "\n",
+                   ++idx, d[i].temperature, d[i].pressure, d[i].flow, d[i].timestamp);
+        }
     }
 
     printf("========================================\n");
 }
 
-// Generate simulated sensor data
+// Generate simulated sensor data from the plant model (sensor_sim.h)
+static SensorSim sim;
+
 SensorData generateSensorData(void) {
-    SensorData d;
-    d.temperature = 20.0f + (rand() % 800) / 10.0f; // 20–100°C
-    d.pressure = 1.0f + (rand() % 90) / 10.0f;      // 1–10 bar
-    d.flow = (rand() % 1000) / 10.0f;               // 0–100 L/min
-    d.timestamp = (unsigned long)time(NULL);
+    SensorData d = sensor_sim_next(&sim);   // 20–100°C, 1–10 bar, 0–100 L/min
+    d.timestamp = timebase_wall_ns();
     return d;
 }
 
 // ===============================
 // --- Main Function -------------
 // ===============================
-int main(void) {
-    srand((unsigned int)time(NULL));
+int main(int argc, char *argv[]) {
+    timebase_init(TIMEBASE_AUTO);
+
+    static LoggerBench bench;
+    if (logger_bench_parse(&bench, argc, argv) != 0)
+        return EXIT_FAILURE;
+    if (bench.buffer > RING_SLOTS) {
+        fprintf(stderr, "Error: the buffer is static, at most %d readings.\n", RING_SLOTS);
+        return EXIT_FAILURE;
+    }
+
+    SimConfig sim_cfg;
+    sensor_sim_default_config(&sim_cfg);
+    if (bench.enabled && bench.rate_hz > 0) sim_cfg.rate_hz = bench.rate_hz;
+    sensor_sim_init(&sim, &sim_cfg, (uint64_t)time(NULL));
 
     CircularBuffer cb;
-    initBuffer(&cb);
+    initBuffer(&cb, bench.buffer ? bench.buffer : BUFFER_SIZE);
+    int readings = bench.enabled ? (int)bench.count : NUM_READINGS;
 
-    printf("Starting Simulated Sensor Data Logger...\n");
+    if (bench.enabled) {
+        bench.buffer = cb.capacity;
+        logger_bench_start(&bench);
+    } else {
+        printf("Starting Simulated Sensor Data Logger...\n");
+    }
 
-    for (int i = 0; i < NUM_READINGS; i++) {
+    for (int i = 0; i < readings; i++) {
+        if (bench.enabled) logger_bench_pace(&bench);
         SensorData data = generateSensorData();
         addReading(&cb, data);
+        if (bench.enabled) {
+            logger_bench_done(&bench);
+            continue;
+        }
         printBuffer(&cb);
         sleep(1); // Wait 1 second between readings
     }
 
-    printf("\nSimulation complete.\n");
+    if (bench.enabled) {
+        logger_bench_stop(&bench);
+        logger_bench_report(&bench, "simulated_senseor_data_logger");
+    } else {
+        printf("\nSimulation complete.\n");
+    }
     return 0;
 }
 /*
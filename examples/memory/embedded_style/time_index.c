@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "time_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static void write_all(TimeIndexWriter *w, const void *data, size_t len, off_t at) {
+    const char *p = (const char *)data;
+    while (len > 0 && !w->error) {
+        ssize_t n = pwrite(w->fd, p, len, at);
+        if (n < 0) {
+            if (errno != EINTR) w->error = errno;
+            continue;
+        }
+        p += n;
+        at += n;
+        len -= (size_t)n;
+    }
+}
+
+static void close_block(TimeIndexWriter *w) {
+    if (w->open.count == 0) return;
+    // readers binary-search max_ts: record once in the header that the
+    // block ranges went back so they look for the ordered runs
+    if (!(w->flags & TIME_INDEX_UNORDERED) && w->entries &&
+        (w->open.min_ts < w->last_min || w->open.max_ts < w->last_max)) {
+        w->flags |= TIME_INDEX_UNORDERED;
+        write_all(w, &w->flags, sizeof(w->flags), (off_t)offsetof(TimeIndexHeader, flags));
+    }
+    write_all(w, &w->open, sizeof(w->open),
+              (off_t)(sizeof(TimeIndexHeader) + w->entries * sizeof(TimeIndexEntry)));
+    w->entries++;
+    w->last_min = w->open.min_ts;
+    w->last_max = w->open.max_ts;
+    w->open.offset = w->offset;
+    w->open.bytes = 0;
+    w->open.count = 0;
+}
+
+int time_index_open(TimeIndexWriter *w, const char *path, unsigned long long data_offset,
+                    uint32_t stride) {
+    memset(w, 0, sizeof(*w));
+    w->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (w->fd < 0) return -1;
+    w->stride = stride ? stride : TIME_INDEX_DEFAULT_STRIDE;
+    w->offset = data_offset;
+    w->open.offset = data_offset;
+
+    TimeIndexHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = TIME_INDEX_MAGIC;
+    h.version = TIME_INDEX_VERSION;
+    h.stride = w->stride;
+    write_all(w, &h, sizeof(h), 0);
+    if (w->error) {
+        close(w->fd);
+        w->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void time_index_add(TimeIndexWriter *w, uint64_t timestamp, size_t record_bytes) {
+    if (w->open.count == 0) {
+        w->open.min_ts = w->open.max_ts = timestamp;
+    } else {
+        if (timestamp < w->open.min_ts) w->open.min_ts = timestamp;
+        if (timestamp > w->open.max_ts) w->open.max_ts = timestamp;
+    }
+
+    w->open.bytes += (uint32_t)record_bytes;
+    w->open.count++;
+    w->offset += record_bytes;
+    if (w->open.count >= w->stride) close_block(w);
+}
+
+void time_index_skip(TimeIndexWriter *w, size_t bytes) {
+    close_block(w);
+    w->offset += bytes;
+    w->open.offset = w->offset;
+}
+
+void time_index_close(TimeIndexWriter *w) {
+    if (w->fd < 0) return;
+    close_block(w);
+    close(w->fd);
+    w->fd = -1;
+}
+
+static int run_starts(const TimeIndex *ix, size_t i) {
+    return ix->entry[i].min_ts < ix->entry[i - 1].min_ts ||
+           ix->entry[i].max_ts < ix->entry[i - 1].max_ts;
+}
+
+int time_index_load(TimeIndex *ix, const char *path) {
+    memset(ix, 0, sizeof(*ix));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TimeIndexHeader)) {
+        close(fd);
+        return -1;
+    }
+    ix->map_len = (size_t)st.st_size;
+    ix->map = mmap(NULL, ix->map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ix->map == MAP_FAILED) {
+        ix->map = NULL;
+        return -1;
+    }
+
+    const TimeIndexHeader *h = (const TimeIndexHeader *)ix->map;
+    if (h->magic != TIME_INDEX_MAGIC || h->version != TIME_INDEX_VERSION) {
+        time_index_unload(ix);
+        return -1;
+    }
+    ix->flags = h->flags;
+    ix->stride = h->stride;
+    ix->entry = (const TimeIndexEntry *)((const char *)ix->map + sizeof(TimeIndexHeader));
+    ix->count = (ix->map_len - sizeof(TimeIndexHeader)) / sizeof(TimeIndexEntry);
+
+    // a run ends where min_ts or max_ts goes back
+    ix->runs = ix->count ? 1 : 0;
+    if (ix->flags & TIME_INDEX_UNORDERED)
+        for (size_t i = 1; i < ix->count; i++)
+            ix->runs += run_starts(ix, i);
+    ix->run = malloc((ix->runs + 1) * sizeof(*ix->run));
+    if (!ix->run) {
+        time_index_unload(ix);
+        return -1;
+    }
+    size_t r = 0;
+    if (ix->count) ix->run[r++] = 0;
+    if (ix->flags & TIME_INDEX_UNORDERED)
+        for (size_t i = 1; i < ix->count; i++)
+            if (run_starts(ix, i)) ix->run[r++] = i;
+    ix->run[r] = ix->count;
+    return 0;
+}
+
+void time_index_unload(TimeIndex *ix) {
+    if (ix->map) munmap(ix->map, ix->map_len);
+    free(ix->run);
+    memset(ix, 0, sizeof(*ix));
+}
+
+size_t time_index_lower_bound(const TimeIndex *ix, size_t r, uint64_t from) {
+    size_t lo = ix->run[r], hi = ix->run[r + 1];
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ix->entry[mid].max_ts < from) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+unsigned long long time_index_end(const TimeIndex *ix) {
+    if (ix->count == 0) return 0;
+    const TimeIndexEntry *e = &ix->entry[ix->count - 1];
+    return e->offset + e->bytes;
+}
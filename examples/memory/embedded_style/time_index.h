@@ -0,0 +1,99 @@
+/*
+ * Sparse Time Index
+ * Author: Evara
+ *
+ * Sidecar index for data_log.csv (data_log.csv.idx) so that a time range
+ * can be read without scanning the whole log. The writer groups every
+ * `stride` records into a block and appends one fixed-size entry per block:
+ * byte offset and length in the data file, record count, and the min/max
+ * timestamp seen in the block. Entries are written as each block closes,
+ * so the index grows with the log and costs one small write per stride.
+ *
+ * A query binary-searches the entries for the first block that can hold
+ * the start of the range and reads only the blocks that overlap it: the
+ * work depends on the size of the result, not of the log.
+ *
+ * File layout: TimeIndexHeader, then TimeIndexEntry records in data file
+ * order. A torn last entry (crash mid-write) is ignored by the reader,
+ * and records after the last complete block are found by scanning the
+ * (at most stride records long) tail of the data file.
+ */
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIME_INDEX_MAGIC          0x58495645u  // "EVIX"
+#define TIME_INDEX_VERSION        1
+#define TIME_INDEX_DEFAULT_STRIDE 1024         // records per entry
+
+// A block's min_ts or max_ts is below the previous block's (the clock went
+// back; jitter inside or across blocks only widens their ranges). The
+// reader then splits the entries into runs in which both never decrease
+// and searches each run, so one step back costs one more search.
+#define TIME_INDEX_UNORDERED      0x0001
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;            // TIME_INDEX_*
+    uint32_t stride;           // writer's records per entry (informative)
+    uint32_t reserved;
+} TimeIndexHeader;
+
+typedef struct {
+    uint64_t offset;           // first byte of the block in the data file
+    uint32_t bytes;            // block length
+    uint32_t count;            // records in the block
+    uint64_t min_ts;
+    uint64_t max_ts;
+} TimeIndexEntry;
+
+// ---- Writer ----
+
+typedef struct {
+    int fd;
+    uint32_t stride;
+    uint16_t flags;
+    unsigned long long offset; // data file offset of the next record
+    TimeIndexEntry open;       // block being filled
+    uint64_t last_min;         // min_ts of the last closed block
+    uint64_t last_max;         // max_ts of the last closed block
+    unsigned long entries;
+    int error;                 // first errno from write()
+} TimeIndexWriter;
+
+// data_offset: where the first indexed record starts (e.g. after the CSV
+// header). stride 0 selects TIME_INDEX_DEFAULT_STRIDE. Truncates path.
+int  time_index_open(TimeIndexWriter *w, const char *path, unsigned long long data_offset,
+                     uint32_t stride);
+void time_index_add(TimeIndexWriter *w, uint64_t timestamp, size_t record_bytes);
+void time_index_skip(TimeIndexWriter *w, size_t bytes);   // unindexed bytes (e.g. a header)
+void time_index_close(TimeIndexWriter *w);                // writes the partial last block
+
+// ---- Reader ----
+
+typedef struct {
+    const TimeIndexEntry *entry;
+    size_t count;
+    uint16_t flags;
+    uint32_t stride;
+    size_t *run;               // first entry of each ordered run, run[runs] = count
+    size_t runs;
+    void  *map;
+    size_t map_len;
+} TimeIndex;
+
+int    time_index_load(TimeIndex *ix, const char *path);  // 0 on success (mmap)
+void   time_index_unload(TimeIndex *ix);
+
+// First entry of run r (ix->run[r] .. ix->run[r + 1] - 1) whose block may
+// contain a timestamp >= from: binary search over max_ts. Within a run
+// min_ts never decreases either, so the caller stops at min_ts > to.
+size_t time_index_lower_bound(const TimeIndex *ix, size_t r, uint64_t from);
+
+// Data file offset right after the last indexed block
+unsigned long long time_index_end(const TimeIndex *ix);
+
+#endif
@@ -1,13 +1,31 @@
 #include "scheduler.h"
+#include "trace.h"
+#include "telemetry.h"
+#include "mem_pool.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#define SAMPLE_POOL_SIZE  128
+#define SAMPLE_BLOCK_SIZE  16
+#define SAMPLE_SLOTS (SAMPLE_POOL_SIZE / SAMPLE_BLOCK_SIZE)
+
+/* sensor samples travel from T1 to T3 in blocks of a static pool */
+static uint8_t sample_pool_mem[SAMPLE_POOL_SIZE];
+static MemPool sample_pool;
+static void *pending_samples[SAMPLE_SLOTS];
+
 /* lightweight demo tasks */
 void task1_sensor(void) {
     static int c = 0;
     printf("[T1] Sensor read %d\n", c++);
+    for (size_t i = 0; i < SAMPLE_SLOTS; ++i) {
+        if (!pending_samples[i]) {
+            pending_samples[i] = mem_alloc(&sample_pool);
+            break;
+        }
+    }
 }
 
 void task2_uart(void) {
@@ -16,21 +34,101 @@ void task2_uart(void) {
 
 void task3_logger(void) {
     printf("[T3] Logging\n");
+    for (size_t i = 0; i < SAMPLE_SLOTS; ++i) {
+        if (pending_samples[i]) {
+            mem_free(&sample_pool, pending_samples[i]);
+            pending_samples[i] = NULL;
+        }
+    }
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--ticks N] [--rt] [--rt-cpu N] [--rt-prio P] [--rt-mlock] [--rt-spin-us U] [--trace FILE] [--telemetry MS]\n", prog);
+    printf("  --ticks N      run for N ms instead of until Ctrl+C\n");
+    printf("  --rt           absolute-deadline tick loop with jitter histogram\n");
+    printf("  --rt-cpu N     pin the scheduler thread to CPU N\n");
+    printf("  --rt-prio P    request SCHED_FIFO priority P (1..99)\n");
+    printf("  --rt-mlock     mlockall() and pre-fault stack and task table\n");
+    printf("  --rt-spin-us U busy-wait the final U us before each tick\n");
+    printf("  --trace FILE   write a binary event trace (build with make TRACE=1)\n");
+    printf("  --telemetry MS publish live stats to shared memory every MS ticks\n");
 }
 
 int main(int argc, char *argv[]) {
+    uint32_t dur = 0;
+    int use_rt = 0;
+    RtConfig rt = { -1, 0, 0, 0 };
+    const char *trace_path = NULL;
+    uint32_t telemetry_ms = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            dur = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rt") == 0) {
+            use_rt = 1;
+        } else if (strcmp(argv[i], "--rt-cpu") == 0 && i + 1 < argc) {
+            rt.cpu = atoi(argv[++i]);
+            use_rt = 1;
+        } else if (strcmp(argv[i], "--rt-prio") == 0 && i + 1 < argc) {
+            rt.fifo_priority = atoi(argv[++i]);
+            use_rt = 1;
+        } else if (strcmp(argv[i], "--rt-mlock") == 0) {
+            rt.lock_memory = 1;
+            use_rt = 1;
+        } else if (strcmp(argv[i], "--rt-spin-us") == 0 && i + 1 < argc) {
+            rt.spin_us = (uint32_t)atoi(argv[++i]);
+            use_rt = 1;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetry_ms = (uint32_t)atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (trace_path) {
+#ifndef TRACE_ENABLE
+        fprintf(stderr, "Trace: built without TRACE_ENABLE, %s will be empty\n", trace_path);
+#endif
+        trace_init();
+    }
+
+    mem_init(&sample_pool, sample_pool_mem, SAMPLE_POOL_SIZE, SAMPLE_BLOCK_SIZE);
+
     scheduler_init();
     scheduler_add(task1_sensor, 5);   /* every 5 ms */
     scheduler_add(task2_uart,    10); /* every 10 ms */
     scheduler_add(task3_logger,  25); /* every 25 ms */
 
-    if (argc > 1 && strcmp(argv[1], "--ticks") == 0 && argc > 2) {
-        uint32_t dur = (uint32_t)atoi(argv[2]);
+    if (telemetry_ms > 0) {
+        if (telemetry_open() == 0) {
+            telemetry_add_pool("samples", &sample_pool);
+            scheduler_set_telemetry(telemetry_ms);
+            printf("Telemetry: publishing to shm %s every %u ms\n", TELEMETRY_SHM_NAME, telemetry_ms);
+        } else {
+            printf("Telemetry: disabled\n");
+        }
+    }
+
+    if (use_rt && scheduler_set_rt(&rt) != 0) {
+        printf("RT: running degraded (see warnings above)\n");
+    }
+
+    if (dur > 0) {
         scheduler_run_for(dur);
     } else {
         /* run until Ctrl+C */
         scheduler_run();
     }
 
+    telemetry_close();
+
+    if (trace_path) {
+        if (trace_dump(trace_path) == 0) printf("Trace written to %s\n", trace_path);
+        else fprintf(stderr, "Trace: cannot write %s\n", trace_path);
+    }
+
     return 0;
 }
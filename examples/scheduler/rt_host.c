@@ -0,0 +1,143 @@
+#define _GNU_SOURCE
+
+#include "rt_host.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+/* stack depth pre-faulted for the scheduler thread and its tasks */
+#define RT_PREFAULT_STACK_BYTES (256u * 1024u)
+
+/* upper bound (us) of each histogram bucket; the last one catches the rest */
+static const uint32_t rt_jitter_bounds_us[RT_JITTER_BUCKETS] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000, UINT32_MAX
+};
+
+uint64_t rt_host_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void rt_host_prefault(void *buf, size_t len) {
+    volatile uint8_t *p = (volatile uint8_t *)buf;
+    long page = sysconf(_SC_PAGESIZE);
+    if (!buf || page <= 0) return;
+    for (size_t off = 0; off < len; off += (size_t)page) {
+        p[off] = p[off];
+    }
+}
+
+/* grow the stack once so its pages are resident (and locked by mlockall) */
+static void __attribute__((noinline)) rt_prefault_stack(void) {
+    volatile uint8_t stack[RT_PREFAULT_STACK_BYTES];
+    memset((void *)stack, 0, sizeof(stack));
+}
+
+int rt_host_apply(const RtConfig *cfg) {
+    int failures = 0;
+    if (!cfg) return 0;
+
+#ifdef __linux__
+    if (cfg->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            fprintf(stderr, "RT: cannot pin to CPU %d (%s), continuing unpinned\n",
+                    cfg->cpu, strerror(errno));
+            failures++;
+        } else {
+            printf("RT: pinned to CPU %d\n", cfg->cpu);
+        }
+    }
+#else
+    if (cfg->cpu >= 0) {
+        fprintf(stderr, "RT: CPU pinning not supported on this host\n");
+        failures++;
+    }
+#endif
+
+    if (cfg->fifo_priority > 0) {
+        struct sched_param sp;
+        memset(&sp, 0, sizeof(sp));
+        sp.sched_priority = cfg->fifo_priority;
+        if (sched_setscheduler(0, SCHED_FIFO, &sp) != 0) {
+            fprintf(stderr, "RT: SCHED_FIFO prio %d refused (%s), staying on SCHED_OTHER\n",
+                    cfg->fifo_priority, strerror(errno));
+            failures++;
+        } else {
+            printf("RT: SCHED_FIFO priority %d\n", cfg->fifo_priority);
+        }
+    }
+
+    if (cfg->lock_memory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            fprintf(stderr, "RT: mlockall failed (%s), memory may be paged\n",
+                    strerror(errno));
+            failures++;
+        } else {
+            printf("RT: memory locked\n");
+        }
+        /* fault in the stack even if locking failed: first-touch faults
+           are the dominant cost in the first ticks */
+        rt_prefault_stack();
+    }
+
+    if (cfg->spin_us > 0) {
+        printf("RT: spinning final %u us before each deadline\n", cfg->spin_us);
+    }
+
+    return failures;
+}
+
+void rt_host_sleep_until(uint64_t deadline_ns, uint32_t spin_us) {
+    uint64_t spin_ns = (uint64_t)spin_us * 1000ULL;
+
+    if (deadline_ns > spin_ns) {
+        uint64_t wake_ns = deadline_ns - spin_ns;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wake_ns / 1000000000ULL);
+        ts.tv_nsec = (long)(wake_ns % 1000000000ULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+            /* restart after signals (e.g. SIGINT sets the stop flag) */
+        }
+    }
+
+    while (rt_host_now_ns() < deadline_ns) {
+        /* busy-wait the final stretch: wakeup latency dominates it otherwise */
+    }
+}
+
+void rt_jitter_reset(RtJitterHist *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void rt_jitter_record(RtJitterHist *h, uint64_t late_ns) {
+    uint64_t late_us = late_ns / 1000ULL;
+    size_t b = 0;
+    while (b < RT_JITTER_BUCKETS - 1 && late_us >= rt_jitter_bounds_us[b]) b++;
+    h->bucket[b]++;
+    h->samples++;
+    h->sum_ns += late_ns;
+    if (late_ns > h->max_ns) h->max_ns = late_ns;
+}
+
+void rt_jitter_report(const char *title, const RtJitterHist *h) {
+    printf("%s: samples=%" PRIu64 " mean_us=%.2f max_us=%.2f\n",
+           title, h->samples,
+           h->samples ? (double)h->sum_ns / (double)h->samples / 1e3 : 0.0,
+           (double)h->max_ns / 1e3);
+    for (size_t b = 0; b < RT_JITTER_BUCKETS; ++b) {
+        if (b == RT_JITTER_BUCKETS - 1) {
+            printf("  >= %5u us : %" PRIu64 "\n", rt_jitter_bounds_us[b - 1], h->bucket[b]);
+        } else {
+            printf("  <  %5u us : %" PRIu64 "\n", rt_jitter_bounds_us[b], h->bucket[b]);
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RT_HOST_H
+#define RT_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Opt-in low-jitter host mode for running the scheduler as a
+   hardware-in-the-loop stand-in. Every feature is best effort: if the
+   process lacks the privilege for it, a warning is printed and the
+   scheduler keeps running with the normal Linux behaviour. */
+typedef struct {
+    int      cpu;           /* CPU to pin the scheduler thread to, -1 = no pinning */
+    int      fifo_priority; /* SCHED_FIFO priority (1..99), 0 = keep default policy */
+    int      lock_memory;   /* mlockall() and pre-fault stack/pools */
+    uint32_t spin_us;       /* busy-wait this many us before each tick deadline */
+} RtConfig;
+
+/* Jitter histogram: deviation of each tick from its ideal deadline */
+#define RT_JITTER_BUCKETS 12
+
+typedef struct {
+    uint64_t bucket[RT_JITTER_BUCKETS]; /* counts per upper bound in rt_jitter_bounds_us */
+    uint64_t samples;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+} RtJitterHist;
+
+/* apply cfg to the calling thread; returns number of features that
+   could not be applied (0 = everything granted) */
+int  rt_host_apply(const RtConfig *cfg);
+
+/* touch every page of buf so later accesses never page-fault */
+void rt_host_prefault(void *buf, size_t len);
+
+/* sleep until absolute CLOCK_MONOTONIC deadline, spinning the last spin_us */
+void rt_host_sleep_until(uint64_t deadline_ns, uint32_t spin_us);
+
+uint64_t rt_host_now_ns(void);
+
+void rt_jitter_reset(RtJitterHist *h);
+void rt_jitter_record(RtJitterHist *h, uint64_t late_ns);
+void rt_jitter_report(const char *title, const RtJitterHist *h);
+
+#endif
@@ -1,6 +1,9 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include "scheduler.h"
+#include "trace.h"
+#include "telemetry.h"
+#include "timebase.h"
 #include <stdio.h>
 #include <time.h>
 #include <signal.h>
@@ -16,7 +19,22 @@ static uint64_t total_ticks = 0;     /* number of 1ms ticks seen */
 static uint64_t active_ticks = 0;    /* ticks where >=1 task ran */
 static volatile sig_atomic_t keep_running = 1;
 
-/* helper: monotonic now in ns */
+/* critical-section hooks for ISR-driven ticks (no-ops by default) */
+static void critical_noop(void) {}
+static void (*critical_enter)(void) = critical_noop;
+static void (*critical_exit)(void) = critical_noop;
+
+/* real-time host mode */
+static int rt_enabled = 0;
+static RtConfig rt_cfg;
+static RtJitterHist rt_jitter;
+static uint64_t next_deadline_ns = 0;
+
+/* live telemetry */
+static uint32_t telemetry_period = 0;
+static uint32_t telemetry_countdown = 0;
+
+/* helper: monotonic now in ns, on the clock the tick deadlines sleep on */
 static inline uint64_t now_ns(void) {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
@@ -24,6 +42,7 @@ static inline uint64_t now_ns(void) {
 }
 
 void scheduler_init(void) {
+    timebase_init(TIMEBASE_AUTO);   /* task runtime accounting */
     memset(tasks, 0, sizeof(tasks));
     task_count = 0;
     total_ticks = 0;
@@ -39,19 +58,27 @@ int scheduler_add(TaskFunc f, uint32_t period_ms) {
     tasks[task_count].state = TASK_STATE_READY;
     tasks[task_count].run_count = 0;
     tasks[task_count].runtime_ns = 0;
+    tasks[task_count].pending = 0;
     return (int)task_count++;
 }
 
 void scheduler_enable(size_t task_id) {
-    if (task_id < task_count) tasks[task_id].state = TASK_STATE_READY;
+    if (task_id < task_count) {
+        tasks[task_id].state = TASK_STATE_READY;
+        TRACE(TRACE_EV_TASK_ENABLE, task_id, 0);
+    }
 }
 
 void scheduler_disable(size_t task_id) {
-    if (task_id < task_count) tasks[task_id].state = TASK_STATE_DISABLED;
+    if (task_id < task_count) {
+        tasks[task_id].state = TASK_STATE_DISABLED;
+        TRACE(TRACE_EV_TASK_DISABLE, task_id, 0);
+    }
 }
 
 /* decrement time-left for active tasks (1 ms tick) */
 void scheduler_tick(void) {
+    TRACE(TRACE_EV_TICK, 0, total_ticks);
     for (size_t i = 0; i < task_count; ++i) {
         if (tasks[i].state == TASK_STATE_READY && tasks[i].time_left > 0) {
             tasks[i].time_left--;
@@ -59,29 +86,55 @@ void scheduler_tick(void) {
     }
 }
 
-/* internal single step: run ready tasks whose time_left == 0,
-   measure per-task execution time and update counters */
-static void scheduler_step_once(void) {
-    int ran_any = 0;
+void scheduler_trigger(size_t task_id) {
+    if (task_id < task_count) __atomic_fetch_add(&tasks[task_id].pending, 1, __ATOMIC_RELEASE);
+}
+
+void scheduler_set_critical(void (*enter)(void), void (*exit)(void)) {
+    critical_enter = enter ? enter : critical_noop;
+    critical_exit = exit ? exit : critical_noop;
+}
+
+/* internal single step: run ready tasks that are triggered or whose
+   time_left == 0, measure per-task execution time and update counters */
+static int scheduler_step_once(void) {
+    int ran = 0;
 
     for (size_t i = 0; i < task_count; ++i) {
-        if (tasks[i].state == TASK_STATE_READY && tasks[i].time_left == 0) {
+        critical_enter();
+        int due = tasks[i].state == TASK_STATE_READY &&
+                  (__atomic_load_n(&tasks[i].pending, __ATOMIC_ACQUIRE) ||
+                   (tasks[i].period_ms != SCHED_EVENT_TASK && tasks[i].time_left == 0));
+        if (due) {
             tasks[i].state = TASK_STATE_RUNNING;
+            __atomic_exchange_n(&tasks[i].pending, 0, __ATOMIC_ACQ_REL);
+        }
+        critical_exit();
 
-            uint64_t t0 = now_ns();
+        if (due) {
+            TRACE(TRACE_EV_TASK_START, i, tasks[i].run_count);
+            uint64_t t0 = timebase_ticks();
             tasks[i].func();
-            uint64_t t1 = now_ns();
+            uint64_t t1 = timebase_ticks();
+            TRACE(TRACE_EV_TASK_STOP, i, tasks[i].run_count);
 
             tasks[i].run_count++;
-            tasks[i].runtime_ns += (t1 - t0);
+            tasks[i].runtime_ns += timebase_ticks_to_ns(t1 - t0);
 
+            critical_enter();
             tasks[i].time_left = tasks[i].period_ms;
-            tasks[i].state = TASK_STATE_READY;
-            ran_any = 1;
+            if (tasks[i].state == TASK_STATE_RUNNING) tasks[i].state = TASK_STATE_READY;
+            critical_exit();
+            ran++;
         }
     }
 
-    if (ran_any) active_ticks++;
+    if (ran) active_ticks++;
+    return ran;
+}
+
+int scheduler_dispatch(void) {
+    return scheduler_step_once();
 }
 
 /* compute CPU load (percentage of ticks where something ran) */
@@ -94,25 +147,83 @@ size_t scheduler_num_tasks(void) {
     return task_count;
 }
 
+int scheduler_set_rt(const RtConfig *cfg) {
+    if (!cfg) {
+        rt_enabled = 0;
+        return 0;
+    }
+    rt_cfg = *cfg;
+    rt_enabled = 1;
+    if (rt_cfg.lock_memory) rt_host_prefault(tasks, sizeof(tasks));
+    return rt_host_apply(&rt_cfg);
+}
+
+void scheduler_set_telemetry(uint32_t period_ms) {
+    telemetry_period = period_ms;
+    telemetry_countdown = period_ms;
+}
+
+static void scheduler_publish(void) {
+    if (telemetry_period) telemetry_publish(tasks, task_count, total_ticks, active_ticks);
+}
+
+/* called once per tick after the tick counters are updated */
+static void scheduler_after_tick(void) {
+    if (telemetry_period && --telemetry_countdown == 0) {
+        telemetry_countdown = telemetry_period;
+        scheduler_publish();
+    }
+}
+
+static void scheduler_wait_begin(void) {
+    if (rt_enabled) {
+        rt_jitter_reset(&rt_jitter);
+        next_deadline_ns = now_ns();
+    }
+}
+
+/* wait for the next 1ms tick: relative nanosleep by default, absolute
+   deadline (optionally with a final busy-wait) in real-time mode */
+static void scheduler_wait_tick(void) {
+    if (!rt_enabled) {
+        struct timespec ts = {0, 1000000}; /* 1ms */
+        nanosleep(&ts, NULL);
+        return;
+    }
+
+    next_deadline_ns += 1000000ULL;
+    rt_host_sleep_until(next_deadline_ns, rt_cfg.spin_us);
+    uint64_t late = now_ns() - next_deadline_ns;
+    rt_jitter_record(&rt_jitter, late);
+    /* after an overrun longer than a tick, resync instead of bursting */
+    if (late > 1000000ULL) next_deadline_ns += late;
+}
+
+static void scheduler_wait_end(void) {
+    if (rt_enabled) rt_jitter_report("Tick jitter", &rt_jitter);
+}
+
 /* run deterministic for duration_ms milliseconds */
 void scheduler_run_for(uint32_t duration_ms) {
-    struct timespec ts = {0, 1000000}; /* 1ms */
-
     uint32_t ticks_to_run = duration_ms;
     total_ticks = 0;
     active_ticks = 0;
 
     printf("Scheduler: running for %u ms | tasks: %zu\n", duration_ms, task_count);
 
+    scheduler_wait_begin();
     for (uint32_t tick = 0; tick < ticks_to_run; ++tick) {
         scheduler_step_once();
         scheduler_tick();
-        nanosleep(&ts, NULL);
+        scheduler_wait_tick();
         total_ticks++;
+        scheduler_after_tick();
     }
+    scheduler_publish();
 
     printf("Simulation complete. Ticks: %lu | Active ticks: %lu | CPU load: %.2f%%\n",
            (unsigned long)total_ticks, (unsigned long)active_ticks, scheduler_cpu_load());
+    scheduler_wait_end();
     /* print per-task stats */
     for (size_t i = 0; i < task_count; ++i) {
         printf("Task %zu: runs=%" PRIu64 " total_runtime_ms=%.3f\n",
@@ -127,7 +238,6 @@ static void handle_sigint(int sig) {
 }
 
 void scheduler_run(void) {
-    struct timespec ts = {0, 1000000}; /* 1ms */
     total_ticks = 0;
     active_ticks = 0;
     keep_running = 1;
@@ -136,15 +246,19 @@ void scheduler_run(void) {
 
     printf("Scheduler: running until SIGINT (Ctrl+C) | tasks: %zu\n", task_count);
 
+    scheduler_wait_begin();
     while (keep_running) {
         scheduler_step_once();
         scheduler_tick();
-        nanosleep(&ts, NULL);
+        scheduler_wait_tick();
         total_ticks++;
+        scheduler_after_tick();
     }
+    scheduler_publish();
 
     printf("\nScheduler stopped. Ticks: %lu | Active ticks: %lu | CPU load: %.2f%%\n",
            (unsigned long)total_ticks, (unsigned long)active_ticks, scheduler_cpu_load());
+    scheduler_wait_end();
     for (size_t i = 0; i < task_count; ++i) {
         printf("Task %zu: runs=%" PRIu64 " total_runtime_ms=%.3f\n",
                i, tasks[i].run_count, tasks[i].runtime_ns / 1e6);
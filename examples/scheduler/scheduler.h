@@ -3,8 +3,10 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "rt_host.h"
 
 #define SCHED_MAX_TASKS 12
+#define SCHED_EVENT_TASK 0   /* period for tasks that only run when triggered */
 
 typedef void (*TaskFunc)(void);
 
@@ -22,12 +24,14 @@ typedef struct {
     uint32_t    time_left;    /* countdown to next run */
     TaskState   state;        /* ready / running / disabled */
     uint64_t    run_count;    /* how many times executed */
-    uint64_t    runtime_ns;   /* cumulative runtime in nanoseconds */
+    uint64_t    runtime_ns;   /* cumulative runtime in ns, timed with timebase.h */
+    uint32_t    pending;      /* triggers (e.g. from ISRs) not yet serviced */
 } TaskControlBlock;
 
 /* Scheduler API */
 void scheduler_init(void);
 int  scheduler_add(TaskFunc f, uint32_t period_ms); /* returns task id or -1 */
+                                                    /* SCHED_EVENT_TASK: run on trigger only */
 void scheduler_enable(size_t task_id);
 void scheduler_disable(size_t task_id);
 void scheduler_tick(void);      /* call from 1ms tick (internal) */
@@ -36,4 +40,22 @@ void scheduler_run(void);       /* run until SIGINT (Ctrl+C) */
 float scheduler_cpu_load(void); /* last-run CPU load % (0.0..100.0) */
 size_t scheduler_num_tasks(void);
 
+/* ISR-driven use: the tick comes from a timer interrupt/signal and the
+   main loop calls scheduler_dispatch() whenever it is woken up.
+   scheduler_trigger() is safe to call from an ISR/signal handler and
+   makes the task run at the next dispatch. The optional critical-section
+   hooks mask interrupts around task state updates in dispatch. */
+int  scheduler_dispatch(void);  /* run due tasks once, returns number run */
+void scheduler_trigger(size_t task_id);
+void scheduler_set_critical(void (*enter)(void), void (*exit)(void));
+
+/* Opt-in real-time host mode (see rt_host.h). Applies cfg to the calling
+   thread, switches the run loops to absolute 1ms deadlines and reports a
+   tick jitter histogram when a run ends. NULL restores the default loop. */
+int  scheduler_set_rt(const RtConfig *cfg);
+
+/* Publish task counters and CPU load to the shared-memory telemetry
+   page (telemetry.h) every period_ms ticks; 0 disables publishing. */
+void scheduler_set_telemetry(uint32_t period_ms);
+
 #endif
@@ -0,0 +1,123 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "telemetry.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static TelemetryPage *page = NULL;
+static const MemPool *pools[TELEMETRY_MAX_POOLS];
+static char pool_names[TELEMETRY_MAX_POOLS][TELEMETRY_NAME_LEN];
+static size_t pool_count = 0;
+
+static uint64_t telemetry_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int telemetry_open(void) {
+    /* a segment left by a crashed writer may hold a half-written seqlock
+     * (odd seq) or an older layout: never attach to it, start a new one.
+     * Readers still mapping the old object keep it until they reopen. */
+    if (shm_unlink(TELEMETRY_SHM_NAME) != 0 && errno != ENOENT)
+        fprintf(stderr, "Telemetry: cannot remove stale segment (%s)\n", strerror(errno));
+    int fd = shm_open(TELEMETRY_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Telemetry: shm_open failed (%s)\n", strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(TelemetryPage)) != 0) {
+        fprintf(stderr, "Telemetry: ftruncate failed (%s)\n", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    void *p = mmap(NULL, sizeof(TelemetryPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "Telemetry: mmap failed (%s)\n", strerror(errno));
+        return -1;
+    }
+
+    page = (TelemetryPage *)p;
+    memset(page, 0, sizeof(*page));         /* seq 0: even, nothing in flight */
+    page->version = TELEMETRY_VERSION;
+    page->writer_pid = (uint32_t)getpid();
+    /* readers check magic last: publish it once the page is initialised */
+    __atomic_store_n(&page->magic, TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void telemetry_close(void) {
+    if (!page) return;
+    munmap(page, sizeof(TelemetryPage));
+    shm_unlink(TELEMETRY_SHM_NAME);
+    page = NULL;
+    pool_count = 0;
+}
+
+int telemetry_add_pool(const char *name, const MemPool *mp) {
+    if (!mp || pool_count >= TELEMETRY_MAX_POOLS) return -1;
+    pools[pool_count] = mp;
+    strncpy(pool_names[pool_count], name ? name : "pool", TELEMETRY_NAME_LEN - 1);
+    return (int)pool_count++;
+}
+
+void telemetry_publish(const TaskControlBlock *tasks, size_t count,
+                       uint64_t total_ticks, uint64_t active_ticks) {
+    if (!page) return;
+    if (count > SCHED_MAX_TASKS) count = SCHED_MAX_TASKS;
+
+    /* seqlock write: odd seq marks the payload as in-flux */
+    uint32_t seq = page->seq;
+    __atomic_store_n(&page->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    page->publish_count++;
+    page->publish_ns = telemetry_now_ns();
+    page->total_ticks = total_ticks;
+    page->active_ticks = active_ticks;
+    page->cpu_load = total_ticks ? (float)active_ticks * 100.0f / (float)total_ticks : 0.0f;
+    page->num_tasks = (uint32_t)count;
+    for (size_t i = 0; i < count; ++i) {
+        page->task[i].period_ms = tasks[i].period_ms;
+        page->task[i].state = (uint32_t)tasks[i].state;
+        page->task[i].run_count = tasks[i].run_count;
+        page->task[i].runtime_ns = tasks[i].runtime_ns;
+    }
+    page->num_pools = (uint32_t)pool_count;
+    for (size_t i = 0; i < pool_count; ++i) {
+        TelemetryPool *tp = &page->pool[i];
+        memcpy(tp->name, pool_names[i], TELEMETRY_NAME_LEN);
+        tp->block_size = pools[i]->block_size;
+        tp->total_blocks = pools[i]->total_blocks;
+        tp->free_blocks = pools[i]->free_blocks;
+        tp->alloc_count = pools[i]->alloc_count;
+        tp->free_count = pools[i]->free_count;
+        tp->failed_allocs = pools[i]->failed_allocs;
+    }
+
+    __atomic_store_n(&page->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+int telemetry_read(const volatile TelemetryPage *src, TelemetryPage *out) {
+    int retries = 0;
+    if (__atomic_load_n(&src->magic, __ATOMIC_ACQUIRE) != TELEMETRY_MAGIC) return -1;
+
+    while (retries < TELEMETRY_READ_RETRIES) {
+        uint32_t s1 = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1u) == 0) {
+            memcpy(out, (const void *)src, sizeof(*out));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            uint32_t s2 = __atomic_load_n(&src->seq, __ATOMIC_RELAXED);
+            if (s1 == s2) return retries;
+        }
+        retries++;
+    }
+    return TELEMETRY_BUSY;
+}
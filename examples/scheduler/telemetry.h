@@ -0,0 +1,78 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "scheduler.h"
+#include "mem_pool.h"
+
+/*
+ * Live telemetry page: scheduler and pool statistics published into a
+ * POSIX shared-memory object so external readers can watch them without
+ * stopping the process.
+ *
+ * The page is guarded by a seqlock: the writer bumps `seq` to an odd
+ * value, updates the payload, then bumps it to even again. It never
+ * waits for readers; readers retry until they see the same even `seq`
+ * before and after copying (telemetry_read()), at most
+ * TELEMETRY_READ_RETRIES times, so a writer that died mid-update (seq
+ * left odd) cannot hang them.
+ */
+
+#define TELEMETRY_SHM_NAME   "/evara_sched_telemetry"
+#define TELEMETRY_MAGIC      0x4D4C4554u  /* "TELM" */
+#define TELEMETRY_VERSION    1
+#define TELEMETRY_MAX_POOLS  4
+#define TELEMETRY_NAME_LEN   16
+
+typedef struct {
+    uint32_t period_ms;
+    uint32_t state;        /* TaskState */
+    uint64_t run_count;
+    uint64_t runtime_ns;
+} TelemetryTask;
+
+typedef struct {
+    char     name[TELEMETRY_NAME_LEN];
+    uint64_t block_size;
+    uint64_t total_blocks;
+    uint64_t free_blocks;
+    uint64_t alloc_count;
+    uint64_t free_count;
+    uint64_t failed_allocs;
+} TelemetryPool;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;            /* seqlock sequence, odd while being written */
+    uint32_t writer_pid;
+    uint64_t publish_count;
+    uint64_t publish_ns;     /* CLOCK_MONOTONIC of the last publish */
+    uint64_t total_ticks;
+    uint64_t active_ticks;
+    float    cpu_load;       /* percent */
+    uint32_t num_tasks;
+    uint32_t num_pools;
+    uint32_t reserved;
+    TelemetryTask task[SCHED_MAX_TASKS];
+    TelemetryPool pool[TELEMETRY_MAX_POOLS];
+} TelemetryPage;
+
+/* writer side (the scheduler process) */
+int  telemetry_open(void);                 /* create + map the page, 0 on success */
+void telemetry_close(void);                /* unmap and unlink */
+int  telemetry_add_pool(const char *name, const MemPool *mp); /* returns slot or -1 */
+void telemetry_publish(const TaskControlBlock *tasks, size_t count,
+                       uint64_t total_ticks, uint64_t active_ticks);
+
+#define TELEMETRY_READ_RETRIES 10000
+#define TELEMETRY_BUSY         (-2)
+
+/* reader side: consistent copy of a mapped page; returns number of
+   retries needed, -1 if the page is not a telemetry page, or
+   TELEMETRY_BUSY if no consistent copy was seen within
+   TELEMETRY_READ_RETRIES attempts (*out is then unspecified) */
+int  telemetry_read(const volatile TelemetryPage *page, TelemetryPage *out);
+
+#endif
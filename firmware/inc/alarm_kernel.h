@@ -0,0 +1,50 @@
+#ifndef ALARM_KERNEL_H
+#define ALARM_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Batch alarm evaluation over structure-of-arrays sample blocks.
+ *
+ * Instead of branching on one sample at a time, a block of n samples is
+ * compared against the limits channel by channel and each sample gets a
+ * bitmask of the alarms it raised. The caller then walks the (mostly zero)
+ * masks and emits messages, keeping printing/logging out of the hot loop.
+ *
+ * alarm_eval() picks the widest kernel the CPU supports at run time
+ * (AVX2, then SSE2 on x86) and falls back to a branch-free scalar loop,
+ * which is also what MCU targets build. All kernels give identical masks;
+ * comparisons with NaN never raise an alarm.
+ */
+
+#define ALARM_TEMP_HIGH   0x01u   /* temperature > temp_high */
+#define ALARM_PRESS_HIGH  0x02u   /* pressure    > press_high */
+#define ALARM_FLOW_LOW    0x04u   /* flow        < flow_low */
+
+typedef struct {
+    float temp_high;
+    float press_high;
+    float flow_low;
+} AlarmLimits;
+
+/* mask[i] receives the alarm bits of sample i; returns samples with any bit set */
+size_t alarm_eval(const AlarmLimits *lim, const float *temp, const float *press,
+                  const float *flow, size_t n, uint8_t *mask);
+
+const char *alarm_kernel_name(void);   /* kernel alarm_eval() dispatches to */
+
+/* individual kernels (benchmarks, tests) */
+size_t alarm_eval_scalar(const AlarmLimits *lim, const float *temp, const float *press,
+                         const float *flow, size_t n, uint8_t *mask);
+
+#if defined(__GNUC__) && defined(__x86_64__)   /* SSE2 is baseline there */
+#define ALARM_KERNEL_X86 1
+size_t alarm_eval_sse2(const AlarmLimits *lim, const float *temp, const float *press,
+                       const float *flow, size_t n, uint8_t *mask);
+size_t alarm_eval_avx2(const AlarmLimits *lim, const float *temp, const float *press,
+                       const float *flow, size_t n, uint8_t *mask);
+int    alarm_kernel_has_avx2(void);
+#endif
+
+#endif
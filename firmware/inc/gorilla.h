@@ -0,0 +1,77 @@
+#ifndef GORILLA_H
+#define GORILLA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Gorilla-style time series compression (Pelkonen et al., VLDB 2015).
+ *
+ * Timestamps: rounded to a tick (gorilla_ts_init), then delta-of-delta
+ * with variable-length prefixes
+ *     '0'                   dod == 0 (regular sampling)
+ *     '10'   + 7 bits       |dod| small
+ *     '110'  + 9 bits
+ *     '1110' + 12 bits
+ *     '1111' + 64 bits      anything else
+ * The buckets are sized in ticks. Nanosecond timestamps taken by a timer
+ * jitter by microseconds, so with a 1 ns tick nearly every dod escapes to
+ * 64 bits. A 1 us tick brings typical jitter into the 7/9-bit buckets.
+ * Decoded timestamps are multiples of the tick; tick 0 or 1 is lossless.
+ * Floats (32-bit): XOR with the previous value
+ *     '0'                   same value
+ *     '10'   + meaningful   bits inside the previous leading/trailing window
+ *     '11'   + 5b leading zeros + 5b (length - 1) + meaningful bits
+ *
+ * Encoders/decoders keep a few bytes of state per column and write into a
+ * caller-provided byte buffer, so the codec runs on the MCU as well.
+ */
+
+typedef struct {
+    uint8_t *buf;
+    size_t   cap;       /* bytes */
+    size_t   bitpos;
+    int      overflow;  /* a write did not fit in cap */
+} GorillaBitWriter;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t   len;       /* bytes */
+    size_t   bitpos;
+    int      error;     /* read past the end */
+} GorillaBitReader;
+
+typedef struct {
+    uint64_t prev;      /* in ticks */
+    int64_t  prev_delta;
+    uint32_t count;
+    uint64_t tick;      /* timestamp units per tick, 0 = 1 */
+} GorillaTsState;
+
+typedef struct {
+    uint32_t prev;
+    uint8_t  lead;
+    uint8_t  trail;
+    uint32_t count;
+} GorillaF32State;
+
+/* worst-case encoded size in bytes of n timestamps / n floats */
+#define GORILLA_TS_MAX_BYTES(n)  ((((size_t)(n) * 68u) + 7u) / 8u + 8u)
+#define GORILLA_F32_MAX_BYTES(n) ((((size_t)(n) * 44u) + 7u) / 8u + 8u)
+
+void     gorilla_writer_init(GorillaBitWriter *bw, uint8_t *buf, size_t cap);
+void     gorilla_put_bits(GorillaBitWriter *bw, uint64_t value, unsigned nbits);
+size_t   gorilla_writer_bytes(const GorillaBitWriter *bw);
+
+void     gorilla_reader_init(GorillaBitReader *br, const uint8_t *buf, size_t len);
+uint64_t gorilla_get_bits(GorillaBitReader *br, unsigned nbits);
+
+/* state must start zeroed (or from gorilla_ts_init); use one state per
+   column for encode and decode, with the same tick on both sides */
+void     gorilla_ts_init(GorillaTsState *st, uint64_t tick);
+void     gorilla_encode_ts(GorillaTsState *st, GorillaBitWriter *bw, uint64_t ts);
+uint64_t gorilla_decode_ts(GorillaTsState *st, GorillaBitReader *br);
+void     gorilla_encode_f32(GorillaF32State *st, GorillaBitWriter *bw, float value);
+float    gorilla_decode_f32(GorillaF32State *st, GorillaBitReader *br);
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef POLICY_RING_H
+#define POLICY_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "spsc_ring.h"
+
+/*
+ * SPSC ring with a selectable overflow policy (what a push does when the
+ * consumer falls behind) and a high-watermark callback.
+ *
+ *   POLICY_DROP_NEWEST  a push into a full ring is refused (plain SPSC)
+ *   POLICY_DROP_OLDEST  the oldest element is evicted to make room; the
+ *                       consumer pops with a CAS (spsc_push_evict)
+ *   POLICY_BLOCK        the producer waits for room, polling every
+ *                       block_poll_ns, for at most block_timeout_ns; the
+ *                       sample is dropped when the wait times out. Never
+ *                       use it from an ISR.
+ *   POLICY_DECIMATE     above the high watermark only every Kth sample is
+ *                       offered; K rises linearly from 2 at the watermark to
+ *                       decimate_max at full, and returns to 1 below the
+ *                       low watermark. What still finds the ring full is
+ *                       dropped as newest.
+ *
+ * on_watermark(ctx, 1, fill) is called from the producer when the fill
+ * reaches high_watermark, and on_watermark(ctx, 0, fill) once it has come
+ * back down to low_watermark (hysteresis), so an upstream stage can shed
+ * load or slow down before anything is lost. The fill is checked on each
+ * push: a cached count that is exact once it reaches the threshold, so
+ * pushes below the watermark do not touch the consumer's cache line.
+ *
+ * Counters are per cause and written by the producer only; read them after
+ * the producer stops, or accept a snapshot.
+ */
+
+typedef enum {
+    POLICY_DROP_NEWEST = 0,
+    POLICY_DROP_OLDEST,
+    POLICY_BLOCK,
+    POLICY_DECIMATE
+} RingPolicy;
+
+typedef void (*PolicyWatermarkFn)(void *ctx, int high, size_t fill);
+
+typedef struct {
+    RingPolicy policy;
+    size_t   high_watermark;    /* 0: 3/4 of capacity */
+    size_t   low_watermark;     /* 0: 1/2 of capacity */
+    uint64_t block_timeout_ns;  /* POLICY_BLOCK: longest wait per push */
+    uint64_t block_poll_ns;     /* POLICY_BLOCK: sleep between checks */
+    uint32_t decimate_max;      /* POLICY_DECIMATE: K at full (>= 2) */
+    PolicyWatermarkFn on_watermark;   /* optional */
+    void    *ctx;
+} PolicyRingConfig;
+
+typedef struct {
+    unsigned long long offered;        /* policy_ring_push() calls */
+    unsigned long long pushed;         /* accepted into the ring */
+    unsigned long long dropped_newest; /* refused: ring full */
+    unsigned long long dropped_oldest; /* evicted by a newer sample */
+    unsigned long long decimated;      /* skipped by decimation */
+    unsigned long long blocked;        /* pushes that had to wait */
+    unsigned long long timeouts;       /* dropped after waiting block_timeout_ns */
+    unsigned long long wait_ns;        /* total time spent waiting */
+    unsigned long high_events;         /* high watermark crossings */
+    size_t max_fill;
+} PolicyRingStats;
+
+typedef struct {
+    SpscRing ring;
+    PolicyRingConfig cfg;
+    /* producer state */
+    int      above;             /* between the high and the low crossing */
+    uint32_t decimate_k;        /* current K, 1 = keep all */
+    uint32_t decimate_phase;
+    PolicyRingStats stats;
+} PolicyRing;
+
+void policy_ring_default_config(PolicyRingConfig *cfg);   /* drop newest, 100 ms block, K <= 8 */
+
+/* storage as for spsc_init(); watermarks are clamped to the capacity.
+   Returns 0 on success, -1 on bad arguments. */
+int    policy_ring_init(PolicyRing *r, void *storage, size_t capacity, size_t elem_size,
+                        const PolicyRingConfig *cfg);
+int    policy_ring_parse(PolicyRingConfig *cfg, const char *spec); /* "newest", "block:MS", ... */
+const char *policy_ring_name(RingPolicy policy);
+
+/* producer: 1 = in the ring, 0 = dropped (the counters say why) */
+int    policy_ring_push(PolicyRing *r, const void *elem);
+
+/* consumer */
+size_t policy_ring_pop_batch(PolicyRing *r, void *elems, size_t n);
+
+/* either side (a snapshot) */
+size_t policy_ring_count(const PolicyRing *r);
+unsigned long long policy_ring_lost(const PolicyRing *r);   /* all causes together */
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Lock-free single-producer / single-consumer ring buffer.
+ *
+ * - Capacity is a power of two; indices are free-running counters and a
+ *   slot is found with `index & mask` (no modulo, no wasted slot).
+ * - The producer owns `head`, the consumer owns `tail`; each publishes
+ *   its counter with a release store and reads the other's with an
+ *   acquire load, so one ISR/thread may push while another pops.
+ * - Each side caches the other's counter and only re-reads it when the
+ *   cached value says full/empty, keeping shared cache lines quiet.
+ * - Elements are fixed-size and copied by value; storage is supplied by
+ *   the caller (static array on the MCU, malloc on the host).
+ */
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    /* producer side */
+    size_t  head;        /* next slot to write */
+    size_t  tail_cache;  /* producer's last view of tail */
+    uint8_t pad0[SPSC_CACHE_LINE - 2 * sizeof(size_t)];
+
+    /* consumer side */
+    size_t  tail;        /* next slot to read */
+    size_t  head_cache;  /* consumer's last view of head */
+    uint8_t pad1[SPSC_CACHE_LINE - 2 * sizeof(size_t)];
+
+    /* constant after spsc_init */
+    uint8_t *buf;
+    size_t   elem_size;
+    size_t   mask;       /* capacity - 1 */
+    uint16_t trace_id;   /* queue id in TRACE_EV_QUEUE_* events */
+} SpscRing;
+
+/* a contiguous run of `count` elements starting at `data` */
+typedef struct {
+    void  *data;
+    size_t count;
+} SpscSpan;
+
+/* storage must hold capacity * elem_size bytes; capacity must be a
+   power of two. Returns 0 on success, -1 on bad arguments. */
+int    spsc_init(SpscRing *r, void *storage, size_t capacity, size_t elem_size);
+size_t spsc_round_capacity(size_t n);   /* smallest power of two >= n */
+
+/* producer */
+int    spsc_push(SpscRing *r, const void *elem);                  /* 1 = pushed, 0 = full */
+size_t spsc_push_batch(SpscRing *r, const void *elems, size_t n); /* returns number pushed */
+size_t spsc_fill(SpscRing *r, size_t threshold);  /* fill, exact once >= threshold (below: upper bound) */
+
+/* consumer */
+int    spsc_pop(SpscRing *r, void *elem);                         /* 1 = popped, 0 = empty */
+size_t spsc_pop_batch(SpscRing *r, void *elems, size_t n);        /* returns number popped */
+size_t spsc_peek(SpscRing *r, SpscSpan spans[2]);                 /* zero-copy view, oldest first */
+void   spsc_consume(SpscRing *r, size_t n);                       /* release n peeked elements */
+
+/* overwrite mode: a full ring evicts its oldest element instead of
+   refusing the new one. The producer then moves `tail` too (CAS), so the
+   consumer must use spsc_pop_batch_cas(), which copies first and retries
+   if the slots were evicted under it; peek/consume and plain pops are not
+   safe in this mode. */
+int    spsc_push_evict(SpscRing *r, const void *elem);            /* 1 = the oldest was evicted */
+size_t spsc_pop_batch_cas(SpscRing *r, void *elems, size_t n);    /* returns number popped */
+
+/* either side (a snapshot) */
+size_t spsc_count(const SpscRing *r);
+size_t spsc_capacity(const SpscRing *r);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+/*
+ * Cheap high-resolution timebase shared by the scheduler and the loggers.
+ *
+ * timebase_now_ns() is one counter read and a fixed-point multiply with
+ * cached factors (ns = ticks * mult >> shift). The counter is the TSC on
+ * x86 hosts whose TSC is invariant (constant rate, runs in deep C-states),
+ * calibrated against CLOCK_MONOTONIC by timebase_init(); otherwise it is
+ * CLOCK_MONOTONIC itself, which Linux serves from the vDSO without a
+ * syscall. Either way the values are on the CLOCK_MONOTONIC scale, so they
+ * can be compared with clock_nanosleep() deadlines, up to the calibration
+ * error (a few ppm) that accumulates since timebase_init().
+ *
+ * timebase_wall_ns() is nanoseconds since the Unix epoch: timebase_now_ns()
+ * plus an offset to CLOCK_REALTIME that is re-measured at most every
+ * TIMEBASE_ANCHOR_NS by the first caller that finds it stale. Calibration
+ * error and NTP adjustments therefore never build up beyond one anchor
+ * period; wall time may step when the anchor moves, monotonic time never.
+ *
+ * Before timebase_init() (or without it) the timebase reads CLOCK_MONOTONIC.
+ * Call timebase_init() before starting threads; everything else is thread
+ * safe.
+ */
+
+#define TIMEBASE_NS_PER_S   1000000000ULL
+#define TIMEBASE_ANCHOR_NS  TIMEBASE_NS_PER_S   /* wall clock re-anchor period */
+
+typedef enum {
+    TIMEBASE_AUTO = 0,      /* TSC if invariant, else CLOCK_MONOTONIC */
+    TIMEBASE_TSC,           /* TSC even if not flagged invariant (x86 only) */
+    TIMEBASE_MONOTONIC      /* always CLOCK_MONOTONIC */
+} TimebaseSource;
+
+typedef struct {
+    int      tsc;               /* counter is the TSC, else CLOCK_MONOTONIC ns */
+    uint32_t mult;              /* ns = ticks * mult >> shift */
+    uint32_t shift;
+    uint64_t base_ticks;        /* counter at calibration ... */
+    uint64_t base_ns;           /* ... and CLOCK_MONOTONIC at that moment */
+    uint64_t hz;                /* counter ticks per second */
+    int64_t  wall_offset_ns;    /* CLOCK_REALTIME - timebase_now_ns(), atomic */
+    uint64_t anchor_ns;         /* timebase_now_ns() of the last anchor, atomic */
+} Timebase;
+
+extern Timebase timebase_state;
+
+/* Calibrate once per process (later calls return at once); 0 on success,
+   -1 if the requested source is not available (the clock is used instead).
+   Calibration sleeps ~10 ms. */
+int  timebase_init(TimebaseSource source);
+const char *timebase_source_name(void);   /* "tsc" or "clock_monotonic" */
+void timebase_anchor(void);               /* re-measure the wall clock offset now */
+uint64_t timebase_clock_ns(void);         /* CLOCK_MONOTONIC, the reference */
+
+static inline uint64_t timebase_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (timebase_state.tsc) return (uint64_t)__builtin_ia32_rdtsc();
+#endif
+    return timebase_clock_ns();
+}
+
+/* 32x32 partial products, so no 128-bit arithmetic and no overflow for
+   deltas of years */
+static inline uint64_t timebase_ticks_to_ns(uint64_t ticks) {
+    uint64_t hi = ticks >> 32, lo = ticks & 0xffffffffULL;
+    return ((hi * timebase_state.mult) << (32 - timebase_state.shift)) +
+           ((lo * timebase_state.mult) >> timebase_state.shift);
+}
+
+static inline uint64_t timebase_now_ns(void) {
+    return timebase_state.base_ns + timebase_ticks_to_ns(timebase_ticks() - timebase_state.base_ticks);
+}
+
+static inline uint64_t timebase_wall_ns(void) {
+    uint64_t now = timebase_now_ns();
+    uint64_t anchor = __atomic_load_n(&timebase_state.anchor_ns, __ATOMIC_RELAXED);
+    if ((int64_t)(now - anchor) >= (int64_t)TIMEBASE_ANCHOR_NS) {
+        timebase_anchor();
+        now = timebase_now_ns();
+    }
+    return now + (uint64_t)__atomic_load_n(&timebase_state.wall_offset_ns, __ATOMIC_RELAXED);
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Low-overhead binary event trace.
+ *
+ * Events are 16-byte records written into a preallocated, power-of-two
+ * ring (flight recorder: the oldest events are overwritten). Recording is
+ * one atomic increment, a raw timestamp read and a 16-byte store, so it is
+ * safe from ISRs/signal handlers and costs a few ns.
+ *
+ * Compiled out entirely unless TRACE_ENABLE is defined (make TRACE=1):
+ * TRACE() then expands to nothing and no call sites pay anything.
+ */
+
+typedef enum {
+    TRACE_EV_NONE = 0,
+    TRACE_EV_TICK,          /* id: -,        arg: tick number (low 32 bits) */
+    TRACE_EV_TASK_START,    /* id: task id,  arg: run count */
+    TRACE_EV_TASK_STOP,     /* id: task id,  arg: run count */
+    TRACE_EV_TASK_ENABLE,   /* id: task id */
+    TRACE_EV_TASK_DISABLE,  /* id: task id */
+    TRACE_EV_QUEUE_PUSH,    /* id: queue id, arg: items pushed */
+    TRACE_EV_QUEUE_POP,     /* id: queue id, arg: items popped */
+    TRACE_EV_QUEUE_FULL,    /* id: queue id, arg: items rejected */
+    TRACE_EV_POOL_FAIL,     /* id: -,        arg: failed allocations so far */
+    TRACE_EV_USER,          /* free for application markers */
+    TRACE_EV_COUNT
+} TraceEventType;
+
+typedef struct {
+    uint64_t ts;      /* raw timestamp in the ring, ns in a dump file */
+    uint16_t type;    /* TraceEventType */
+    uint16_t id;
+    uint32_t arg;
+} TraceEvent;
+
+/* Dump file: header followed by `count` TraceEvent records, oldest first */
+#define TRACE_FILE_MAGIC   0x43525445u  /* "ETRC" */
+#define TRACE_FILE_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t event_size;
+    uint64_t count;
+    uint64_t dropped;   /* events overwritten before the dump */
+} TraceFileHeader;
+
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 16384u  /* events, must be a power of two */
+#endif
+
+/* Raw timestamp source. A target may define TRACE_TIMESTAMP() (e.g. as
+   DWT->CYCCNT) and call trace_set_clock_hz(); hosts read the timebase
+   counter (TSC or CLOCK_MONOTONIC) and convert it with the timebase's
+   mult/shift, so traces and logs share one calibration (timebase.h). */
+#ifndef TRACE_TIMESTAMP
+#include "timebase.h"
+#define TRACE_TIMEBASE 1
+#define TRACE_TIMESTAMP() timebase_ticks()
+#endif
+
+extern TraceEvent trace_ring[TRACE_RING_SIZE];
+extern uint64_t   trace_head;
+
+void   trace_init(void);                 /* clear ring, timebase_init() on hosts */
+void   trace_set_clock_hz(uint64_t hz);  /* timestamp ticks per second (MCU targets) */
+size_t trace_snapshot(TraceEvent *out, size_t max); /* copy oldest-first, ts in ns */
+int    trace_dump(const char *path);     /* write a dump file; 0 on success */
+
+static inline void trace_record(uint16_t type, uint16_t id, uint32_t arg) {
+    uint64_t slot = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    TraceEvent *e = &trace_ring[slot & (TRACE_RING_SIZE - 1)];
+    e->ts = TRACE_TIMESTAMP();
+    e->type = type;
+    e->id = id;
+    e->arg = arg;
+}
+
+#ifdef TRACE_ENABLE
+#define TRACE(type, id, arg) trace_record((uint16_t)(type), (uint16_t)(id), (uint32_t)(arg))
+#else
+#define TRACE(type, id, arg) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+#include "alarm_kernel.h"
+
+#ifdef ALARM_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+/* Branch-free: each comparison becomes 0/1 and is shifted into place, so
+   the compiler can vectorise the loop where the target allows it. */
+size_t alarm_eval_scalar(const AlarmLimits *lim, const float *temp, const float *press,
+                         const float *flow, size_t n, uint8_t *mask) {
+    const float th = lim->temp_high, ph = lim->press_high, fl = lim->flow_low;
+    size_t hits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t m = (uint8_t)((temp[i] > th) | ((press[i] > ph) << 1) | ((flow[i] < fl) << 2));
+        mask[i] = m;
+        hits += m != 0;
+    }
+    return hits;
+}
+
+#ifdef ALARM_KERNEL_X86
+
+/* 16 samples per iteration: 4 compare vectors of 4 -> 16 mask bytes */
+__attribute__((target("sse2")))
+size_t alarm_eval_sse2(const AlarmLimits *lim, const float *temp, const float *press,
+                       const float *flow, size_t n, uint8_t *mask) {
+    const __m128 th = _mm_set1_ps(lim->temp_high);
+    const __m128 ph = _mm_set1_ps(lim->press_high);
+    const __m128 fl = _mm_set1_ps(lim->flow_low);
+    const __m128i b0 = _mm_set1_epi32(ALARM_TEMP_HIGH);
+    const __m128i b1 = _mm_set1_epi32(ALARM_PRESS_HIGH);
+    const __m128i b2 = _mm_set1_epi32(ALARM_FLOW_LOW);
+    const __m128i zero = _mm_setzero_si128();
+    size_t hits = 0, i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i m[4];
+        for (int k = 0; k < 4; ++k) {
+            size_t j = i + (size_t)k * 4;
+            __m128i t = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(temp + j), th)), b0);
+            __m128i p = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(press + j), ph)), b1);
+            __m128i f = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(flow + j), fl)), b2);
+            m[k] = _mm_or_si128(_mm_or_si128(t, p), f);
+        }
+        /* 4x4 int32 -> 16 bytes (values are 0..7, so saturation never kicks in) */
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(m[0], m[1]), _mm_packs_epi32(m[2], m[3]));
+        _mm_storeu_si128((__m128i *)(mask + i), bytes);
+        unsigned quiet = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+        hits += 16u - (size_t)__builtin_popcount(quiet);
+    }
+    return hits + alarm_eval_scalar(lim, temp + i, press + i, flow + i, n - i, mask + i);
+}
+
+/* 32 samples per iteration: 4 compare vectors of 8 -> 32 mask bytes */
+__attribute__((target("avx2")))
+size_t alarm_eval_avx2(const AlarmLimits *lim, const float *temp, const float *press,
+                       const float *flow, size_t n, uint8_t *mask) {
+    const __m256 th = _mm256_set1_ps(lim->temp_high);
+    const __m256 ph = _mm256_set1_ps(lim->press_high);
+    const __m256 fl = _mm256_set1_ps(lim->flow_low);
+    const __m256i b0 = _mm256_set1_epi32(ALARM_TEMP_HIGH);
+    const __m256i b1 = _mm256_set1_epi32(ALARM_PRESS_HIGH);
+    const __m256i b2 = _mm256_set1_epi32(ALARM_FLOW_LOW);
+    const __m256i zero = _mm256_setzero_si256();
+    /* packs/packus work per 128-bit lane; this restores sample order */
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t hits = 0, i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i m[4];
+        for (int k = 0; k < 4; ++k) {
+            size_t j = i + (size_t)k * 8;
+            __m256i t = _mm256_and_si256(_mm256_castps_si256(
+                _mm256_cmp_ps(_mm256_loadu_ps(temp + j), th, _CMP_GT_OQ)), b0);
+            __m256i p = _mm256_and_si256(_mm256_castps_si256(
+                _mm256_cmp_ps(_mm256_loadu_ps(press + j), ph, _CMP_GT_OQ)), b1);
+            __m256i f = _mm256_and_si256(_mm256_castps_si256(
+                _mm256_cmp_ps(_mm256_loadu_ps(flow + j), fl, _CMP_LT_OQ)), b2);
+            m[k] = _mm256_or_si256(_mm256_or_si256(t, p), f);
+        }
+        __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(m[0], m[1]),
+                                            _mm256_packs_epi32(m[2], m[3]));
+        bytes = _mm256_permutevar8x32_epi32(bytes, order);
+        _mm256_storeu_si256((__m256i *)(mask + i), bytes);
+        unsigned quiet = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, zero));
+        hits += 32u - (size_t)__builtin_popcount(quiet);
+    }
+    return hits + alarm_eval_sse2(lim, temp + i, press + i, flow + i, n - i, mask + i);
+}
+
+int alarm_kernel_has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+}
+
+size_t alarm_eval(const AlarmLimits *lim, const float *temp, const float *press,
+                  const float *flow, size_t n, uint8_t *mask) {
+    if (alarm_kernel_has_avx2()) return alarm_eval_avx2(lim, temp, press, flow, n, mask);
+    return alarm_eval_sse2(lim, temp, press, flow, n, mask);
+}
+
+const char *alarm_kernel_name(void) {
+    return alarm_kernel_has_avx2() ? "avx2" : "sse2";
+}
+
+#else
+
+size_t alarm_eval(const AlarmLimits *lim, const float *temp, const float *press,
+                  const float *flow, size_t n, uint8_t *mask) {
+    return alarm_eval_scalar(lim, temp, press, flow, n, mask);
+}
+
+const char *alarm_kernel_name(void) {
+    return "scalar";
+}
+
+#endif
@@ -0,0 +1,23 @@
+#include "crc32.h"
+
+static uint32_t crc_table[256];
+static int crc_table_ready = 0;
+
+static void crc32_build_table(void) {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crc_table[i] = c;
+    }
+    crc_table_ready = 1;
+}
+
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    if (!crc_table_ready) crc32_build_table();
+
+    crc = ~crc;
+    while (len--) crc = crc_table[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
@@ -0,0 +1,192 @@
+#include "gorilla.h"
+#include <string.h>
+
+void gorilla_writer_init(GorillaBitWriter *bw, uint8_t *buf, size_t cap) {
+    bw->buf = buf;
+    bw->cap = cap;
+    bw->bitpos = 0;
+    bw->overflow = 0;
+    memset(buf, 0, cap);
+}
+
+void gorilla_put_bits(GorillaBitWriter *bw, uint64_t value, unsigned nbits) {
+    if (nbits == 0) return;
+    if (bw->bitpos + nbits > bw->cap * 8u) {
+        bw->overflow = 1;
+        return;
+    }
+    /* MSB first; buffer is pre-zeroed so only set bits are written */
+    while (nbits > 0) {
+        size_t byte = bw->bitpos >> 3;
+        unsigned used = (unsigned)(bw->bitpos & 7u);
+        unsigned room = 8u - used;
+        unsigned take = nbits < room ? nbits : room;
+        uint8_t chunk = (uint8_t)((value >> (nbits - take)) & ((1u << take) - 1u));
+        bw->buf[byte] |= (uint8_t)(chunk << (room - take));
+        bw->bitpos += take;
+        nbits -= take;
+    }
+}
+
+size_t gorilla_writer_bytes(const GorillaBitWriter *bw) {
+    return (bw->bitpos + 7u) >> 3;
+}
+
+void gorilla_reader_init(GorillaBitReader *br, const uint8_t *buf, size_t len) {
+    br->buf = buf;
+    br->len = len;
+    br->bitpos = 0;
+    br->error = 0;
+}
+
+uint64_t gorilla_get_bits(GorillaBitReader *br, unsigned nbits) {
+    uint64_t v = 0;
+    if (br->bitpos + nbits > br->len * 8u) {
+        br->error = 1;
+        return 0;
+    }
+    while (nbits > 0) {
+        size_t byte = br->bitpos >> 3;
+        unsigned used = (unsigned)(br->bitpos & 7u);
+        unsigned room = 8u - used;
+        unsigned take = nbits < room ? nbits : room;
+        uint8_t chunk = (uint8_t)((br->buf[byte] >> (room - take)) & ((1u << take) - 1u));
+        v = (v << take) | chunk;
+        br->bitpos += take;
+        nbits -= take;
+    }
+    return v;
+}
+
+/* zigzag maps signed to unsigned so small magnitudes need few bits */
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1u);
+}
+
+void gorilla_ts_init(GorillaTsState *st, uint64_t tick) {
+    memset(st, 0, sizeof(*st));
+    st->tick = tick;
+}
+
+void gorilla_encode_ts(GorillaTsState *st, GorillaBitWriter *bw, uint64_t ts) {
+    if (st->tick > 1) ts = ts / st->tick + (ts % st->tick >= (st->tick + 1) / 2);   /* nearest tick */
+    if (st->count == 0) {
+        gorilla_put_bits(bw, ts, 64);
+    } else {
+        int64_t delta = (int64_t)(ts - st->prev);
+        uint64_t zz = zigzag(delta - st->prev_delta);
+        if (zz == 0) {
+            gorilla_put_bits(bw, 0x0, 1);
+        } else if (zz < (1u << 7)) {
+            gorilla_put_bits(bw, 0x2, 2);
+            gorilla_put_bits(bw, zz, 7);
+        } else if (zz < (1u << 9)) {
+            gorilla_put_bits(bw, 0x6, 3);
+            gorilla_put_bits(bw, zz, 9);
+        } else if (zz < (1u << 12)) {
+            gorilla_put_bits(bw, 0xE, 4);
+            gorilla_put_bits(bw, zz, 12);
+        } else {
+            gorilla_put_bits(bw, 0xF, 4);
+            gorilla_put_bits(bw, zz, 64);
+        }
+        st->prev_delta = delta;
+    }
+    st->prev = ts;
+    st->count++;
+}
+
+uint64_t gorilla_decode_ts(GorillaTsState *st, GorillaBitReader *br) {
+    uint64_t ts;
+    if (st->count == 0) {
+        ts = gorilla_get_bits(br, 64);
+    } else {
+        unsigned width = 0;
+        if (gorilla_get_bits(br, 1) == 0) width = 0;
+        else if (gorilla_get_bits(br, 1) == 0) width = 7;
+        else if (gorilla_get_bits(br, 1) == 0) width = 9;
+        else if (gorilla_get_bits(br, 1) == 0) width = 12;
+        else width = 64;
+        int64_t dod = width ? unzigzag(gorilla_get_bits(br, width)) : 0;
+        st->prev_delta += dod;
+        ts = st->prev + (uint64_t)st->prev_delta;
+    }
+    st->prev = ts;
+    st->count++;
+    return st->tick > 1 ? ts * st->tick : ts;
+}
+
+static unsigned clz32(uint32_t v) {
+    return v ? (unsigned)__builtin_clz(v) : 32u;
+}
+
+static unsigned ctz32(uint32_t v) {
+    return v ? (unsigned)__builtin_ctz(v) : 32u;
+}
+
+void gorilla_encode_f32(GorillaF32State *st, GorillaBitWriter *bw, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if (st->count == 0) {
+        gorilla_put_bits(bw, bits, 32);
+        st->lead = 0xFF;   /* no window yet */
+    } else {
+        uint32_t x = bits ^ st->prev;
+        if (x == 0) {
+            gorilla_put_bits(bw, 0x0, 1);
+        } else {
+            unsigned lead = clz32(x), trail = ctz32(x);
+            if (lead > 31) lead = 31;
+            if (st->lead != 0xFF && lead >= st->lead && trail >= st->trail) {
+                /* fits the previous window: reuse it */
+                unsigned len = 32u - st->lead - st->trail;
+                gorilla_put_bits(bw, 0x2, 2);
+                gorilla_put_bits(bw, x >> st->trail, len);
+            } else {
+                unsigned len = 32u - lead - trail;
+                gorilla_put_bits(bw, 0x3, 2);
+                gorilla_put_bits(bw, lead, 5);
+                gorilla_put_bits(bw, len - 1u, 5);
+                gorilla_put_bits(bw, x >> trail, len);
+                st->lead = (uint8_t)lead;
+                st->trail = (uint8_t)trail;
+            }
+        }
+    }
+    st->prev = bits;
+    st->count++;
+}
+
+float gorilla_decode_f32(GorillaF32State *st, GorillaBitReader *br) {
+    uint32_t bits;
+    if (st->count == 0) {
+        bits = (uint32_t)gorilla_get_bits(br, 32);
+    } else if (gorilla_get_bits(br, 1) == 0) {
+        bits = st->prev;
+    } else {
+        if (gorilla_get_bits(br, 1) == 1) {
+            unsigned lead = (unsigned)gorilla_get_bits(br, 5);
+            unsigned len = (unsigned)gorilla_get_bits(br, 5) + 1u;
+            if (lead + len > 32u) {   /* corrupt stream */
+                br->error = 1;
+                len = 32u - lead;
+            }
+            st->lead = (uint8_t)lead;
+            st->trail = (uint8_t)(32u - lead - len);
+        }
+        unsigned len = 32u - st->lead - st->trail;
+        uint32_t x = (uint32_t)gorilla_get_bits(br, len) << st->trail;
+        bits = st->prev ^ x;
+    }
+    st->prev = bits;
+    st->count++;
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
@@ -1,4 +1,5 @@
 #include "mem_pool.h"
+#include "trace.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -23,6 +24,7 @@ void *mem_alloc(MemPool *mp) {
         }
     }
     mp->failed_allocs++;
+    TRACE(TRACE_EV_POOL_FAIL, 0, mp->failed_allocs);
     return NULL;
 }
 
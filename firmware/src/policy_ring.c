@@ -0,0 +1,145 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "policy_ring.h"
+#include "timebase.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+void policy_ring_default_config(PolicyRingConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->policy = POLICY_DROP_NEWEST;
+    cfg->block_timeout_ns = 100000000ULL;
+    cfg->block_poll_ns = 50000ULL;
+    cfg->decimate_max = 8;
+}
+
+int policy_ring_init(PolicyRing *r, void *storage, size_t capacity, size_t elem_size,
+                     const PolicyRingConfig *cfg) {
+    memset(r, 0, sizeof(*r));
+    if (spsc_init(&r->ring, storage, capacity, elem_size) != 0) return -1;
+    r->cfg = *cfg;
+    if (r->cfg.high_watermark == 0 || r->cfg.high_watermark > capacity)
+        r->cfg.high_watermark = capacity - capacity / 4;
+    if (r->cfg.low_watermark == 0 || r->cfg.low_watermark >= r->cfg.high_watermark)
+        r->cfg.low_watermark = capacity / 2 < r->cfg.high_watermark ? capacity / 2
+                                                                     : r->cfg.high_watermark - 1;
+    if (r->cfg.decimate_max < 2) r->cfg.decimate_max = 2;
+    if (r->cfg.block_poll_ns == 0) r->cfg.block_poll_ns = 1000;
+    r->decimate_k = 1;
+    return 0;
+}
+
+static const char *const policy_names[] = { "newest", "oldest", "block", "decimate" };
+
+const char *policy_ring_name(RingPolicy policy) {
+    return (unsigned)policy < sizeof(policy_names) / sizeof(policy_names[0])
+           ? policy_names[policy] : "?";
+}
+
+/* "newest" | "oldest" | "block[:MS]" | "decimate[:K]" */
+int policy_ring_parse(PolicyRingConfig *cfg, const char *spec) {
+    const char *arg = strchr(spec, ':');
+    size_t len = arg ? (size_t)(arg - spec) : strlen(spec);
+    unsigned long v = 0;
+    if (arg) {
+        char *end;
+        v = strtoul(arg + 1, &end, 10);
+        if (end == arg + 1 || *end != '\0') return -1;
+    }
+    for (unsigned p = 0; p < sizeof(policy_names) / sizeof(policy_names[0]); ++p) {
+        if (strlen(policy_names[p]) != len || strncmp(spec, policy_names[p], len) != 0) continue;
+        cfg->policy = (RingPolicy)p;
+        if (!arg) return 0;
+        if (p == POLICY_BLOCK) cfg->block_timeout_ns = (uint64_t)v * 1000000ULL;
+        else if (p == POLICY_DECIMATE && v >= 2) cfg->decimate_max = (uint32_t)v;
+        else return -1;
+        return 0;
+    }
+    return -1;
+}
+
+/* Hysteresis on the fill seen by the producer; updates K for decimation */
+static void policy_ring_watermark(PolicyRing *r) {
+    PolicyRingConfig *c = &r->cfg;
+    size_t fill = spsc_fill(&r->ring, r->above ? c->low_watermark : c->high_watermark);
+    if (fill > r->stats.max_fill) r->stats.max_fill = fill;
+
+    if (!r->above && fill >= c->high_watermark) {
+        r->above = 1;
+        r->stats.high_events++;
+        if (c->on_watermark) c->on_watermark(c->ctx, 1, fill);
+    } else if (r->above && fill <= c->low_watermark) {
+        r->above = 0;
+        if (c->on_watermark) c->on_watermark(c->ctx, 0, fill);
+    }
+
+    if (c->policy == POLICY_DECIMATE) {
+        size_t cap = spsc_capacity(&r->ring), hi = c->high_watermark;
+        size_t over = fill > hi ? fill - hi : 0;
+        r->decimate_k = !r->above ? 1
+            : 2 + (uint32_t)((uint64_t)(c->decimate_max - 2) * over / (cap > hi ? cap - hi : 1));
+    }
+}
+
+/* POLICY_BLOCK: retry until there is room or the timeout runs out */
+static int policy_ring_wait(PolicyRing *r, const void *elem) {
+    uint64_t t0 = timebase_now_ns(), now = t0;
+    struct timespec nap = { (time_t)(r->cfg.block_poll_ns / TIMEBASE_NS_PER_S),
+                            (long)(r->cfg.block_poll_ns % TIMEBASE_NS_PER_S) };
+    int ok = 0;
+    r->stats.blocked++;
+    while (!ok && now - t0 < r->cfg.block_timeout_ns) {
+        nanosleep(&nap, NULL);
+        ok = spsc_push(&r->ring, elem);
+        now = timebase_now_ns();
+    }
+    r->stats.wait_ns += now - t0;
+    if (!ok) r->stats.timeouts++;
+    return ok;
+}
+
+int policy_ring_push(PolicyRing *r, const void *elem) {
+    int ok;
+    r->stats.offered++;
+    policy_ring_watermark(r);
+
+    switch (r->cfg.policy) {
+    case POLICY_DROP_OLDEST:
+        if (spsc_push_evict(&r->ring, elem)) r->stats.dropped_oldest++;
+        r->stats.pushed++;
+        return 1;
+    case POLICY_BLOCK:
+        ok = spsc_push(&r->ring, elem) || policy_ring_wait(r, elem);
+        break;
+    case POLICY_DECIMATE:
+        if (++r->decimate_phase < r->decimate_k) {
+            r->stats.decimated++;
+            return 0;
+        }
+        r->decimate_phase = 0;
+        ok = spsc_push(&r->ring, elem);
+        if (!ok) r->stats.dropped_newest++;
+        break;
+    default:
+        ok = spsc_push(&r->ring, elem);
+        if (!ok) r->stats.dropped_newest++;
+        break;
+    }
+    if (ok) r->stats.pushed++;
+    return ok;
+}
+
+size_t policy_ring_pop_batch(PolicyRing *r, void *elems, size_t n) {
+    return r->cfg.policy == POLICY_DROP_OLDEST ? spsc_pop_batch_cas(&r->ring, elems, n)
+                                               : spsc_pop_batch(&r->ring, elems, n);
+}
+
+size_t policy_ring_count(const PolicyRing *r) {
+    return spsc_count(&r->ring);
+}
+
+unsigned long long policy_ring_lost(const PolicyRing *r) {
+    const PolicyRingStats *s = &r->stats;
+    return s->dropped_newest + s->dropped_oldest + s->decimated + s->timeouts;
+}
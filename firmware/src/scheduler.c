@@ -1,4 +1,5 @@
 #include "scheduler.h"
+#include "trace.h"
 #include <stdint.h>
 
 static volatile uint32_t tick_ms = 0;
@@ -24,6 +25,7 @@ void scheduler_add(uint8_t id, TaskFunc func, uint32_t period_ms) {
 
 void scheduler_tick(void) {
     tick_ms++;
+    TRACE(TRACE_EV_TICK, 0, tick_ms);
     for (int i = 0; i < MAX_TASKS; i++) {
         if (tasks[i].func) {
             tasks[i].elapsed++;
@@ -39,7 +41,9 @@ void scheduler_dispatch(void) {
     for (int i = 0; i < MAX_TASKS; i++) {
         if (tasks[i].ready && tasks[i].func) {
             tasks[i].ready = 0;
+            TRACE(TRACE_EV_TASK_START, i, 0);
             tasks[i].func();
+            TRACE(TRACE_EV_TASK_STOP, i, 0);
         }
     }
 }
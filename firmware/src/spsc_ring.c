@@ -0,0 +1,179 @@
+#include "spsc_ring.h"
+#include "trace.h"
+#include <string.h>
+
+#define LOAD_ACQ(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_REL(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+int spsc_init(SpscRing *r, void *storage, size_t capacity, size_t elem_size) {
+    if (!r || !storage || elem_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return -1;
+    memset(r, 0, sizeof(*r));
+    r->buf = (uint8_t *)storage;
+    r->elem_size = elem_size;
+    r->mask = capacity - 1;
+    return 0;
+}
+
+size_t spsc_round_capacity(size_t n) {
+    size_t c = 1;
+    while (c < n) c <<= 1;
+    return c;
+}
+
+/* copy n elements in from `src` starting at free-running index `at`,
+   splitting at the wrap point */
+static void spsc_copy_in(SpscRing *r, size_t at, const uint8_t *src, size_t n) {
+    size_t cap = r->mask + 1;
+    size_t off = at & r->mask;
+    size_t first = n < cap - off ? n : cap - off;
+    memcpy(r->buf + off * r->elem_size, src, first * r->elem_size);
+    if (n > first) memcpy(r->buf, src + first * r->elem_size, (n - first) * r->elem_size);
+}
+
+static void spsc_copy_out(const SpscRing *r, size_t at, uint8_t *dst, size_t n) {
+    size_t cap = r->mask + 1;
+    size_t off = at & r->mask;
+    size_t first = n < cap - off ? n : cap - off;
+    memcpy(dst, r->buf + off * r->elem_size, first * r->elem_size);
+    if (n > first) memcpy(dst + first * r->elem_size, r->buf, (n - first) * r->elem_size);
+}
+
+/* free slots as seen by the producer, refreshing the cached tail if needed */
+static size_t spsc_free_slots(SpscRing *r, size_t head, size_t want) {
+    size_t cap = r->mask + 1;
+    size_t free_slots = cap - (head - r->tail_cache);
+    if (free_slots < want) {
+        r->tail_cache = LOAD_ACQ(&r->tail);
+        free_slots = cap - (head - r->tail_cache);
+    }
+    return free_slots;
+}
+
+/* filled slots as seen by the consumer, refreshing the cached head if needed */
+static size_t spsc_used_slots(SpscRing *r, size_t tail, size_t want) {
+    size_t used = r->head_cache - tail;
+    if (used < want) {
+        r->head_cache = LOAD_ACQ(&r->head);
+        used = r->head_cache - tail;
+    }
+    return used;
+}
+
+int spsc_push(SpscRing *r, const void *elem) {
+    size_t head = r->head;
+    if (spsc_free_slots(r, head, 1) == 0) {
+        TRACE(TRACE_EV_QUEUE_FULL, r->trace_id, 1);
+        return 0;
+    }
+    memcpy(r->buf + (head & r->mask) * r->elem_size, elem, r->elem_size);
+    STORE_REL(&r->head, head + 1);
+    TRACE(TRACE_EV_QUEUE_PUSH, r->trace_id, 1);
+    return 1;
+}
+
+size_t spsc_push_batch(SpscRing *r, const void *elems, size_t n) {
+    size_t head = r->head;
+    size_t free_slots = spsc_free_slots(r, head, n);
+    if (n > free_slots) {
+        TRACE(TRACE_EV_QUEUE_FULL, r->trace_id, n - free_slots);
+        n = free_slots;
+    }
+    if (n == 0) return 0;
+    spsc_copy_in(r, head, (const uint8_t *)elems, n);
+    STORE_REL(&r->head, head + n);
+    TRACE(TRACE_EV_QUEUE_PUSH, r->trace_id, n);
+    return n;
+}
+
+size_t spsc_fill(SpscRing *r, size_t threshold) {
+    size_t head = r->head;
+    if (head - r->tail_cache >= threshold) r->tail_cache = LOAD_ACQ(&r->tail);
+    return head - r->tail_cache;
+}
+
+int spsc_push_evict(SpscRing *r, const void *elem) {
+    size_t head = r->head;
+    size_t tail = LOAD_ACQ(&r->tail);
+    int evicted = 0;
+    if (head - tail > r->mask) {
+        /* fails only if the consumer popped it first: then there is room */
+        evicted = __atomic_compare_exchange_n(&r->tail, &tail, tail + 1, 0,
+                                              __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+        if (evicted) TRACE(TRACE_EV_QUEUE_FULL, r->trace_id, 1);
+    }
+    memcpy(r->buf + (head & r->mask) * r->elem_size, elem, r->elem_size);
+    STORE_REL(&r->head, head + 1);
+    TRACE(TRACE_EV_QUEUE_PUSH, r->trace_id, 1);
+    return evicted;
+}
+
+size_t spsc_pop_batch_cas(SpscRing *r, void *elems, size_t n) {
+    for (;;) {
+        size_t tail = LOAD_ACQ(&r->tail);
+        size_t used = LOAD_ACQ(&r->head) - tail;
+        if (used > r->mask + 1) continue;   /* evicted between the two loads */
+        size_t k = n < used ? n : used;
+        if (k == 0) return 0;
+        /* the copy may race with an eviction overwriting these slots; the
+           CAS then fails and the torn copy is thrown away */
+        spsc_copy_out(r, tail, (uint8_t *)elems, k);
+        if (__atomic_compare_exchange_n(&r->tail, &tail, tail + k, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            TRACE(TRACE_EV_QUEUE_POP, r->trace_id, k);
+            return k;
+        }
+    }
+}
+
+int spsc_pop(SpscRing *r, void *elem) {
+    size_t tail = r->tail;
+    if (spsc_used_slots(r, tail, 1) == 0) return 0;
+    memcpy(elem, r->buf + (tail & r->mask) * r->elem_size, r->elem_size);
+    STORE_REL(&r->tail, tail + 1);
+    TRACE(TRACE_EV_QUEUE_POP, r->trace_id, 1);
+    return 1;
+}
+
+size_t spsc_pop_batch(SpscRing *r, void *elems, size_t n) {
+    size_t tail = r->tail;
+    size_t used = spsc_used_slots(r, tail, n);
+    if (n > used) n = used;
+    if (n == 0) return 0;
+    spsc_copy_out(r, tail, (uint8_t *)elems, n);
+    STORE_REL(&r->tail, tail + n);
+    TRACE(TRACE_EV_QUEUE_POP, r->trace_id, n);
+    return n;
+}
+
+size_t spsc_peek(SpscRing *r, SpscSpan spans[2]) {
+    size_t tail = r->tail;
+    size_t used = spsc_used_slots(r, tail, r->mask + 1);
+    size_t cap = r->mask + 1;
+    size_t off = tail & r->mask;
+    size_t first = used < cap - off ? used : cap - off;
+
+    spans[0].data = r->buf + off * r->elem_size;
+    spans[0].count = first;
+    spans[1].data = r->buf;
+    spans[1].count = used - first;
+    return used;
+}
+
+void spsc_consume(SpscRing *r, size_t n) {
+    size_t tail = r->tail;
+    size_t used = spsc_used_slots(r, tail, n);
+    if (n > used) n = used;
+    STORE_REL(&r->tail, tail + n);
+    TRACE(TRACE_EV_QUEUE_POP, r->trace_id, n);
+}
+
+size_t spsc_count(const SpscRing *r) {
+    size_t tail = LOAD_ACQ(&r->tail);
+    size_t head = LOAD_ACQ(&r->head);
+    return head - tail;
+}
+
+size_t spsc_capacity(const SpscRing *r) {
+    return r->mask + 1;
+}
@@ -0,0 +1,100 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "timebase.h"
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define TIMEBASE_HAVE_TSC 1
+#endif
+
+#define CALIBRATE_NS 10000000ULL    /* TSC measured against the clock over 10 ms */
+
+/* Until timebase_init(): counter = CLOCK_MONOTONIC, ns = ticks * 2^31 >> 31 */
+Timebase timebase_state = { 0, 1u << 31, 31, 0, 0, TIMEBASE_NS_PER_S, 0, 0 };
+
+static int initialised = 0;
+
+uint64_t timebase_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* largest shift (<= 32) whose multiplier still fits in 32 bits */
+static void set_hz(uint64_t hz) {
+    double ns_per_tick = 1e9 / (double)hz;
+    uint32_t shift = 32;
+    while (shift > 0 && ns_per_tick * (double)(1ULL << shift) >= 4294967295.0) shift--;
+    timebase_state.hz = hz;
+    timebase_state.shift = shift;
+    timebase_state.mult = (uint32_t)(ns_per_tick * (double)(1ULL << shift) + 0.5);
+}
+
+#ifdef TIMEBASE_HAVE_TSC
+/* CPUID 0x80000007 EDX bit 8: invariant TSC */
+static int tsc_invariant(void) {
+    unsigned a, b, c, d;
+    if (!__get_cpuid(0x80000007, &a, &b, &c, &d)) return 0;
+    return (d >> 8) & 1;
+}
+
+/* TSC at the moment the clock was read: the midpoint of the tightest of a
+   few bracketing TSC pairs */
+static void tsc_clock_pair(uint64_t *tsc, uint64_t *ns) {
+    uint64_t best = ~0ULL;
+    for (int i = 0; i < 5; ++i) {
+        uint64_t a = __builtin_ia32_rdtsc();
+        uint64_t t = timebase_clock_ns();
+        uint64_t b = __builtin_ia32_rdtsc();
+        if (b - a < best) {
+            best = b - a;
+            *tsc = a + (b - a) / 2;
+            *ns = t;
+        }
+    }
+}
+
+static int calibrate_tsc(void) {
+    uint64_t c0, t0, c1, t1;
+    struct timespec nap = { 0, (long)CALIBRATE_NS };
+    tsc_clock_pair(&c0, &t0);
+    nanosleep(&nap, NULL);
+    tsc_clock_pair(&c1, &t1);
+    if (c1 <= c0 || t1 <= t0) return -1;
+    set_hz((uint64_t)((double)(c1 - c0) * 1e9 / (double)(t1 - t0) + 0.5));
+    timebase_state.base_ticks = c1;
+    timebase_state.base_ns = t1;
+    timebase_state.tsc = 1;
+    return 0;
+}
+#endif
+
+int timebase_init(TimebaseSource source) {
+    if (initialised) return 0;
+    initialised = 1;
+    int rc = source == TIMEBASE_TSC ? -1 : 0;
+#ifdef TIMEBASE_HAVE_TSC
+    if (source == TIMEBASE_TSC || (source == TIMEBASE_AUTO && tsc_invariant()))
+        rc = calibrate_tsc();
+#endif
+    timebase_anchor();
+    return rc;
+}
+
+const char *timebase_source_name(void) {
+    return timebase_state.tsc ? "tsc" : "clock_monotonic";
+}
+
+/* CLOCK_REALTIME read between two timebase reads: the offset is taken
+   against their midpoint */
+void timebase_anchor(void) {
+    struct timespec ts;
+    uint64_t n0 = timebase_now_ns();
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t n1 = timebase_now_ns();
+    uint64_t wall = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    __atomic_store_n(&timebase_state.wall_offset_ns, (int64_t)(wall - (n0 + (n1 - n0) / 2)),
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&timebase_state.anchor_ns, n1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,66 @@
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+TraceEvent trace_ring[TRACE_RING_SIZE];
+uint64_t   trace_head = 0;
+
+static uint64_t trace_epoch = 0;        /* raw timestamp at trace_init() */
+static double   trace_ns_per_tick = 1.0;
+
+void trace_set_clock_hz(uint64_t hz) {
+    if (hz) trace_ns_per_tick = 1e9 / (double)hz;
+}
+
+static uint64_t trace_ticks_to_ns(uint64_t ticks) {
+#ifdef TRACE_TIMEBASE
+    return timebase_ticks_to_ns(ticks);
+#else
+    return (uint64_t)((double)ticks * trace_ns_per_tick);
+#endif
+}
+
+void trace_init(void) {
+    memset(trace_ring, 0, sizeof(trace_ring));
+    __atomic_store_n(&trace_head, 0, __ATOMIC_RELAXED);
+#ifdef TRACE_TIMEBASE
+    timebase_init(TIMEBASE_AUTO);       /* once per process, shared with the loggers */
+#endif
+    trace_epoch = TRACE_TIMESTAMP();
+}
+
+size_t trace_snapshot(TraceEvent *out, size_t max) {
+    uint64_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    uint64_t n = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+    if (n > max) n = max;
+
+    uint64_t first = head - n;
+    for (uint64_t i = 0; i < n; ++i) {
+        TraceEvent e = trace_ring[(first + i) & (TRACE_RING_SIZE - 1)];
+        e.ts = e.ts > trace_epoch ? trace_ticks_to_ns(e.ts - trace_epoch) : 0;
+        out[i] = e;
+    }
+    return (size_t)n;
+}
+
+int trace_dump(const char *path) {
+    static TraceEvent snap[TRACE_RING_SIZE];
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+
+    uint64_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    size_t n = trace_snapshot(snap, TRACE_RING_SIZE);
+
+    TraceFileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = TRACE_FILE_MAGIC;
+    hdr.version = TRACE_FILE_VERSION;
+    hdr.event_size = (uint16_t)sizeof(TraceEvent);
+    hdr.count = n;
+    hdr.dropped = head - n;
+
+    int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+             fwrite(snap, sizeof(TraceEvent), n, f) == n;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
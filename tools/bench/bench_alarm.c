@@ -0,0 +1,119 @@
+/*
+ * bench_alarm: samples/s of the batch alarm kernels (firmware/inc/alarm_kernel.h)
+ * against the original per-sample branchy check over SensorData structs.
+ *
+ * Every kernel's masks are compared with the scalar reference first.
+ * Limits are the sensor logger's (80 °C, 9 bar, 10 L/min) and readings use
+ * generateSensorData() ranges, so roughly a third of the samples alarm.
+ *
+ * Usage: bench_alarm [-n samples] [-b block]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "alarm_kernel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    float temperature;
+    float pressure;
+    float flow;
+    unsigned long timestamp;
+} SensorData;
+
+typedef size_t (*AlarmKernel)(const AlarmLimits *, const float *, const float *,
+                              const float *, size_t, uint8_t *);
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static const AlarmLimits limits = { 80.0f, 9.0f, 10.0f };
+static volatile size_t sink;
+
+// The checkAlarms() shape: one struct at a time, one branch per limit
+static size_t branchy(const SensorData *d, size_t n, uint8_t *mask) {
+    size_t hits = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t m = 0;
+        if (d[i].temperature > limits.temp_high) m |= ALARM_TEMP_HIGH;
+        if (d[i].pressure > limits.press_high) m |= ALARM_PRESS_HIGH;
+        if (d[i].flow < limits.flow_low) m |= ALARM_FLOW_LOW;
+        mask[i] = m;
+        if (m) hits++;
+    }
+    return hits;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 200000000;
+    size_t block = 4096;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) block = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-n samples] [-b block]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (block == 0) block = 1;
+    unsigned long rounds = n / block ? n / block : 1;
+
+    SensorData *aos = malloc(block * sizeof(*aos));
+    float *temp = malloc(block * sizeof(float));
+    float *press = malloc(block * sizeof(float));
+    float *flow = malloc(block * sizeof(float));
+    uint8_t *ref = malloc(block), *mask = malloc(block);
+    if (!aos || !temp || !press || !flow || !ref || !mask) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+    srand(1);
+    for (size_t i = 0; i < block; i++) {
+        aos[i].temperature = temp[i] = 20.0f + (rand() % 800) / 10.0f;
+        aos[i].pressure = press[i] = 1.0f + (rand() % 90) / 10.0f;
+        aos[i].flow = flow[i] = (rand() % 1000) / 10.0f;
+        aos[i].timestamp = 1700000000ul + i;
+    }
+    size_t ref_hits = alarm_eval_scalar(&limits, temp, press, flow, block, ref);
+
+    printf("%lu samples in blocks of %zu, %.1f%% alarming, dispatch -> %s\n",
+           rounds * block, block, 100.0 * ref_hits / block, alarm_kernel_name());
+
+    double t0 = now_s();
+    for (unsigned long r = 0; r < rounds; r++) sink = branchy(aos, block, mask);
+    double base = rounds * block / (now_s() - t0);
+    printf("%-24s %8.1f M samples/s  %s\n", "branchy AoS (old path)", base / 1e6,
+           memcmp(mask, ref, block) == 0 ? "" : "MISMATCH");
+
+    struct { const char *name; AlarmKernel fn; } kernels[] = {
+        { "scalar SoA", alarm_eval_scalar },
+#ifdef ALARM_KERNEL_X86
+        { "sse2 SoA", alarm_eval_sse2 },
+        { "avx2 SoA", alarm_kernel_has_avx2() ? alarm_eval_avx2 : NULL },
+#endif
+        { "alarm_eval (dispatch)", alarm_eval },
+    };
+    int failed = 0;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!kernels[k].fn) continue;
+        memset(mask, 0xFF, block);
+        size_t hits = kernels[k].fn(&limits, temp, press, flow, block, mask);
+        int ok = hits == ref_hits && memcmp(mask, ref, block) == 0;
+        failed |= !ok;
+
+        t0 = now_s();
+        for (unsigned long r = 0; r < rounds; r++)
+            sink = kernels[k].fn(&limits, temp, press, flow, block, mask);
+        double rate = rounds * block / (now_s() - t0);
+        printf("%-24s %8.1f M samples/s  %5.1fx  %s\n", kernels[k].name, rate / 1e6,
+               rate / base, ok ? "" : "MISMATCH");
+    }
+
+    free(aos); free(temp); free(press); free(flow); free(ref); free(mask);
+    return failed;
+}
@@ -0,0 +1,161 @@
+/*
+ * bench_binlog: disk footprint and encode/decode speed of the columnar
+ * Gorilla-compressed sensor log (binlog.h) against data_log.csv.
+ *
+ * Timestamps are what the loggers write: ns since the epoch from a 1 s
+ * sampling timer that wakes 20-80 us late, and 1% of the time up to 1 ms
+ * late. Two signal shapes are measured:
+ *  - slow:   plant-like random walk quantised to 0.01 (what real sensors log)
+ *  - random: the uniform noise of generateSensorData() (worst case for XOR)
+ * Both are written with the loggers' 1 us timestamp tick (BINLOG_TICK_NS);
+ * "slow exact" repeats slow with exact ns timestamps to show what the tick
+ * saves. Round trips must match (timestamps to the tick).
+ *
+ * check: with the 1 us tick the timestamp column must stay within
+ * TS_BOUND_BYTES per sample; the exit status is 1 otherwise.
+ *
+ * Usage: bench_binlog [-n samples] [-d dir]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "binlog.h"
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t rng_state = 12345u;
+static uint32_t rng(void) {   // xorshift32, reproducible across runs
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+#define EPOCH_NS        1700000000000000000ull
+#define PERIOD_NS       1000000000ull
+#define TS_BOUND_BYTES  2.0
+
+static float quantise(float v) {
+    return roundf(v * 100.0f) / 100.0f;
+}
+
+static void generate(SensorData *d, unsigned long n, int slow) {
+    float t = 55.0f, p = 5.0f, f = 50.0f;
+    for (unsigned long i = 0; i < n; i++) {
+        if (slow) {
+            // most readings repeat, the rest move by a step or two
+            if (rng() % 4 == 0) t += (float)((int)(rng() % 5) - 2) * 0.01f;
+            if (rng() % 8 == 0) p += (float)((int)(rng() % 3) - 1) * 0.01f;
+            if (rng() % 4 == 0) f += (float)((int)(rng() % 5) - 2) * 0.01f;
+            d[i].temperature = quantise(t);
+            d[i].pressure = quantise(p);
+            d[i].flow = quantise(f);
+        } else {
+            d[i].temperature = 20.0f + (rng() % 800) / 10.0f;
+            d[i].pressure = 1.0f + (rng() % 90) / 10.0f;
+            d[i].flow = (rng() % 1000) / 10.0f;
+        }
+        // the timer fires late: 20-80 us, now and then up to 1 ms
+        uint64_t late = 20000u + rng() % 60000u;
+        if (rng() % 100 == 0) late += rng() % 1000000u;
+        d[i].timestamp = EPOCH_NS + i * PERIOD_NS + late;
+    }
+}
+
+static uint64_t to_tick(uint64_t ts, uint32_t tick) {
+    return tick > 1 ? (ts / tick + (ts % tick >= (tick + 1) / 2)) * tick : ts;
+}
+
+// Returns the timestamp column's bytes per sample
+static double run(const char *label, const char *path, const SensorData *d, unsigned long n,
+                  uint32_t tick) {
+    long long csv_bytes = 0;
+    char line[128];
+    for (unsigned long i = 0; i < n; i++) {
+        csv_bytes += snprintf(line, sizeof(line), "%.2f,%.2f,%.2f,%" PRIu64 "\n",
+                              d[i].temperature, d[i].pressure, d[i].flow, d[i].timestamp);
+    }
+
+    BinlogWriter w;
+    double t0 = now_s();
+    if (binlog_open(&w, path, 0, tick, NULL) != 0) {
+        perror(path);
+        return -1.0;
+    }
+    for (unsigned long i = 0; i < n; i++) binlog_append(&w, &d[i]);
+    binlog_close(&w);
+    double enc_s = now_s() - t0;
+
+    BinlogReader r;
+    SensorData s;
+    unsigned long mismatches = 0, got = 0;
+    t0 = now_s();
+    if (binlog_reader_open(&r, path) != 0) {
+        fprintf(stderr, "%s: cannot reopen\n", path);
+        return -1.0;
+    }
+    while (binlog_read(&r, &s) == 1) {
+        if (got >= n || s.timestamp != to_tick(d[got].timestamp, tick) || s.temperature != d[got].temperature ||
+            s.pressure != d[got].pressure || s.flow != d[got].flow)
+            mismatches++;
+        got++;
+    }
+    binlog_reader_close(&r);
+    double dec_s = now_s() - t0;
+
+    double ts_per_sample = (double)w.column_bytes[0] / n;
+    printf("%-10s | csv %10lld B | bin %10llu B (%5.2f B/sample, ts %4.2f) | %5.1fx smaller | "
+           "encode %6.1f M/s | decode %6.1f M/s | %s\n",
+           label, csv_bytes, w.bytes, (double)w.bytes / n, ts_per_sample,
+           (double)csv_bytes / w.bytes, n / enc_s / 1e6, got / dec_s / 1e6,
+           got == n && mismatches == 0 ? "round trip ok" : "MISMATCH");
+    return got == n && mismatches == 0 ? ts_per_sample : -1.0;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 1000000;
+    const char *dir = "/tmp";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) dir = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-n samples] [-d dir]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n == 0) n = 1;
+
+    SensorData *d = (SensorData *)malloc(n * sizeof(SensorData));
+    if (!d) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+    char path[512];
+    snprintf(path, sizeof(path), "%s/bench_binlog.bin", dir);
+
+    printf("%lu samples, 1 s sampling with timer jitter, ns timestamps, %d samples per segment\n",
+           n, BINLOG_DEFAULT_SEGMENT);
+    generate(d, n, 1);
+    double slow_ts = run("slow", path, d, n, BINLOG_TICK_NS);
+    run("slow exact", path, d, n, 0);
+    generate(d, n, 0);
+    double random_ts = run("random", path, d, n, BINLOG_TICK_NS);
+
+    int ok = slow_ts >= 0.0 && slow_ts <= TS_BOUND_BYTES && random_ts >= 0.0 &&
+             random_ts <= TS_BOUND_BYTES;
+    printf("check: timestamps at %u ns tick <= %.1f B/sample: %s\n", BINLOG_TICK_NS,
+           TS_BOUND_BYTES, ok ? "ok" : "FAILED");
+
+    remove(path);
+    free(d);
+    return ok ? 0 : 1;
+}
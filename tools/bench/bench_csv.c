@@ -0,0 +1,165 @@
+/*
+ * bench_csv: rows/s of the table-driven SensorData CSV encoder
+ * (examples/memory/embedded_style/sensor_csv.h) against fprintf/snprintf
+ * with "%.2f,%.2f,%.2f,%" PRIu64 "\n".
+ *
+ * Before timing, the encoder output is compared byte for byte with
+ * snprintf over logger-like readings, random float bit patterns and
+ * rounding ties. Any mismatch is printed and the benchmark fails.
+ *
+ * Usage: bench_csv [-n rows]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_csv.h"
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static uint64_t rng(void) {   // xorshift64
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static float random_bits_float(void) {
+    uint32_t bits = (uint32_t)rng();
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static int check_row(const SensorData *d) {
+    char want[256], got[SENSOR_CSV_MAX_ROW + 1];
+    int n = snprintf(want, sizeof(want), "%.2f,%.2f,%.2f,%" PRIu64 "\n",
+                     d->temperature, d->pressure, d->flow, d->timestamp);
+    size_t len = sensor_csv_row(got, d);
+    got[len] = '\0';
+    if ((size_t)n != len || memcmp(want, got, len) != 0) {
+        fprintf(stderr, "MISMATCH\n  printf:  %s  encoder: %s", want, got);
+        return 0;
+    }
+    return 1;
+}
+
+static unsigned long verify(unsigned long n) {
+    unsigned long failures = 0;
+    SensorData d;
+    // rounding ties and signed zeros
+    static const float edge[] = { 0.0f, -0.0f, 0.005f, 0.015f, 0.125f, 0.375f, 2.675f,
+                                  -0.001f, -0.005f, 99.995f, 1e-30f, 123456.785f,
+                                  16777216.0f, 1e15f, 1e20f, 3.4e38f, -3.4e38f };
+    for (size_t i = 0; i < sizeof(edge) / sizeof(edge[0]); i++) {
+        d.temperature = edge[i];
+        d.pressure = -edge[i];
+        d.flow = edge[i] * 3.0f;
+        d.timestamp = (uint64_t)i * 1234567891ull;
+        failures += !check_row(&d);
+    }
+    for (unsigned long i = 0; i < n && failures < 10; i++) {
+        d.temperature = 20.0f + (rng() % 800) / 10.0f;      // generateSensorData() ranges
+        d.pressure = 1.0f + (rng() % 9000) / 1000.0f;
+        d.flow = (float)(rng() % 100000) / 997.0f;
+        d.timestamp = (uint64_t)rng();
+        failures += !check_row(&d);
+
+        d.temperature = random_bits_float();                 // any finite float
+        d.pressure = random_bits_float();
+        d.flow = random_bits_float();
+        if (d.temperature != d.temperature) d.temperature = 1.0f;   // keep NaN sign out of it
+        if (d.pressure != d.pressure) d.pressure = 2.0f;
+        if (d.flow != d.flow) d.flow = 3.0f;
+        failures += !check_row(&d);
+    }
+    return failures;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 5000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-n rows]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n == 0) n = 1;
+
+    unsigned long failures = verify(n / 5 + 1000);
+    printf("verify: %s (%lu random rows x2 + edge cases)\n",
+           failures ? "FAILED" : "byte-identical", n / 5 + 1000);
+    if (failures) return 1;
+
+    // logger-like rows, generated up front so only formatting is timed
+    SensorData *rows = (SensorData *)malloc(4096 * sizeof(SensorData));
+    char *out = (char *)malloc(4096 * SENSOR_CSV_MAX_ROW);
+    if (!rows || !out) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+    for (int i = 0; i < 4096; i++) {
+        rows[i].temperature = 20.0f + (rng() % 800) / 10.0f;
+        rows[i].pressure = 1.0f + (rng() % 90) / 10.0f;
+        rows[i].flow = (rng() % 1000) / 10.0f;
+        rows[i].timestamp = 1700000000ull + (uint64_t)i;
+    }
+
+    FILE *null = fopen("/dev/null", "w");
+    static char iobuf[1 << 16];
+    if (null) setvbuf(null, iobuf, _IOFBF, sizeof(iobuf));
+
+    double t0 = now_s();
+    for (unsigned long i = 0; null && i < n; i++) {
+        const SensorData *d = &rows[i & 4095];
+        fprintf(null, "%.2f,%.2f,%.2f,%" PRIu64 "\n", d->temperature, d->pressure, d->flow, d->timestamp);
+    }
+    double fprintf_rate = n / (now_s() - t0);
+
+    size_t bytes = 0;
+    t0 = now_s();
+    for (unsigned long i = 0; i < n; i++) {
+        const SensorData *d = &rows[i & 4095];
+        bytes += (size_t)snprintf(out + (i & 4095) * SENSOR_CSV_MAX_ROW, SENSOR_CSV_MAX_ROW,
+                                  "%.2f,%.2f,%.2f,%" PRIu64 "\n",
+                                  d->temperature, d->pressure, d->flow, d->timestamp);
+    }
+    double snprintf_rate = n / (now_s() - t0);
+
+    t0 = now_s();
+    size_t enc_bytes = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        enc_bytes += sensor_csv_row(out + (i & 4095) * SENSOR_CSV_MAX_ROW, &rows[i & 4095]);
+    }
+    double enc_rate = n / (now_s() - t0);
+
+    if (null) {
+        t0 = now_s();
+        for (unsigned long i = 0; i < n; i++) {
+            char row[SENSOR_CSV_MAX_ROW];
+            size_t len = sensor_csv_row(row, &rows[i & 4095]);
+            fwrite(row, 1, len, null);
+        }
+        double enc_fwrite_rate = n / (now_s() - t0);
+        fclose(null);
+        printf("%-26s %12.0f rows/s\n", "fprintf to /dev/null", fprintf_rate);
+        printf("%-26s %12.0f rows/s\n", "sensor_csv_row + fwrite", enc_fwrite_rate);
+    }
+    printf("%-26s %12.0f rows/s\n", "snprintf", snprintf_rate);
+    printf("%-26s %12.0f rows/s  (%.1fx snprintf, %s bytes)\n", "sensor_csv_row", enc_rate,
+           snprintf_rate > 0 ? enc_rate / snprintf_rate : 0.0, bytes == enc_bytes ? "same" : "DIFFERENT");
+
+    free(rows);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * bench_history: one-channel scans over the structure-of-arrays history
+ * (examples/memory/embedded_style/sensor_history.h) against the same
+ * window held as an array of SensorData structs.
+ *
+ * The scan averages the temperature channel of the whole window, the
+ * typical window-analytics access pattern. AoS drags pressure, flow and
+ * timestamp (24 bytes per reading) through the cache. SoA reads 4 bytes.
+ *
+ * Usage: bench_history [-w window] [-r rounds]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_history.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static volatile float sink;
+
+// Four independent partial sums so the scan is bound by memory, not by
+// the latency of one dependent add chain
+#define SUM4(get, n, acc) do {                                    \
+        size_t i_ = 0;                                            \
+        for (; i_ + 4 <= (n); i_ += 4) {                          \
+            acc[0] += get(i_); acc[1] += get(i_ + 1);             \
+            acc[2] += get(i_ + 2); acc[3] += get(i_ + 3);         \
+        }                                                         \
+        for (; i_ < (n); i_++) acc[0] += get(i_);                 \
+    } while (0)
+
+static float mean_aos(const SensorData *ring, size_t cap, size_t tail, size_t n) {
+    // same two-run walk as the SoA spans, so only the layout differs
+    size_t n0 = n < cap - tail ? n : cap - tail;
+    float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+#define AOS_RUN0(i) ring[tail + (i)].temperature
+#define AOS_RUN1(i) ring[(i)].temperature
+    SUM4(AOS_RUN0, n0, acc);
+    SUM4(AOS_RUN1, n - n0, acc);
+    return n ? (acc[0] + acc[1] + acc[2] + acc[3]) / (float)n : 0.0f;
+}
+
+static float mean_soa(const SensorHistory *h) {
+    ChannelSpan spans[2];
+    size_t n = history_channel_spans(h, SENSOR_CH_TEMPERATURE, spans);
+    float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+#define SOA_RUN0(i) spans[0].data[(i)]
+#define SOA_RUN1(i) spans[1].data[(i)]
+    SUM4(SOA_RUN0, spans[0].count, acc);
+    SUM4(SOA_RUN1, spans[1].count, acc);
+    return n ? (acc[0] + acc[1] + acc[2] + acc[3]) / (float)n : 0.0f;
+}
+
+int main(int argc, char *argv[]) {
+    size_t window = 1u << 20;
+    unsigned long rounds = 50;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) window = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) rounds = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-w window] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (window == 0) window = 1;
+
+    // the AoS ring gets the same power-of-two slots as the SoA history, so
+    // both split the window at the same slot and sum in the same order
+    SensorHistory h;
+    if (!history_init(&h, window, 1.0)) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+    size_t cap = h.capacity;
+    SensorData *aos = malloc(cap * sizeof(SensorData));
+    if (!aos) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        history_free(&h);
+        return 1;
+    }
+
+    // fill 1.5 windows so both containers have wrapped
+    size_t total = window + window / 2, tail = 0, count = 0;
+    double t0 = now_s();
+    for (size_t i = 0; i < total; i++) {
+        SensorData d = { 20.0f + (float)(i % 800) / 10.0f, 1.0f + (float)(i % 90) / 10.0f,
+                         (float)(i % 1000) / 10.0f, 1700000000ul + i };
+        history_push(&h, &d);
+    }
+    double push_rate = total / (now_s() - t0);
+    for (size_t i = 0; i < total; i++) {
+        SensorData d = { 20.0f + (float)(i % 800) / 10.0f, 1.0f + (float)(i % 90) / 10.0f,
+                         (float)(i % 1000) / 10.0f, 1700000000ul + i };
+        if (count == window) {
+            tail = (tail + 1) & (cap - 1);
+            count--;
+        }
+        aos[(tail + count) & (cap - 1)] = d;
+        count++;
+    }
+
+    float a = mean_aos(aos, cap, tail, count), s = mean_soa(&h);
+    printf("window %zu readings, %lu scans | push %.1f M/s | mean AoS %.4f SoA %.4f %s\n",
+           window, rounds, push_rate / 1e6, a, s, a == s ? "" : "(MISMATCH)");
+
+    t0 = now_s();
+    for (unsigned long r = 0; r < rounds; r++) sink = mean_aos(aos, cap, tail, count);
+    double aos_s = (now_s() - t0) / rounds;
+    t0 = now_s();
+    for (unsigned long r = 0; r < rounds; r++) sink = mean_soa(&h);
+    double soa_s = (now_s() - t0) / rounds;
+
+    printf("%-22s %8.1f M readings/s  %6.2f GB/s touched\n", "AoS temperature scan",
+           count / aos_s / 1e6, count * sizeof(SensorData) / aos_s / 1e9);
+    printf("%-22s %8.1f M readings/s  %6.2f GB/s touched  (%.1fx)\n", "SoA temperature span",
+           count / soa_s / 1e6, count * sizeof(float) / soa_s / 1e9, aos_s / soa_s);
+
+    history_free(&h);
+    free(aos);
+    return 0;
+}
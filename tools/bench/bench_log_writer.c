@@ -0,0 +1,127 @@
+/*
+ * bench_log_writer: CSV records/s of the sensor loggers' original
+ * per-sample fopen/fprintf/fclose versus the buffered async LogWriter
+ * (examples/memory/embedded_style/log_writer.h) and the mmap'd segment
+ * log (seg_log.h).
+ *
+ * Usage: bench_log_writer [-n records] [-d dir]
+ *   The legacy path runs n/100 records (it is ~100x slower).
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_writer.h"
+#include "seg_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static float value(unsigned long i, float base, float span) {
+    return base + (float)(i * 7919u % 1000u) * span / 1000.0f;
+}
+
+// The original logToFile(): one open/close round-trip per record
+static double bench_legacy(const char *path, unsigned long n) {
+    FILE *f = fopen(path, "w");
+    if (f) fclose(f);
+    double t0 = now_s();
+    for (unsigned long i = 0; i < n; i++) {
+        FILE *file = fopen(path, "a");
+        if (!file) return 0.0;
+        fprintf(file, "%.2f,%.2f,%.2f,%lu\n",
+                value(i, 20.0f, 80.0f), value(i, 1.0f, 9.0f), value(i, 0.0f, 100.0f), 1700000000UL + i);
+        fclose(file);
+    }
+    return n / (now_s() - t0);
+}
+
+static double bench_writer(const char *path, unsigned long n, const char *sync, LogWriter *out_stats) {
+    LogWriterConfig cfg;
+    log_writer_default_config(&cfg);
+    log_writer_parse_sync(&cfg, sync);
+
+    LogWriter w;
+    memset(out_stats, 0, sizeof(*out_stats));
+    if (log_writer_open(&w, path, 1, &cfg) != 0) return 0.0;
+    double t0 = now_s();
+    for (unsigned long i = 0; i < n; i++) {
+        log_writer_printf(&w, "%.2f,%.2f,%.2f,%lu\n",
+                          value(i, 20.0f, 80.0f), value(i, 1.0f, 9.0f), value(i, 0.0f, 100.0f),
+                          1700000000UL + i);
+    }
+    log_writer_close(&w);
+    double rate = n / (now_s() - t0);
+    *out_stats = w;
+    return rate;
+}
+
+static double bench_segments(const char *base, unsigned long n, SegLog *out_stats) {
+    SegLogConfig cfg;
+    seg_log_default_config(&cfg);
+    cfg.segment_bytes = 64u << 20;
+    cfg.max_segments = 2;
+
+    SegLog w;
+    memset(out_stats, 0, sizeof(*out_stats));
+    if (seg_log_open(&w, base, "csv", &cfg) != 0) return 0.0;
+    double t0 = now_s();
+    for (unsigned long i = 0; i < n; i++) {
+        seg_log_printf(&w, "%.2f,%.2f,%.2f,%lu\n",
+                       value(i, 20.0f, 80.0f), value(i, 1.0f, 9.0f), value(i, 0.0f, 100.0f),
+                       1700000000UL + i);
+    }
+    seg_log_close(&w);
+    double rate = n / (now_s() - t0);
+    *out_stats = w;
+    return rate;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 2000000;
+    const char *dir = "/tmp";
+    char path[512];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) dir = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-n records] [-d dir]\n", argv[0]);
+            return 1;
+        }
+    }
+    snprintf(path, sizeof(path), "%s/bench_log_writer.csv", dir);
+
+    unsigned long legacy_n = n / 100 ? n / 100 : 1;
+    double legacy = bench_legacy(path, legacy_n);
+    printf("%-30s %10lu records %12.0f records/s\n", "fopen/fprintf/fclose", legacy_n, legacy);
+
+    const char *modes[] = { "none", "every:10000", "interval:100" };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        LogWriter st;
+        double rate = bench_writer(path, n, modes[m], &st);
+        char label[48];
+        snprintf(label, sizeof(label), "log_writer sync=%s", modes[m]);
+        printf("%-30s %10lu records %12.0f records/s  (%.0fx, %lu writes, %lu syncs, %lu stalls)\n",
+               label, n, rate, legacy > 0 ? rate / legacy : 0.0, st.flushes, st.syncs, st.stalls);
+    }
+
+    char base[512], seg_path[600];
+    snprintf(base, sizeof(base), "%s/bench_seg_log", dir);
+    SegLog st;
+    double rate = bench_segments(base, n, &st);
+    printf("%-30s %10lu records %12.0f records/s  (%.0fx, %lu segments of 64 MiB, %lu msyncs)\n",
+           "seg_log mmap", n, rate, legacy > 0 ? rate / legacy : 0.0, st.segments, st.msyncs);
+    for (unsigned long s = 0; s < st.segments; s++) {
+        snprintf(seg_path, sizeof(seg_path), "%s.%06lu.csv", base, s);
+        remove(seg_path);
+    }
+
+    remove(path);
+    return 0;
+}
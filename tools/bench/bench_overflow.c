@@ -0,0 +1,159 @@
+/*
+ * bench_overflow: the overflow policies of policy_ring.h against a consumer
+ * that cannot keep up.
+ *
+ *  - paced: the producer offers -n items at -r items/s to a consumer that
+ *    takes a batch of up to 64 and then sleeps 1 ms (roughly 60k items/s);
+ *    per policy: items delivered, lost per cause, the longest run of
+ *    consecutive items lost, the longest push (how long the producer was
+ *    held up) and the watermark callbacks seen
+ *  - check: every delivered item is intact and items arrive in order with
+ *    no duplicates; offered == delivered + lost. The same check runs with
+ *    an unpaced producer and a consumer that never sleeps, which is what
+ *    races evictions against CAS pops hardest for the drop-oldest policy
+ *
+ * Usage: bench_overflow [-n items] [-r rate_hz] [-c capacity]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "policy_ring.h"
+#include "timebase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+typedef struct {
+    uint64_t seq;
+    uint64_t check;               /* seq * constant: a torn copy fails it */
+} Item;
+
+#define CHECK_MUL 0x9e3779b97f4a7c15ULL
+
+typedef struct {
+    PolicyRing ring;
+    uint64_t n;
+    double rate_hz;               /* 0 = unpaced */
+    int consumer_sleeps;
+    int done;                     /* producer finished, atomic */
+
+    /* producer */
+    uint64_t max_push_ns;
+    unsigned long callbacks_high, callbacks_low;
+    /* consumer */
+    uint64_t delivered, bad, max_gap;
+} Run;
+
+static void on_watermark(void *ctx, int high, size_t fill) {
+    Run *run = (Run *)ctx;
+    (void)fill;
+    if (high) run->callbacks_high++;
+    else run->callbacks_low++;
+}
+
+static void *consumer(void *arg) {
+    Run *run = (Run *)arg;
+    Item batch[64];
+    uint64_t next = 0;
+    struct timespec nap = { 0, 1000000 };
+    for (;;) {
+        size_t k = policy_ring_pop_batch(&run->ring, batch, 64);
+        for (size_t i = 0; i < k; i++) {
+            if (batch[i].check != batch[i].seq * CHECK_MUL || batch[i].seq < next) run->bad++;
+            else if (batch[i].seq - next > run->max_gap) run->max_gap = batch[i].seq - next;
+            next = batch[i].seq + 1;
+        }
+        run->delivered += k;
+        if (k == 0 && __atomic_load_n(&run->done, __ATOMIC_ACQUIRE) &&
+            policy_ring_count(&run->ring) == 0)
+            break;
+        if (run->consumer_sleeps || k == 0) nanosleep(&nap, NULL);
+    }
+    return NULL;
+}
+
+static void producer(Run *run) {
+    uint64_t period = run->rate_hz > 0 ? (uint64_t)(1e9 / run->rate_hz) : 0;
+    uint64_t deadline = timebase_now_ns();
+    for (uint64_t i = 0; i < run->n; i++) {
+        if (period) {
+            deadline += period;
+            while (timebase_now_ns() < deadline) {}
+        }
+        Item it = { i, i * CHECK_MUL };
+        uint64_t t0 = timebase_now_ns();
+        policy_ring_push(&run->ring, &it);
+        uint64_t dt = timebase_now_ns() - t0;
+        if (dt > run->max_push_ns) run->max_push_ns = dt;
+    }
+    __atomic_store_n(&run->done, 1, __ATOMIC_RELEASE);
+}
+
+static int run_policy(const char *spec, size_t cap, uint64_t n, double rate_hz, int sleeps) {
+    static Item storage[1 << 20];
+    Run *run = calloc(1, sizeof(*run));
+    PolicyRingConfig cfg;
+    pthread_t thread;
+    policy_ring_default_config(&cfg);
+    policy_ring_parse(&cfg, spec);
+    cfg.on_watermark = on_watermark;
+    cfg.ctx = run;
+    run->n = n;
+    run->rate_hz = rate_hz;
+    run->consumer_sleeps = sleeps;
+    policy_ring_init(&run->ring, storage, cap, sizeof(Item), &cfg);
+
+    pthread_create(&thread, NULL, consumer, run);
+    producer(run);
+    pthread_join(thread, NULL);
+
+    const PolicyRingStats *s = &run->ring.stats;
+    int ok = run->bad == 0 && s->offered == n && run->delivered + policy_ring_lost(&run->ring) == n;
+    printf("%-12s %9llu %8llu %8llu %9llu %8llu %8llu %8llu %10.1f %5lu/%-5lu %s\n", spec,
+           (unsigned long long)run->delivered, s->dropped_newest, s->dropped_oldest, s->decimated,
+           s->timeouts, s->blocked, (unsigned long long)run->max_gap, (double)run->max_push_ns / 1e3,
+           run->callbacks_high, run->callbacks_low, ok ? "ok" : "ERROR");
+    free(run);
+    return ok;
+}
+
+static const char *const specs[] = { "newest", "oldest", "block:2", "block:100", "decimate:8" };
+#define NSPECS (sizeof(specs) / sizeof(specs[0]))
+
+static void header(void) {
+    printf("%-12s %9s %8s %8s %9s %8s %8s %8s %10s %11s %s\n", "policy", "delivered", "newest",
+           "oldest", "decimated", "timeouts", "blocked", "max gap", "max push us", "high/low", "check");
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t n = 100000;
+    double rate = 100000.0;
+    size_t cap = 1024;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) cap = spsc_round_capacity((size_t)atol(argv[++i]));
+        else {
+            fprintf(stderr, "Usage: %s [-n items] [-r rate_hz] [-c capacity]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1) n = 1;
+    if (cap < 4) cap = 4;
+    if (cap > (1 << 20)) cap = 1 << 20;
+    timebase_init(TIMEBASE_AUTO);
+    int ok = 1;
+
+    printf("bench_overflow: %llu items at %.0f/s, capacity %zu, consumer 64 items per 1 ms\n\n",
+           (unsigned long long)n, rate, cap);
+    header();
+    for (size_t i = 0; i < NSPECS; i++) ok &= run_policy(specs[i], cap, n, rate, 1);
+
+    printf("\nunpaced producer, consumer never sleeps (%llu items)\n", (unsigned long long)n * 10);
+    header();
+    for (size_t i = 0; i < NSPECS; i++) ok &= run_policy(specs[i], cap, n * 10, 0.0, 0);
+
+    printf("\nresult: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*
+ * bench_packed_history: readings retained per byte of RAM by the
+ * block-compressed history (packed_history.h) against a plain SensorData
+ * ring of the same size, and the cost of pushing and decoding.
+ *
+ * Signal shapes:
+ *  - slow:   plant-like random walk quantised to 0.01, steady 1 s rate
+ *  - random: the uniform 0.1-step noise of generateSensorData()
+ *  - jitter: slow signal with microsecond timestamps +-50 us around 1 ms
+ *  - float:  full precision floats (forces the Gorilla XOR fallback)
+ * The decoded history is checked bit for bit against the newest inputs.
+ *
+ * Usage: bench_packed_history [-n samples] [-k arena_kb]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "packed_history.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t rng_state = 12345u;
+static uint32_t rng(void) {   // xorshift32, reproducible across runs
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static float quantise(float v) {
+    return roundf(v * 100.0f) / 100.0f;
+}
+
+enum { SIG_SLOW, SIG_RANDOM, SIG_JITTER, SIG_FLOAT, SIGNALS };
+static const char *signal_names[SIGNALS] = { "slow", "random", "jitter", "float" };
+
+static void generate(SensorData *d, unsigned long n, int sig) {
+    float t = 55.0f, p = 5.0f, f = 50.0f;
+    unsigned long ts = 1700000000ul;
+    for (unsigned long i = 0; i < n; i++) {
+        if (sig == SIG_RANDOM) {
+            d[i].temperature = 20.0f + (rng() % 800) / 10.0f;
+            d[i].pressure = 1.0f + (rng() % 90) / 10.0f;
+            d[i].flow = (rng() % 1000) / 10.0f;
+        } else {
+            if (rng() % 4 == 0) t += (float)((int)(rng() % 5) - 2) * 0.01f;
+            if (rng() % 8 == 0) p += (float)((int)(rng() % 3) - 1) * 0.01f;
+            if (rng() % 4 == 0) f += (float)((int)(rng() % 5) - 2) * 0.01f;
+            int exact = sig != SIG_FLOAT;
+            d[i].temperature = exact ? quantise(t) : t + (float)(rng() % 1000) * 1e-6f;
+            d[i].pressure = exact ? quantise(p) : p + (float)(rng() % 1000) * 1e-6f;
+            d[i].flow = exact ? quantise(f) : f + (float)(rng() % 1000) * 1e-6f;
+        }
+        if (sig == SIG_JITTER) ts = 1700000000000000ul + i * 1000ul + rng() % 101 - 50;
+        else ts = 1700000000ul + i;
+        d[i].timestamp = ts;
+    }
+}
+
+static int same(const SensorData *a, const SensorData *b) {
+    return a->timestamp == b->timestamp && memcmp(&a->temperature, &b->temperature, sizeof(float)) == 0 &&
+           memcmp(&a->pressure, &b->pressure, sizeof(float)) == 0 &&
+           memcmp(&a->flow, &b->flow, sizeof(float)) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 2000000;
+    size_t arena_kb = 64;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) arena_kb = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-n samples] [-k arena_kb]\n", argv[0]);
+            return 1;
+        }
+    }
+    size_t arena_bytes = arena_kb * 1024;
+    SensorData *d = malloc(n * sizeof(*d));
+    uint8_t *arena = malloc(arena_bytes);
+    static PackedHistory h;
+    if (!d || !arena || n == 0) return 1;
+
+    size_t plain = arena_bytes / sizeof(SensorData);
+    printf("%zu KiB arena, %lu samples pushed; a SensorData ring of the same size holds %zu (%zu B each)\n\n",
+           arena_kb, n, plain, sizeof(SensorData));
+    printf("%-7s %9s %8s %7s %9s %10s %11s %5s  %s\n", "Signal", "Retained", "B/sample", "Gain",
+           "push ns", "decode ns", "ns/block", "XOR", "check");
+
+    for (int sig = 0; sig < SIGNALS; sig++) {
+        generate(d, n, sig);
+        if (packed_history_init(&h, arena, arena_bytes) != 0) {
+            fprintf(stderr, "Arena too small: need at least %zu bytes\n", packed_history_min_arena());
+            return 1;
+        }
+        double t0 = now_s();
+        for (unsigned long i = 0; i < n; i++) packed_history_push(&h, &d[i]);
+        double push_s = now_s() - t0;
+
+        // decode everything retained; it must be the newest inputs, in order
+        size_t kept = packed_history_count(&h), got = 0, bad = 0;
+        int reps = 0;
+        t0 = now_s();
+        do {
+            PackedHistoryIter it;
+            SensorData s;
+            const SensorData *want = d + (n - kept);
+            got = 0;
+            bad = 0;
+            packed_history_iter_begin(&h, &it);
+            while (packed_history_next(&it, &s)) {
+                if (got >= kept || !same(&s, &want[got])) bad++;
+                got++;
+            }
+            reps++;
+        } while (now_s() - t0 < 0.2);
+        double dec_ns = (now_s() - t0) / reps / (double)(got ? got : 1) * 1e9;
+
+        double bps = h.held ? (double)packed_history_bytes(&h) / (double)h.held : 0.0;
+        printf("%-7s %9zu %8.2f %6.1fx %9.1f %10.1f %11.0f %5lu  %s\n", signal_names[sig], kept, bps,
+               (double)kept / (double)plain, push_s / n * 1e9, dec_ns, dec_ns * PACKED_HISTORY_BLOCK,
+               h.xor_columns, got == kept && bad == 0 ? "ok" : "MISMATCH");
+    }
+
+    free(arena);
+    free(d);
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * bench_rolling: cost of rolling window statistics (sensor_history.h)
+ * per pushed sample, for growing window sizes, against rescanning the
+ * window for every query as printBuffer-style code does.
+ *
+ * history_stats() results are checked against an exact rescan first.
+ *
+ * Usage: bench_rolling [-n pushes]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_history.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static volatile float sink;
+static unsigned int seed = 1;
+
+static SensorData next_sample(unsigned long i) {
+    static float walk = 50.0f;
+    walk += (float)((int)(rand_r(&seed) % 201) - 100) / 100.0f;
+    SensorData d = { walk, 1.0f + (rand_r(&seed) % 90) / 10.0f,
+                     (rand_r(&seed) % 1000) / 10.0f, 1700000000ul + i };
+    return d;
+}
+
+// Two-pass rescan of the window: what every query costs without rolling state
+static void rescan(const SensorHistory *h, SensorChannel ch, ChannelStats *out) {
+    ChannelSpan spans[2];
+    size_t n = history_channel_spans(h, ch, spans);
+    double sum = 0.0, m2 = 0.0;
+    float mn = spans[0].data[0], mx = mn;
+    for (int s = 0; s < 2; s++)
+        for (size_t i = 0; i < spans[s].count; i++) {
+            float v = spans[s].data[i];
+            sum += v;
+            if (v < mn) mn = v;
+            if (v > mx) mx = v;
+        }
+    double mean = sum / (double)n;
+    for (int s = 0; s < 2; s++)
+        for (size_t i = 0; i < spans[s].count; i++) {
+            double d = spans[s].data[i] - mean;
+            m2 += d * d;
+        }
+    out->count = n;
+    out->mean = (float)mean;
+    out->variance = n > 1 ? (float)(m2 / (double)(n - 1)) : 0.0f;
+    out->min = mn;
+    out->max = mx;
+}
+
+static int close_enough(float a, float b) {
+    return fabsf(a - b) <= 1e-3f * (1.0f + fabsf(b));
+}
+
+static unsigned long verify(void) {
+    SensorHistory h;
+    unsigned long failures = 0;
+    if (!history_init(&h, 1000, 1.0)) return 1;
+    for (unsigned long i = 0; i < 300000; i++) {
+        SensorData d = next_sample(i);
+        history_push(&h, &d);
+        if (i % 997 != 0) continue;
+        for (int c = 0; c < SENSOR_CHANNELS; c++) {
+            ChannelStats got, want;
+            history_stats(&h, (SensorChannel)c, &got);
+            rescan(&h, (SensorChannel)c, &want);
+            if (got.count != want.count || got.min != want.min || got.max != want.max ||
+                !close_enough(got.mean, want.mean) || !close_enough(got.variance, want.variance)) {
+                if (failures++ < 5)
+                    fprintf(stderr, "push %lu ch %d: mean %f/%f var %f/%f min %f/%f max %f/%f\n",
+                            i, c, got.mean, want.mean, got.variance, want.variance,
+                            got.min, want.min, got.max, want.max);
+            }
+        }
+    }
+    history_free(&h);
+    return failures;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 2000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-n pushes]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    unsigned long failures = verify();
+    printf("verify: %s against rescans\n", failures ? "FAILED" : "matches");
+    if (failures) return 1;
+
+    printf("%-10s | %-28s | %-22s\n", "window", "push + 3x history_stats", "rescan query (1 ch)");
+    static const size_t windows[] = { 16, 256, 4096, 65536, 1048576 };
+    for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        SensorHistory h;
+        if (!history_init(&h, windows[w], 1.0)) {
+            fprintf(stderr, "Error: Memory allocation failed.\n");
+            return 1;
+        }
+        for (unsigned long i = 0; i < windows[w]; i++) {
+            SensorData d = next_sample(i);
+            history_push(&h, &d);
+        }
+
+        ChannelStats st;
+        double t0 = now_s();
+        for (unsigned long i = 0; i < n; i++) {
+            SensorData d = next_sample(i);
+            history_push(&h, &d);
+            for (int c = 0; c < SENSOR_CHANNELS; c++) {
+                history_stats(&h, (SensorChannel)c, &st);
+                sink = st.variance;
+            }
+        }
+        double rolling_ns = (now_s() - t0) / n * 1e9;
+
+        unsigned long queries = 2000000ul / windows[w] + 1;
+        t0 = now_s();
+        for (unsigned long q = 0; q < queries; q++) {
+            rescan(&h, SENSOR_CH_TEMPERATURE, &st);
+            sink = st.variance;
+        }
+        double rescan_ns = (now_s() - t0) / queries * 1e9;
+
+        printf("%10zu | %20.1f ns/sample | %14.0f ns/query\n", windows[w], rolling_ns, rescan_ns);
+        history_free(&h);
+    }
+    return 0;
+}
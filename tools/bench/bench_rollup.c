@@ -0,0 +1,133 @@
+/*
+ * bench_rollup: cost of feeding the 1 s / 1 min / 1 h rollup tiers
+ * (rollup.h) per sample, and of a long-range min/max/mean query answered
+ * from rollup rows against scanning the raw samples.
+ *
+ * Simulates `days` of 1 Hz samples, then asks for the last week, the last
+ * day and the last hour. Rollup aggregates are checked against the scan.
+ *
+ * Usage: bench_rollup [-d days]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "rollup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define MAX_ROWS 1000   // row budget per query for rollup_pick_tier()
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static volatile float sink;
+
+// min/max/mean of temperature over [from, to] straight from the samples
+// (binary search for the start, then every sample of the range)
+static void scan_raw(const SensorData *d, size_t n, unsigned long from, unsigned long to,
+                     RollupRow *out) {
+    double sum = 0.0;
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (d[mid].timestamp < from) lo = mid + 1;
+        else hi = mid;
+    }
+    memset(out, 0, sizeof(*out));
+    for (size_t i = lo; i < n && d[i].timestamp <= to; i++) {
+        float v = d[i].temperature;
+        if (out->count == 0 || v < out->min[0]) out->min[0] = v;
+        if (out->count == 0 || v > out->max[0]) out->max[0] = v;
+        sum += v;
+        out->count++;
+    }
+    out->mean[0] = out->count ? (float)(sum / out->count) : 0.0f;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long days = 30;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) days = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-d days]\n", argv[0]);
+            return 1;
+        }
+    }
+    const size_t n = days * 86400ul;
+    const unsigned long t0 = 1700000000ul - 1700000000ul % 3600;
+    SensorData *raw = malloc(n * sizeof(*raw));
+    if (!raw || n == 0) return 1;
+
+    unsigned int seed = 1;
+    float walk = 50.0f;
+    for (size_t i = 0; i < n; i++) {
+        walk += (float)((int)(rand_r(&seed) % 201) - 100) / 100.0f;
+        raw[i].temperature = walk;
+        raw[i].pressure = 1.0f + (rand_r(&seed) % 90) / 10.0f;
+        raw[i].flow = (rand_r(&seed) % 1000) / 10.0f;
+        raw[i].timestamp = t0 + i;
+    }
+
+    Rollup r;
+    RollupConfig cfg;
+    rollup_default_config(&cfg);
+    if (rollup_init(&r, 1.0, &cfg) != 0) return 1;
+
+    double t = now_s();
+    for (size_t i = 0; i < n; i++) rollup_add(&r, &raw[i]);
+    double ingest = now_s() - t;
+    rollup_flush(&r);
+
+    printf("%lu days of 1 Hz samples (%zu): rollup ingest %.1f ns/sample\n", days, n, ingest / n * 1e9);
+    printf("Rows kept: 1s %zu, 1m %zu, 1h %zu\n\n", rollup_count(&r, ROLLUP_1S),
+           rollup_count(&r, ROLLUP_1M), rollup_count(&r, ROLLUP_1H));
+
+    printf("%-10s %10s %12s %5s %8s %12s %9s  %s\n", "Range", "Samples", "scan us", "Tier", "Rows",
+           "rollup us", "Speedup", "check");
+    const struct { const char *name; unsigned long seconds; } ranges[] = {
+        { "last week", 7 * 86400ul }, { "last day", 86400ul }, { "last hour", 3600ul },
+    };
+    for (size_t q = 0; q < sizeof(ranges) / sizeof(ranges[0]); q++) {
+        unsigned long to = t0 + n - 1;
+        unsigned long from = ranges[q].seconds <= n ? to + 1 - ranges[q].seconds : t0;
+        RollupRow ref, agg;
+        static RollupRow rows[MAX_ROWS];
+
+        int reps = 0;
+        t = now_s();
+        do {
+            scan_raw(raw, n, from, to, &ref);
+            sink = ref.mean[0];
+            reps++;
+        } while (now_s() - t < 0.2);
+        double scan_us = (now_s() - t) / reps * 1e6;
+
+        int tier = 0;
+        size_t nrows = 0;
+        reps = 0;
+        t = now_s();
+        do {
+            tier = rollup_pick_tier(&r, from, to, MAX_ROWS);
+            nrows = rollup_query(&r, tier, from, to, rows, MAX_ROWS);
+            memset(&agg, 0, sizeof(agg));
+            for (size_t i = 0; i < nrows; i++) rollup_merge(&agg, &rows[i]);
+            sink = agg.mean[0];
+            reps++;
+        } while (now_s() - t < 0.2);
+        double roll_us = (now_s() - t) / reps * 1e6;
+
+        int ok = agg.count == ref.count && agg.min[0] == ref.min[0] && agg.max[0] == ref.max[0] &&
+                 fabsf(agg.mean[0] - ref.mean[0]) < 1e-3f * (1.0f + fabsf(ref.mean[0]));
+        printf("%-10s %10u %12.1f %5s %8zu %12.2f %8.0fx  %s\n", ranges[q].name, ref.count, scan_us,
+               rollup_tier_name(tier), nrows, roll_us, scan_us / roll_us, ok ? "ok" : "MISMATCH");
+    }
+
+    rollup_free(&r);
+    free(raw);
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * bench_rules: rule evaluations/s of the alarm rule engine
+ * (examples/memory/embedded_style/alarm_rules.h), and how many events a
+ * signal hovering at the limit produces with and without hysteresis.
+ *
+ * Usage: bench_rules [-n samples]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "alarm_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+#define BLOCK 4096
+
+// Temperature hovers at 80 ± 1 °C, pressure and flow stay nominal; 100 Hz
+static void generate(SensorData *d, size_t n, unsigned int *seed) {
+    for (size_t i = 0; i < n; i++) {
+        d[i].temperature = 80.0f + (float)((int)(rand_r(seed) % 201) - 100) / 100.0f;
+        d[i].pressure = 5.0f + (float)(rand_r(seed) % 100) / 100.0f;
+        d[i].flow = 50.0f + (float)(rand_r(seed) % 100) / 10.0f;
+    }
+}
+
+static void run(const char *label, AlarmRules *rs, SensorData *blocks, size_t nblocks,
+                unsigned long rounds) {
+    static AlarmEvent events[BLOCK * ALARM_RULES_MAX];
+    unsigned long total_events = 0, tick = 0;
+    double dt = 0.0;
+    for (unsigned long r = 0; r < rounds; r++) {
+        SensorData *b = &blocks[(r % nblocks) * BLOCK];
+        // blocks are reused: keep time moving forward (not timed)
+        for (size_t i = 0; i < BLOCK; i++) b[i].timestamp = tick++;
+        double t0 = now_s();
+        total_events += alarm_rules_eval(rs, b, BLOCK, events, sizeof(events) / sizeof(events[0]));
+        dt += now_s() - t0;
+    }
+    double samples = (double)rounds * BLOCK;
+    printf("%-34s %3zu rules | %8.1f M samples/s | %8.1f M rule evals/s | %8lu events\n",
+           label, rs->count, samples / dt / 1e6, samples * rs->count / dt / 1e6, total_events);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long n = 20000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = strtoul(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-n samples]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // timestamps advance 1 tick per sample; 100 ticks = 1 s
+    const size_t nblocks = 64;
+    SensorData *blocks = malloc(nblocks * BLOCK * sizeof(SensorData));
+    if (!blocks) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+    unsigned int seed = 7;
+    generate(blocks, nblocks * BLOCK, &seed);
+    unsigned long rounds = n / BLOCK ? n / BLOCK : 1;
+
+    unsigned long raw = 0;
+    for (size_t i = 0; i < nblocks * BLOCK; i++) raw += blocks[i].temperature > 80.0f;
+    printf("%lu samples per run; raw exceedances of 80 °C in the data set: %lu of %zu samples\n",
+           rounds * BLOCK, raw, nblocks * BLOCK);
+
+    AlarmRules rs;
+    alarm_rules_init(&rs, 100.0);
+    alarm_rules_add(&rs, "high_temp", 0, RULE_GT, 80.0f, 0, 0, 0);
+    alarm_rules_add(&rs, "high_press", 1, RULE_GT, 9.0f, 0, 0, 0);
+    alarm_rules_add(&rs, "low_flow", 2, RULE_LT, 10.0f, 0, 0, 0);
+    run("limits only (transitions)", &rs, blocks, nblocks, rounds);
+
+    alarm_rules_init(&rs, 100.0);
+    alarm_rules_add(&rs, "high_temp", 0, RULE_GT, 80.0f, 1.5f, 0, 0);
+    alarm_rules_add(&rs, "high_press", 1, RULE_GT, 9.0f, 0.3f, 0, 0);
+    alarm_rules_add(&rs, "low_flow", 2, RULE_LT, 10.0f, 2.0f, 0, 0);
+    run("+ hysteresis", &rs, blocks, nblocks, rounds);
+
+    alarm_rules_init(&rs, 100.0);
+    alarm_rules_add(&rs, "high_temp", 0, RULE_GT, 80.0f, 0.5f, 0.05f, 10.0f);
+    alarm_rules_add(&rs, "high_press", 1, RULE_GT, 9.0f, 0.3f, 1.0f, 10.0f);
+    alarm_rules_add(&rs, "low_flow", 2, RULE_LT, 10.0f, 2.0f, 1.0f, 10.0f);
+    run("+ hysteresis, debounce, rate limit", &rs, blocks, nblocks, rounds);
+
+    // a larger table: 8 bands per channel
+    alarm_rules_init(&rs, 100.0);
+    for (int c = 0; c < 3; c++)
+        for (int k = 0; k < 8; k++) {
+            char name[32];
+            snprintf(name, sizeof(name), "band_%d_%d", c, k);
+            alarm_rules_add(&rs, name, c, k & 1 ? RULE_LT : RULE_GT,
+                            c == 0 ? 70.0f + k * 2.0f : c == 1 ? 4.0f + k * 0.2f : 45.0f + k,
+                            0.5f, 0.1f, 5.0f);
+        }
+    run("24 rules, mixed", &rs, blocks, nblocks, rounds);
+
+    free(blocks);
+    return 0;
+}
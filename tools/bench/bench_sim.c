@@ -0,0 +1,232 @@
+/*
+ * bench_sim: synthetic signal generation (sensor_sim.h) against the
+ * rand()-based generateSensorData() of the loggers.
+ *
+ *  - ns per SensorData: rand() vs the waveform simulator
+ *  - random words per ns for each xoshiro128++ kernel (scalar/SSE2/AVX2)
+ *  - aggregate samples/s with one SensorSim per thread
+ *  - checks: every kernel yields the same words, the output does not
+ *    depend on how requests are split, and the noise has the configured
+ *    mean and standard deviation
+ *
+ * Usage: bench_sim [-n samples] [-t max_threads] [-s seed]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// The loggers' generator, minus the time() call
+static SensorData rand_sample(void) {
+    SensorData d;
+    d.temperature = 20.0f + (rand() % 800) / 10.0f;
+    d.pressure    = 1.0f + (rand() % 90) / 10.0f;
+    d.flow        = (rand() % 1000) / 10.0f;
+    d.timestamp   = 0;
+    return d;
+}
+
+static float checksum(const SensorData *d, size_t n) {
+    float sum = 0;
+    for (size_t i = 0; i < n; i++) sum += d[i].temperature + d[i].pressure + d[i].flow;
+    return sum;
+}
+
+typedef void (*FillFn)(SimRng *, uint32_t *, size_t);
+
+static double bench_fill(FillFn fn, uint64_t seed, uint32_t *out, size_t steps, int reps) {
+    SimRng r;
+    sensor_sim_seed(&r, seed);
+    double t0 = now_s();
+    for (int k = 0; k < reps; k++) fn(&r, out, steps);
+    double dt = now_s() - t0;
+    return (double)steps * SENSOR_SIM_LANES * reps / (dt * 1e9);
+}
+
+typedef struct {
+    uint64_t seed;
+    size_t n;
+    float sum;
+} Worker;
+
+static void *worker(void *arg) {
+    Worker *w = arg;
+    SensorSim *sim = malloc(sizeof(*sim));
+    SensorData *chunk = malloc(1024 * sizeof(*chunk));
+    SimConfig cfg;
+    sensor_sim_default_config(&cfg);
+    sensor_sim_init(sim, &cfg, w->seed);
+    for (size_t done = 0; done < w->n; done += 1024) {
+        size_t k = w->n - done < 1024 ? w->n - done : 1024;
+        sensor_sim_generate(sim, chunk, k);
+        w->sum += checksum(chunk, k);
+    }
+    free(chunk);
+    free(sim);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = 4000000;
+    int max_threads = 4;
+    uint64_t seed = 42;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = (size_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) max_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [-n samples] [-t max_threads] [-s seed]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < SENSOR_SIM_BATCH) n = SENSOR_SIM_BATCH;
+    if (max_threads < 1) max_threads = 1;
+
+    SensorData *a = malloc(n * sizeof(*a)), *b = malloc(n * sizeof(*b));
+    if (!a || !b) return 1;
+    memset(a, 0, n * sizeof(*a));    // fault the pages in outside the timed loops
+    memset(b, 0, n * sizeof(*b));
+    int ok = 1;
+
+    printf("bench_sim: %zu samples, seed %llu, kernel %s, %ld CPUs online\n", n,
+           (unsigned long long)seed, sensor_sim_kernel_name(), sysconf(_SC_NPROCESSORS_ONLN));
+
+    // --- Per-sample generation ---
+    srand(1);
+    double t0 = now_s();
+    for (size_t i = 0; i < n; i++) a[i] = rand_sample();
+    double t_rand = now_s() - t0;
+    float sum_rand = checksum(a, n);
+
+    SimConfig cfg;
+    sensor_sim_default_config(&cfg);
+    SensorSim *sim = malloc(sizeof(*sim));
+    sensor_sim_init(sim, &cfg, seed);
+    t0 = now_s();
+    for (size_t i = 0; i < n; i++) a[i] = sensor_sim_next(sim);
+    double t_next = now_s() - t0;
+
+    sensor_sim_init(sim, &cfg, seed);
+    t0 = now_s();
+    sensor_sim_generate(sim, b, n);
+    double t_gen = now_s() - t0;
+
+    printf("\n%-28s %10s %14s\n", "generator", "ns/sample", "samples/s");
+    printf("%-28s %10.2f %14.0f   (checksum %.0f)\n", "rand() x3 per sample", t_rand * 1e9 / (double)n,
+           (double)n / t_rand, sum_rand);
+    printf("%-28s %10.2f %14.0f\n", "sensor_sim_next()", t_next * 1e9 / (double)n, (double)n / t_next);
+    printf("%-28s %10.2f %14.0f\n", "sensor_sim_generate(n)", t_gen * 1e9 / (double)n, (double)n / t_gen);
+
+    // Same stream however the requests are split
+    if (memcmp(a, b, n * sizeof(*a)) != 0) {
+        printf("ERROR: next() and generate(n) differ\n");
+        ok = 0;
+    }
+    sensor_sim_init(sim, &cfg, seed);
+    srand(7);
+    for (size_t done = 0; done < n;) {
+        size_t k = 1 + (size_t)rand() % 200;
+        if (k > n - done) k = n - done;
+        sensor_sim_generate(sim, a + done, k);
+        done += k;
+    }
+    if (memcmp(a, b, n * sizeof(*a)) != 0) {
+        printf("ERROR: random request sizes change the output\n");
+        ok = 0;
+    }
+
+    // --- Raw PRNG kernels ---
+    size_t steps = 4096;
+    int reps = (int)(n / 1024) + 1;
+    uint32_t *w0 = malloc(steps * SENSOR_SIM_LANES * sizeof(uint32_t));
+    uint32_t *w1 = malloc(steps * SENSOR_SIM_LANES * sizeof(uint32_t));
+    struct { const char *name; FillFn fn; } kernels[] = {
+        { "scalar", sensor_sim_fill_scalar },
+#ifdef SENSOR_SIM_X86
+        { "sse2", sensor_sim_fill_sse2 },
+        { "avx2", sensor_sim_fill_avx2 },
+#endif
+    };
+    printf("\n%-28s %10s\n", "xoshiro128++ kernel", "words/ns");
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+#ifdef SENSOR_SIM_X86
+        if (kernels[k].fn == sensor_sim_fill_avx2 && strcmp(sensor_sim_kernel_name(), "avx2") != 0) {
+            printf("%-28s %10s\n", kernels[k].name, "n/a");
+            continue;
+        }
+#endif
+        printf("%-28s %10.2f\n", kernels[k].name, bench_fill(kernels[k].fn, seed, w1, steps, reps));
+        SimRng r0, r1;
+        sensor_sim_seed(&r0, seed);
+        sensor_sim_seed(&r1, seed);
+        for (int rep = 0; rep < 3; rep++) {   // also checks the state carried between calls
+            sensor_sim_fill_scalar(&r0, w0, steps);
+            kernels[k].fn(&r1, w1, steps);
+            if (memcmp(w0, w1, steps * SENSOR_SIM_LANES * sizeof(uint32_t)) != 0) {
+                printf("ERROR: %s kernel differs from scalar\n", kernels[k].name);
+                ok = 0;
+                break;
+            }
+        }
+    }
+    free(w0);
+    free(w1);
+
+    // --- Noise statistics: N(0, 1) alone, no clamp or rounding ---
+    SimConfig noise;
+    memset(&noise, 0, sizeof(noise));
+    noise.rate_hz = 1.0;
+    noise.ticks_per_s = 1.0;
+    for (int c = 0; c < SENSOR_CHANNELS; c++) {
+        noise.ch[c].noise_sd = 1.0f;
+        noise.ch[c].min = -1e9f;
+        noise.ch[c].max = 1e9f;
+    }
+    sensor_sim_init(sim, &noise, seed);
+    sensor_sim_generate(sim, a, n);
+    double s1 = 0, s2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        s1 += a[i].temperature;
+        s2 += (double)a[i].temperature * a[i].temperature;
+    }
+    double mean = s1 / (double)n, sd = sqrt(s2 / (double)n - mean * mean);
+    printf("\nnoise_sd 1.0: mean %+.4f, sd %.4f\n", mean, sd);
+    if (fabs(mean) > 0.01 || fabs(sd - 1.0) > 0.01) {
+        printf("ERROR: noise statistics off\n");
+        ok = 0;
+    }
+
+    // --- One generator per thread ---
+    printf("\n%-28s %14s\n", "threads", "samples/s");
+    for (int t = 1; t <= max_threads; t *= 2) {
+        pthread_t th[64];
+        Worker w[64];
+        if (t > 64) break;
+        t0 = now_s();
+        for (int i = 0; i < t; i++) {
+            w[i] = (Worker){ seed + (uint64_t)i, n / (size_t)t, 0 };
+            pthread_create(&th[i], NULL, worker, &w[i]);
+        }
+        for (int i = 0; i < t; i++) pthread_join(th[i], NULL);
+        double dt = now_s() - t0;
+        printf("%-28d %14.0f\n", t, (double)(n / (size_t)t) * t / dt);
+    }
+
+    printf("\nresult: %s\n", ok ? "ok" : "FAILED");
+    free(sim);
+    free(a);
+    free(b);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/*
+ * bench_spsc: throughput of the SPSC ring (firmware/inc/spsc_ring.h)
+ * with one producer and one consumer thread.
+ *
+ * Usage: bench_spsc [-n records] [-b batch] [-c capacity] [--cpus P,C]
+ *   -b 1 measures single-element spsc_push/spsc_pop, larger values use
+ *   the batch API. --cpus pins producer and consumer to the given CPUs.
+ */
+#define _GNU_SOURCE
+
+#include "spsc_ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+/* 16-byte record, the size of a packed SensorData sample */
+typedef struct {
+    float    temperature;
+    float    pressure;
+    float    flow;
+    uint32_t seq;
+} Record;
+
+typedef struct {
+    SpscRing *ring;
+    uint64_t  records;
+    size_t    batch;
+    int       cpu;
+    uint64_t  errors;   /* consumer: out-of-order records */
+} Worker;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void pin(int cpu) {
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        fprintf(stderr, "warning: cannot pin to CPU %d\n", cpu);
+}
+
+/* spin briefly, then yield so the pair also progresses on one core */
+static void backoff(unsigned *spins) {
+    if (++*spins > 64) {
+        sched_yield();
+        *spins = 0;
+    }
+}
+
+static void *producer(void *arg) {
+    Worker *w = (Worker *)arg;
+    Record *chunk = malloc(w->batch * sizeof(Record));
+    unsigned spins = 0;
+    pin(w->cpu);
+
+    uint64_t seq = 0;
+    while (seq < w->records) {
+        size_t n = w->batch;
+        if (n > w->records - seq) n = (size_t)(w->records - seq);
+        for (size_t i = 0; i < n; ++i) {
+            chunk[i].temperature = 20.0f;
+            chunk[i].pressure = 1.0f;
+            chunk[i].flow = 50.0f;
+            chunk[i].seq = (uint32_t)(seq + i);
+        }
+        size_t done = 0;
+        while (done < n) {
+            size_t k = n == 1 ? (size_t)spsc_push(w->ring, chunk)
+                              : spsc_push_batch(w->ring, chunk + done, n - done);
+            if (k == 0) backoff(&spins);
+            done += k;
+        }
+        seq += n;
+    }
+    free(chunk);
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    Worker *w = (Worker *)arg;
+    Record *chunk = malloc(w->batch * sizeof(Record));
+    unsigned spins = 0;
+    uint32_t expect = 0;
+    pin(w->cpu);
+
+    uint64_t got = 0;
+    while (got < w->records) {
+        size_t k = w->batch == 1 ? (size_t)spsc_pop(w->ring, chunk)
+                                 : spsc_pop_batch(w->ring, chunk, w->batch);
+        if (k == 0) {
+            backoff(&spins);
+            continue;
+        }
+        for (size_t i = 0; i < k; ++i) {
+            if (chunk[i].seq != expect) w->errors++;
+            expect = chunk[i].seq + 1;
+        }
+        got += k;
+    }
+    free(chunk);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t records = 100000000ULL;
+    size_t batch = 256, capacity = 65536;
+    int cpu_p = -1, cpu_c = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) records = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) batch = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) capacity = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d,%d", &cpu_p, &cpu_c) != 2) cpu_p = cpu_c = -1;
+        } else {
+            fprintf(stderr, "Usage: %s [-n records] [-b batch] [-c capacity] [--cpus P,C]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (batch == 0) batch = 1;
+    capacity = spsc_round_capacity(capacity);
+
+    SpscRing ring;
+    Record *storage = malloc(capacity * sizeof(Record));
+    if (!storage || spsc_init(&ring, storage, capacity, sizeof(Record)) != 0) {
+        fprintf(stderr, "Error: ring setup failed.\n");
+        return 1;
+    }
+
+    Worker prod = { &ring, records, batch, cpu_p, 0 };
+    Worker cons = { &ring, records, batch, cpu_c, 0 };
+    pthread_t tp, tc;
+
+    uint64_t t0 = now_ns();
+    pthread_create(&tc, NULL, consumer, &cons);
+    pthread_create(&tp, NULL, producer, &prod);
+    pthread_join(tp, NULL);
+    pthread_join(tc, NULL);
+    uint64_t t1 = now_ns();
+
+    double secs = (double)(t1 - t0) / 1e9;
+    printf("spsc: %llu records x %zu B | batch %zu | capacity %zu\n",
+           (unsigned long long)records, sizeof(Record), batch, capacity);
+    printf("  %.3f s -> %.1f M records/s (%.2f GB/s), order errors: %llu\n",
+           secs, (double)records / secs / 1e6,
+           (double)records * sizeof(Record) / secs / 1e9,
+           (unsigned long long)cons.errors);
+
+    free(storage);
+    return cons.errors ? 1 : 0;
+}
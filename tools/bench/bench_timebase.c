@@ -0,0 +1,104 @@
+/*
+ * bench_timebase: cost per timestamp of the timebase (timebase.h) against
+ * time(NULL) and clock_gettime(), and how far it strays from the clocks.
+ *
+ *  - ns per call for every timestamp source
+ *  - drift of timebase_now_ns() from CLOCK_MONOTONIC and of
+ *    timebase_wall_ns() from CLOCK_REALTIME after sleeping -s seconds
+ *  - check: timebase_now_ns() never goes backwards
+ *
+ * Usage: bench_timebase [-n calls] [-s seconds] [--clock]
+ *   --clock  use CLOCK_MONOTONIC as the counter instead of the TSC
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "timebase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t clock_ns(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static volatile uint64_t sink;
+
+static uint64_t call_time(void)      { return (uint64_t)time(NULL); }
+static uint64_t call_monotonic(void) { return clock_ns(CLOCK_MONOTONIC); }
+static uint64_t call_realtime(void)  { return clock_ns(CLOCK_REALTIME); }
+static uint64_t call_now(void)       { return timebase_now_ns(); }
+static uint64_t call_wall(void)      { return timebase_wall_ns(); }
+static uint64_t call_ticks(void)     { return timebase_ticks(); }
+
+static double bench(uint64_t (*fn)(void), long n) {
+    uint64_t acc = 0, t0 = clock_ns(CLOCK_MONOTONIC);
+    for (long i = 0; i < n; i++) acc += fn();
+    uint64_t t1 = clock_ns(CLOCK_MONOTONIC);
+    sink = acc;
+    return (double)(t1 - t0) / (double)n;
+}
+
+int main(int argc, char *argv[]) {
+    long n = 10000000;
+    double seconds = 1.0;
+    TimebaseSource source = TIMEBASE_AUTO;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) n = atol(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--clock") == 0) source = TIMEBASE_MONOTONIC;
+        else {
+            fprintf(stderr, "Usage: %s [-n calls] [-s seconds] [--clock]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1) n = 1;
+
+    uint64_t c0 = clock_ns(CLOCK_MONOTONIC);
+    timebase_init(source);
+    uint64_t c1 = clock_ns(CLOCK_MONOTONIC);
+    printf("bench_timebase: source %s, %.3f MHz, mult %u >> %u, init %.1f ms\n\n",
+           timebase_source_name(), (double)timebase_state.hz / 1e6, timebase_state.mult,
+           timebase_state.shift, (double)(c1 - c0) / 1e6);
+
+    struct { const char *name; uint64_t (*fn)(void); } calls[] = {
+        { "time(NULL)", call_time },
+        { "clock_gettime(MONOTONIC)", call_monotonic },
+        { "clock_gettime(REALTIME)", call_realtime },
+        { "timebase_ticks()", call_ticks },
+        { "timebase_now_ns()", call_now },
+        { "timebase_wall_ns()", call_wall },
+    };
+    printf("%-28s %10s\n", "timestamp", "ns/call");
+    for (size_t i = 0; i < sizeof(calls) / sizeof(calls[0]); i++)
+        printf("%-28s %10.2f\n", calls[i].name, bench(calls[i].fn, n));
+
+    // Monotonic: consecutive reads never decrease
+    int ok = 1;
+    uint64_t prev = timebase_now_ns();
+    for (long i = 0; i < n; i++) {
+        uint64_t t = timebase_now_ns();
+        if (t < prev) {
+            printf("ERROR: timebase went back %llu ns\n", (unsigned long long)(prev - t));
+            ok = 0;
+            break;
+        }
+        prev = t;
+    }
+
+    // Drift against the reference clocks after a sleep
+    uint64_t m0 = clock_ns(CLOCK_MONOTONIC), n0 = timebase_now_ns();
+    struct timespec nap = { (time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9) };
+    nanosleep(&nap, NULL);
+    uint64_t n1 = timebase_now_ns(), m1 = clock_ns(CLOCK_MONOTONIC);
+    uint64_t w = timebase_wall_ns(), r = clock_ns(CLOCK_REALTIME);
+    double drift_ppm = ((double)(n1 - n0) - (double)(m1 - m0)) / (double)(m1 - m0) * 1e6;
+    printf("\nafter %.1f s: now_ns - CLOCK_MONOTONIC %+lld ns (rate error %+.2f ppm), "
+           "wall_ns - CLOCK_REALTIME %+lld ns\n", seconds,
+           (long long)(n1 - m1), drift_ppm, (long long)(w - r));
+
+    printf("\nresult: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
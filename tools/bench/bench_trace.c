@@ -0,0 +1,44 @@
+/*
+ * bench_trace: cost of recording one trace event (firmware/inc/trace.h)
+ *
+ * Usage: bench_trace [events]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long events = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000000UL;
+
+    trace_init();
+
+    uint64_t t0 = now_ns();
+    for (unsigned long i = 0; i < events; ++i) {
+        trace_record(TRACE_EV_TASK_START, (uint16_t)(i & 7), (uint32_t)i);
+    }
+    uint64_t t1 = now_ns();
+
+    /* the timestamp read alone: dominates on VMs that trap or slow rdtsc */
+    volatile uint64_t sink = 0;
+    uint64_t t2 = now_ns();
+    for (unsigned long i = 0; i < events; ++i) {
+        sink = TRACE_TIMESTAMP();
+    }
+    uint64_t t3 = now_ns();
+    (void)sink;
+
+    double ns = (double)(t1 - t0) / (double)events;
+    printf("trace_record: %lu events in %.3f ms -> %.2f ns/event (%.1f M events/s)\n",
+           events, (t1 - t0) / 1e6, ns, 1e3 / ns);
+    printf("  of which TRACE_TIMESTAMP(): %.2f ns\n", (double)(t3 - t2) / (double)events);
+    return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * csv_replay: replay a sensor logger data_log.csv through the alarm rule
+ * engine offline, e.g. to backtest new thresholds against months of logs.
+ *
+ * The file is memory-mapped and cut into rounds of threads x chunk bytes.
+ * Worker threads parse their chunk of the next round (sensor_csv_parse,
+ * SIMD separator scan) and fold it into per-chunk channel statistics,
+ * while the main thread runs the rules over the previous round in file
+ * order, so hysteresis, debounce and rate limits see the samples exactly
+ * as the logger would have.
+ *
+ * Usage: csv_replay <data_log.csv> [--rules FILE] [--threads N] [--chunk KB]
+ *                   [--ticks-per-s T] [--events] [--parse-only]
+ *   --rules       alarm rules (alarm_rules.conf format); default: the
+ *                 logger's built-in TEMP/PRESS/FLOW limits
+ *   --ticks-per-s timestamp units per second (default 1e9: data_log.csv
+ *                 timestamps are nanoseconds; 1 for logs in seconds)
+ *   --events      print every RAISE/CLEAR transition
+ *   --parse-only  skip the rules, measure parsing bandwidth
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_csv.h"
+#include "sensor_history.h"
+#include "alarm_rules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define REPLAY_MAX_THREADS 64
+#define REPLAY_MIN_ROW     8        /* "0,0,0,0\n": bounds rows per chunk */
+#define REPLAY_EVENTS      1024     /* a sample raises at most one event per rule */
+
+/* moments of one channel over one chunk, merged in file order */
+typedef struct {
+    unsigned long long n;
+    double mean, m2;
+    float min, max;
+} ChannelAcc;
+
+typedef struct {
+    const char *begin, *end;      /* rows of this chunk */
+    SensorData *rows;
+    size_t      count;
+    unsigned long bad;
+    ChannelAcc  acc[SENSOR_CHANNELS];
+} Chunk;
+
+typedef struct {
+    const char *map;
+    size_t      size;
+    size_t      threads, chunk_bytes, chunk_rows;
+    Chunk      *chunk[2];         /* double buffered: parse one, evaluate the other */
+    int         slot, quit;
+    pthread_barrier_t start, done;
+    pthread_mutex_t gate;         /* held until every worker is up (or one failed) */
+} Replay;
+
+typedef struct {
+    Replay *rp;
+    size_t  id;
+} Worker;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* two passes over the parsed chunk: no division per sample, and the
+   squared deviations stay small whatever the channel's offset */
+static void acc_chunk(ChannelAcc *a, const SensorData *rows, size_t n, size_t offset) {
+    double sum = 0.0, m2 = 0.0;
+    float lo = 0.0f, hi = 0.0f;
+    memset(a, 0, sizeof(*a));
+    if (n == 0) return;
+    for (size_t i = 0; i < n; i++) {
+        float v = *(const float *)((const char *)&rows[i] + offset);
+        sum += v;
+        if (i == 0 || v < lo) lo = v;
+        if (i == 0 || v > hi) hi = v;
+    }
+    double mean = sum / (double)n;
+    for (size_t i = 0; i < n; i++) {
+        double d = (double)*(const float *)((const char *)&rows[i] + offset) - mean;
+        m2 += d * d;
+    }
+    a->n = n;
+    a->mean = mean;
+    a->m2 = m2;
+    a->min = lo;
+    a->max = hi;
+}
+
+/* Chan et al. pairwise combination */
+static void acc_merge(ChannelAcc *a, const ChannelAcc *b) {
+    if (b->n == 0) return;
+    if (a->n == 0) {
+        *a = *b;
+        return;
+    }
+    double n = (double)(a->n + b->n);
+    double d = b->mean - a->mean;
+    a->m2 += b->m2 + d * d * (double)a->n * (double)b->n / n;
+    a->mean += d * (double)b->n / n;
+    a->n += b->n;
+    if (b->min < a->min) a->min = b->min;
+    if (b->max > a->max) a->max = b->max;
+}
+
+static void parse_chunk(Chunk *c, size_t cap) {
+    size_t len = (size_t)(c->end - c->begin), used = 0;
+    c->bad = 0;
+    c->count = len ? sensor_csv_parse(c->begin, len, c->rows, cap, &used, &c->bad) : 0;
+
+    /* last row of the file without a final newline */
+    if (used < len && c->count < cap) {
+        char tail[256];
+        size_t rest = len - used, tail_used;
+        if (rest < sizeof(tail)) {
+            memcpy(tail, c->begin + used, rest);
+            tail[rest] = '\n';
+            c->count += sensor_csv_parse(tail, rest + 1, c->rows + c->count, 1, &tail_used, &c->bad);
+        } else {
+            c->bad++;
+        }
+    }
+
+    acc_chunk(&c->acc[SENSOR_CH_TEMPERATURE], c->rows, c->count, offsetof(SensorData, temperature));
+    acc_chunk(&c->acc[SENSOR_CH_PRESSURE], c->rows, c->count, offsetof(SensorData, pressure));
+    acc_chunk(&c->acc[SENSOR_CH_FLOW], c->rows, c->count, offsetof(SensorData, flow));
+}
+
+static void *worker_thread(void *arg) {
+    Worker *w = (Worker *)arg;
+    Replay *rp = w->rp;
+    pthread_mutex_lock(&rp->gate);
+    int failed = rp->quit;            /* a sibling could not be started */
+    pthread_mutex_unlock(&rp->gate);
+    if (failed) return NULL;
+    for (;;) {
+        pthread_barrier_wait(&rp->start);
+        if (rp->quit) break;
+        parse_chunk(&rp->chunk[rp->slot][w->id], rp->chunk_rows);
+        pthread_barrier_wait(&rp->done);
+    }
+    return NULL;
+}
+
+/* cut the next round into per-thread chunks ending on a newline */
+static size_t plan_round(Replay *rp, Chunk *round, size_t off) {
+    for (size_t t = 0; t < rp->threads; t++) {
+        size_t end = off + rp->chunk_bytes < rp->size ? off + rp->chunk_bytes : rp->size;
+        if (end < rp->size) {
+            const char *nl = memchr(rp->map + end, '\n', rp->size - end);
+            end = nl ? (size_t)(nl - rp->map) + 1 : rp->size;
+        }
+        round[t].begin = rp->map + off;
+        round[t].end = rp->map + end;
+        off = end;
+    }
+    return off;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <data_log.csv> [--rules FILE] [--threads N] [--chunk KB]\n"
+                    "          [--ticks-per-s T] [--events] [--parse-only]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    static AlarmRules rules;
+    static Replay rp;
+    const char *path = NULL, *rules_path = NULL;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = ncpu > 0 ? (size_t)ncpu : 1, chunk_kb = 1024;
+    double ticks_per_s = 1e9;
+    int print_events = 0, parse_only = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) rules_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) chunk_kb = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--ticks-per-s") == 0 && i + 1 < argc) ticks_per_s = atof(argv[++i]);
+        else if (strcmp(argv[i], "--events") == 0) print_events = 1;
+        else if (strcmp(argv[i], "--parse-only") == 0) parse_only = 1;
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!path || threads == 0 || threads > REPLAY_MAX_THREADS || chunk_kb == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    alarm_rules_init(&rules, ticks_per_s);
+    if (rules_path) {
+        char err[256];
+        if (alarm_rules_load(&rules, rules_path, err, sizeof(err)) != 0) {
+            fprintf(stderr, "Error: %s\n", err);
+            return 1;
+        }
+    } else {
+        /* same limits as sensor_logger_alarm without --rules */
+        alarm_rules_add(&rules, "high_temp", SENSOR_CH_TEMPERATURE, RULE_GT, 80.0f, 0, 0, 0);
+        alarm_rules_add(&rules, "high_press", SENSOR_CH_PRESSURE, RULE_GT, 9.0f, 0, 0, 0);
+        alarm_rules_add(&rules, "low_flow", SENSOR_CH_FLOW, RULE_LT, 10.0f, 0, 0, 0);
+    }
+
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        return 1;
+    }
+    rp.size = (size_t)st.st_size;
+    if (rp.size == 0) {
+        fprintf(stderr, "%s: empty file\n", path);
+        close(fd);
+        return 1;
+    }
+    rp.map = mmap(NULL, rp.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (rp.map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    posix_madvise((void *)rp.map, rp.size, POSIX_MADV_SEQUENTIAL);
+
+    /* header line: anything that does not start like a number */
+    size_t off = 0;
+    if (rp.map[0] != '-' && (unsigned)(rp.map[0] - '0') >= 10) {
+        const char *nl = memchr(rp.map, '\n', rp.size);
+        off = nl ? (size_t)(nl - rp.map) + 1 : rp.size;
+    }
+
+    rp.threads = threads;
+    rp.chunk_bytes = chunk_kb * 1024;
+    /* a chunk holds chunk_bytes plus the rest of its last row */
+    rp.chunk_rows = rp.chunk_bytes / REPLAY_MIN_ROW + 2;
+    for (int s = 0; s < 2; s++) {
+        rp.chunk[s] = calloc(threads, sizeof(Chunk));
+        if (!rp.chunk[s]) return 1;
+        for (size_t t = 0; t < threads; t++) {
+            rp.chunk[s][t].rows = malloc(rp.chunk_rows * sizeof(SensorData));
+            if (!rp.chunk[s][t].rows) {
+                fprintf(stderr, "Error: Memory allocation failed.\n");
+                return 1;
+            }
+        }
+    }
+
+    pthread_barrier_init(&rp.start, NULL, (unsigned)threads + 1);
+    pthread_barrier_init(&rp.done, NULL, (unsigned)threads + 1);
+    pthread_t tid[REPLAY_MAX_THREADS];
+    Worker workers[REPLAY_MAX_THREADS];
+    pthread_mutex_init(&rp.gate, NULL);
+    pthread_mutex_lock(&rp.gate);
+    size_t up = 0;
+    for (; up < threads; up++) {
+        workers[up].rp = &rp;
+        workers[up].id = up;
+        if (pthread_create(&tid[up], NULL, worker_thread, &workers[up]) != 0) break;
+    }
+    if (up < threads) rp.quit = 1;     /* the started workers leave before the barriers */
+    pthread_mutex_unlock(&rp.gate);
+    if (up < threads) {
+        fprintf(stderr, "Error: cannot start worker threads.\n");
+        for (size_t t = 0; t < up; t++) pthread_join(tid[t], NULL);
+        pthread_mutex_destroy(&rp.gate);
+        pthread_barrier_destroy(&rp.start);
+        pthread_barrier_destroy(&rp.done);
+        for (int s = 0; s < 2; s++) {
+            for (size_t t = 0; t < threads; t++) free(rp.chunk[s][t].rows);
+            free(rp.chunk[s]);
+        }
+        munmap((void *)rp.map, rp.size);
+        return 1;
+    }
+
+    AlarmEvent events[REPLAY_EVENTS];
+    const size_t batch = REPLAY_EVENTS / (rules.count ? rules.count : 1);
+    ChannelAcc acc[SENSOR_CHANNELS];
+    memset(acc, 0, sizeof(acc));
+    unsigned long long total_rows = 0, event_count = 0;
+    unsigned long bad_rows = 0;
+    uint64_t first_ts = 0, last_ts = 0;
+    int slot = 0, pending = 0;
+    double t0 = now_s();
+
+    for (;;) {
+        int work = off < rp.size;
+        if (work) off = plan_round(&rp, rp.chunk[slot], off);
+        if (!work && !pending) {
+            rp.quit = 1;
+            pthread_barrier_wait(&rp.start);
+            break;
+        }
+        if (!work)
+            for (size_t t = 0; t < threads; t++) rp.chunk[slot][t].begin = rp.chunk[slot][t].end = NULL;
+        rp.slot = slot;
+        pthread_barrier_wait(&rp.start);     /* workers parse this round ... */
+
+        if (pending) {                       /* ... while the previous one is evaluated */
+            const Chunk *round = rp.chunk[slot ^ 1];
+            for (size_t t = 0; t < threads; t++) {
+                const Chunk *c = &round[t];
+                if (c->count == 0) {
+                    bad_rows += c->bad;
+                    continue;
+                }
+                if (total_rows == 0) first_ts = c->rows[0].timestamp;
+                last_ts = c->rows[c->count - 1].timestamp;
+                total_rows += c->count;
+                bad_rows += c->bad;
+                for (int ch = 0; ch < SENSOR_CHANNELS; ch++) acc_merge(&acc[ch], &c->acc[ch]);
+                if (parse_only) continue;
+
+                for (size_t i = 0; i < c->count; i += batch) {
+                    size_t n = c->count - i < batch ? c->count - i : batch;
+                    size_t nev = alarm_rules_eval(&rules, c->rows + i, n, events, REPLAY_EVENTS);
+                    event_count += nev;
+                    for (size_t e = 0; print_events && e < nev; e++) {
+                        printf("%" PRIu64 " %s %s: %s %.2f\n", events[e].timestamp, rules.name[events[e].rule],
+                               events[e].type == ALARM_EVENT_RAISE ? "RAISED" : "CLEARED",
+                               alarm_rules_channel_name(rules.channel[events[e].rule]), events[e].value);
+                    }
+                }
+            }
+        }
+        pthread_barrier_wait(&rp.done);
+        pending = work;
+        slot ^= 1;
+    }
+    double elapsed = now_s() - t0;
+
+    for (size_t t = 0; t < threads; t++) pthread_join(tid[t], NULL);
+    pthread_barrier_destroy(&rp.start);
+    pthread_barrier_destroy(&rp.done);
+    pthread_mutex_destroy(&rp.gate);
+
+    printf("%s: %.1f MB, %llu rows (%lu malformed) in %.3f s with %zu threads: %.2f GB/s, %.1f M rows/s\n",
+           path, (double)rp.size / 1e6, total_rows, bad_rows, elapsed, threads,
+           (double)rp.size / elapsed / 1e9, (double)total_rows / elapsed / 1e6);
+    if (total_rows)
+        printf("Timestamps %" PRIu64 " .. %" PRIu64 "\n", first_ts, last_ts);
+
+    printf("\n%-12s %12s %10s %10s %10s %10s\n", "Channel", "Samples", "Mean", "Stddev", "Min", "Max");
+    for (int ch = 0; ch < SENSOR_CHANNELS; ch++) {
+        const ChannelAcc *a = &acc[ch];
+        printf("%-12s %12llu %10.3f %10.3f %10.2f %10.2f\n", alarm_rules_channel_name(ch), a->n,
+               a->mean, a->n > 1 ? sqrt(a->m2 / (double)(a->n - 1)) : 0.0, a->min, a->max);
+    }
+
+    if (!parse_only) {
+        printf("\n%-14s %-12s %3s %9s %10s %10s %10s\n",
+               "Rule", "Channel", "Op", "Threshold", "Raised", "Suppressed", "Cleared");
+        for (size_t r = 0; r < rules.count; r++) {
+            printf("%-14s %-12s %3s %9.2f %10lu %10lu %10lu\n", rules.name[r],
+                   alarm_rules_channel_name(rules.channel[r]), alarm_rules_op_name((RuleOp)rules.op[r]),
+                   rules.threshold[r], rules.raised[r], rules.suppressed[r], rules.cleared[r]);
+        }
+        printf("%llu alarm events\n", event_count);
+    }
+
+    for (int s = 0; s < 2; s++) {
+        for (size_t t = 0; t < threads; t++) free(rp.chunk[s][t].rows);
+        free(rp.chunk[s]);
+    }
+    munmap((void *)rp.map, rp.size);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * log2csv: convert a binary sensor log (examples/memory/embedded_style/binlog.h)
+ * back into the data_log.csv format of the sensor loggers.
+ *
+ * Usage: log2csv <data_log.bin> [out.csv] [--stats]
+ *   --stats  print sample/segment counts and the size against CSV to stderr
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "binlog.h"
+#include "sensor_csv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+int main(int argc, char *argv[]) {
+    const char *in_path = NULL, *out_path = NULL;
+    int stats = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stats") == 0) stats = 1;
+        else if (!in_path) in_path = argv[i];
+        else out_path = argv[i];
+    }
+    if (!in_path) {
+        fprintf(stderr, "Usage: %s <data_log.bin> [out.csv] [--stats]\n", argv[0]);
+        return 1;
+    }
+
+    BinlogReader r;
+    if (binlog_reader_open(&r, in_path) != 0) {
+        fprintf(stderr, "%s: not a binary sensor log (or unsupported version)\n", in_path);
+        return 1;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror("Error opening output");
+        binlog_reader_close(&r);
+        return 1;
+    }
+
+    /* same header and row format as logToFile() */
+    long long csv_bytes = fprintf(out, "Temperature (°C),Pressure (bar),Flow (L/min),Timestamp\n");
+    SensorData d;
+    char row[SENSOR_CSV_MAX_ROW];
+    int rc;
+    while ((rc = binlog_read(&r, &d)) == 1) {
+        size_t len = sensor_csv_row(row, &d);
+        fwrite(row, 1, len, out);
+        csv_bytes += (long long)len;
+    }
+    if (rc < 0) fprintf(stderr, "%s: corrupt segment header, stopped after %lu samples\n",
+                        in_path, r.samples);
+    if (r.truncated) fprintf(stderr, "%s: incomplete last segment ignored\n", in_path);
+    if (r.bad_segments) fprintf(stderr, "%s: %lu segments failed their checksum and were skipped\n",
+                                in_path, r.bad_segments);
+
+    if (stats) {
+        struct stat sb;
+        long long bin_bytes = stat(in_path, &sb) == 0 ? (long long)sb.st_size : 0;
+        fprintf(stderr, "samples=%lu segments=%lu binary=%lld B (%.2f B/sample) csv=%lld B ratio=%.1fx\n",
+                r.samples, r.segments, bin_bytes,
+                r.samples ? (double)bin_bytes / r.samples : 0.0, csv_bytes,
+                bin_bytes ? (double)csv_bytes / bin_bytes : 0.0);
+    }
+
+    if (out != stdout) fclose(out);
+    binlog_reader_close(&r);
+    return rc < 0 ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+/*
+ * log_query: print the data_log.csv rows of a time range using the sparse
+ * sidecar index (examples/memory/embedded_style/time_index.h) written by
+ * the sensor logger, reading only the blocks that overlap the range.
+ *
+ * Usage: log_query <data_log.csv> FROM TO [--index FILE] [--count] [--scan]
+ *                  [--ticks-per-s T]
+ *        log_query <data_log.csv> --build [--stride N] [--index FILE]
+ *   FROM/TO   inclusive; epoch seconds or local "YYYY-MM-DD HH:MM[:SS]"
+ *   --ticks-per-s  timestamp units per second in the log (default 1e9:
+ *             the loggers write nanoseconds; 1 for logs in seconds)
+ *   --index   index path (default: <data_log.csv>.idx)
+ *   --count   print only the number of matching rows
+ *   --scan    ignore the index and scan the whole file (for comparison)
+ *   --build   index a log written without one
+ * Query statistics go to stderr.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "sensor_csv.h"
+#include "time_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define QUERY_CHUNK  (1u << 20)      /* bytes per read when scanning */
+#define QUERY_ROWS   (QUERY_CHUNK / 8 + 1)
+
+typedef struct {
+    int fd;
+    unsigned long long size;
+    uint64_t from, to;
+    int count_only;
+    char *buf;
+    SensorData *rows;
+
+    unsigned long long matched, parsed, bytes_read;
+    unsigned long bad, reads;
+} Query;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+/* epoch seconds, or local time "YYYY-MM-DD HH:MM[:SS]" ('T' also accepted) */
+static int parse_time(const char *s, uint64_t *out) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (*s && *end == '\0') {
+        *out = v;
+        return 0;
+    }
+    struct tm tm;
+    char sep;
+    memset(&tm, 0, sizeof(tm));
+    int n = sscanf(s, "%d-%d-%d%c%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &sep,
+                   &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+    if (n < 6 || (sep != ' ' && sep != 'T')) return -1;
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    time_t t = mktime(&tm);
+    if (t == (time_t)-1) return -1;
+    *out = (uint64_t)t;
+    return 0;
+}
+
+static size_t read_at(Query *q, unsigned long long off, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = pread(q->fd, q->buf + got, len - got, (off_t)(off + got));
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    q->bytes_read += got;
+    q->reads++;
+    return got;
+}
+
+/* parse complete rows of buf[0..len), print those in range; returns bytes used */
+static size_t emit_rows(Query *q, const char *buf, size_t len) {
+    size_t used;
+    size_t n = sensor_csv_parse(buf, len, q->rows, QUERY_ROWS, &used, &q->bad);
+    char row[SENSOR_CSV_MAX_ROW];
+    q->parsed += n;
+    for (size_t i = 0; i < n; i++) {
+        const SensorData *d = &q->rows[i];
+        if (d->timestamp < q->from || d->timestamp > q->to) continue;
+        q->matched++;
+        if (!q->count_only) fwrite(row, 1, sensor_csv_row(row, d), stdout);
+    }
+    return used;
+}
+
+/* rows of [off, end) in chunks; a row cut by a chunk is re-read with the next */
+static void scan_range(Query *q, unsigned long long off, unsigned long long end) {
+    if (end > q->size) end = q->size;
+    if (off == 0) {                       /* skip the CSV header */
+        size_t got = read_at(q, 0, end < 4096 ? (size_t)end : 4096);
+        const char *nl = memchr(q->buf, '\n', got);
+        if (got && q->buf[0] != '-' && (unsigned)(q->buf[0] - '0') >= 10)
+            off = nl ? (unsigned long long)(nl - q->buf) + 1 : end;
+    }
+    while (off < end) {
+        size_t want = end - off < QUERY_CHUNK ? (size_t)(end - off) : QUERY_CHUNK;
+        size_t got = read_at(q, off, want);
+        if (got == 0) break;
+        size_t used = emit_rows(q, q->buf, got);
+        if (used == 0) {
+            if (off + got >= q->size) {   /* last row of the file, no newline */
+                q->buf[got] = '\n';
+                emit_rows(q, q->buf, got + 1);
+            } else {
+                q->bad++;                 /* a row longer than a chunk */
+            }
+            used = got;
+        }
+        off += used;
+    }
+}
+
+static void query_index(Query *q, const TimeIndex *ix, unsigned long *examined) {
+    int past = 0;
+    *examined = 0;
+
+    /* one search per ordered run (a single run unless the clock went back) */
+    for (size_t r = 0; r < ix->runs; r++) {
+        past = 0;
+        for (size_t i = time_index_lower_bound(ix, r, q->from); i < ix->run[r + 1]; i++) {
+            const TimeIndexEntry *e = &ix->entry[i];
+            (*examined)++;
+            if (e->min_ts > q->to) {                 /* past the range in this run */
+                past = 1;
+                break;
+            }
+            scan_range(q, e->offset, e->offset + e->bytes);
+        }
+    }
+    /* records logged after the last complete block, unless the last run is past the range */
+    unsigned long long tail = time_index_end(ix);
+    if (!past && tail < q->size) scan_range(q, tail, q->size);
+}
+
+static int build_index(const char *data_path, const char *idx_path, uint32_t stride) {
+    FILE *f = fopen(data_path, "rb");
+    if (!f) {
+        perror(data_path);
+        return 1;
+    }
+    TimeIndexWriter w;
+    if (time_index_open(&w, idx_path, 0, stride) != 0) {
+        perror(idx_path);
+        fclose(f);
+        return 1;
+    }
+
+    /* index the rows the way the logger would have, line by line */
+    char line[4096];
+    SensorData d;
+    unsigned long bad = 0, rows = 0;
+    int first = 1;
+    while (fgets(line, sizeof(line), f)) {
+        size_t len = strlen(line), used;
+        if (first && line[0] != '-' && (unsigned)(line[0] - '0') >= 10) {
+            time_index_skip(&w, len);
+        } else if (len && line[len - 1] == '\n' && sensor_csv_parse(line, len, &d, 1, &used, &bad) == 1) {
+            time_index_add(&w, d.timestamp, len);
+            rows++;
+        } else {
+            time_index_skip(&w, len);     /* malformed or unterminated: not indexed */
+        }
+        first = 0;
+    }
+    fclose(f);
+    time_index_close(&w);
+    fprintf(stderr, "%s: %lu rows in %lu index entries (stride %u)%s\n", idx_path, rows,
+            w.entries, w.stride, w.flags & TIME_INDEX_UNORDERED ? ", timestamps not monotonic" : "");
+    return w.error ? 1 : 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <data_log.csv> FROM TO [--index FILE] [--count] [--scan] [--ticks-per-s T]\n"
+                    "       %s <data_log.csv> --build [--stride N] [--index FILE]\n", prog, prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *data_path = NULL, *idx_arg = NULL, *times[2] = { NULL, NULL };
+    int build = 0, scan = 0, ntimes = 0;
+    uint32_t stride = 0;
+    double ticks_per_s = 1e9;
+    static Query q;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--index") == 0 && i + 1 < argc) idx_arg = argv[++i];
+        else if (strcmp(argv[i], "--stride") == 0 && i + 1 < argc) stride = (uint32_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "--count") == 0) q.count_only = 1;
+        else if (strcmp(argv[i], "--scan") == 0) scan = 1;
+        else if (strcmp(argv[i], "--ticks-per-s") == 0 && i + 1 < argc) ticks_per_s = atof(argv[++i]);
+        else if (strcmp(argv[i], "--build") == 0) build = 1;
+        else if (!data_path) data_path = argv[i];
+        else if (ntimes < 2) times[ntimes++] = argv[i];
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!data_path || (!build && ntimes != 2)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    char idx_path[1024];
+    snprintf(idx_path, sizeof(idx_path), "%s", idx_arg ? idx_arg : data_path);
+    if (!idx_arg) strncat(idx_path, ".idx", sizeof(idx_path) - strlen(idx_path) - 1);
+    if (build) return build_index(data_path, idx_path, stride);
+
+    if (parse_time(times[0], &q.from) != 0 || parse_time(times[1], &q.to) != 0) {
+        fprintf(stderr, "Bad time: use epoch seconds or \"YYYY-MM-DD HH:MM[:SS]\"\n");
+        return 1;
+    }
+    if (ticks_per_s < 1) ticks_per_s = 1;
+    /* seconds -> log units; TO covers its whole second */
+    q.from = (uint64_t)((double)q.from * ticks_per_s);
+    q.to = (uint64_t)((double)(q.to + 1) * ticks_per_s) - 1;
+
+    q.fd = open(data_path, O_RDONLY);
+    struct stat st;
+    if (q.fd < 0 || fstat(q.fd, &st) != 0) {
+        perror(data_path);
+        return 1;
+    }
+    q.size = (unsigned long long)st.st_size;
+    q.buf = malloc(QUERY_CHUNK + 1);
+    q.rows = malloc(QUERY_ROWS * sizeof(SensorData));
+    if (!q.buf || !q.rows) {
+        fprintf(stderr, "Error: Memory allocation failed.\n");
+        return 1;
+    }
+
+    TimeIndex ix;
+    int indexed = !scan && time_index_load(&ix, idx_path) == 0;
+    if (!scan && !indexed)
+        fprintf(stderr, "%s: no usable index, scanning (create one with --build)\n", idx_path);
+
+    unsigned long examined = 0;
+    double t0 = now_ms();
+    if (indexed) query_index(&q, &ix, &examined);
+    else scan_range(&q, 0, q.size);
+    double elapsed = now_ms() - t0;
+
+    if (q.count_only) printf("%llu\n", q.matched);
+    fflush(stdout);
+    fprintf(stderr, "%llu rows matched | %llu rows parsed, %llu of %llu bytes read in %lu reads",
+            q.matched, q.parsed, q.bytes_read, q.size, q.reads);
+    if (indexed) fprintf(stderr, " | %lu of %zu index entries examined%s", examined, ix.count,
+                         ix.flags & TIME_INDEX_UNORDERED ? " (unordered index)" : "");
+    fprintf(stderr, " | %.3f ms\n", elapsed);
+    if (q.bad) fprintf(stderr, "%lu malformed rows skipped\n", q.bad);
+
+    if (indexed) time_index_unload(&ix);
+    free(q.buf);
+    free(q.rows);
+    close(q.fd);
+    return 0;
+}
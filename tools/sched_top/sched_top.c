@@ -0,0 +1,142 @@
+/*
+ * sched_top: live reader for the scheduler telemetry page
+ * (examples/scheduler/telemetry.h).
+ *
+ * Maps the shared-memory page read-only and samples it with the
+ * seqlock protocol, so the scheduler is never blocked or slowed.
+ *
+ * Usage: sched_top [-r HZ] [-n SAMPLES] [--csv]
+ *   -r HZ       sampling rate (default 2, up to tens of kHz)
+ *   -n SAMPLES  stop after SAMPLES reads (default: until Ctrl+C)
+ *   --csv       one line per sample instead of a refreshing table
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+
+static volatile sig_atomic_t keep_running = 1;
+
+static void handle_sigint(int sig) {
+    (void)sig;
+    keep_running = 0;
+}
+
+static const char *state_name(uint32_t state) {
+    switch (state) {
+    case TASK_STATE_READY:    return "ready";
+    case TASK_STATE_RUNNING:  return "running";
+    case TASK_STATE_DISABLED: return "disabled";
+    default:                  return "unused";
+    }
+}
+
+static void print_table(const TelemetryPage *p, uint64_t retries) {
+    printf("\x1b[H\x1b[2J");
+    printf("Scheduler pid %u | publish #%" PRIu64 " | ticks %" PRIu64 " | active %" PRIu64
+           " | CPU load %.2f%% | seqlock retries %" PRIu64 "\n\n",
+           p->writer_pid, p->publish_count, p->total_ticks, p->active_ticks,
+           p->cpu_load, retries);
+    printf("Task | Period ms | State    |       Runs | Runtime ms\n");
+    for (uint32_t i = 0; i < p->num_tasks && i < SCHED_MAX_TASKS; ++i) {
+        const TelemetryTask *t = &p->task[i];
+        printf("%4u | %9u | %-8s | %10" PRIu64 " | %10.3f\n",
+               i, t->period_ms, state_name(t->state), t->run_count, t->runtime_ns / 1e6);
+    }
+    printf("\nPool             | Block | Total | Free |    Allocs |     Frees | Failed\n");
+    for (uint32_t i = 0; i < p->num_pools && i < TELEMETRY_MAX_POOLS; ++i) {
+        const TelemetryPool *mp = &p->pool[i];
+        printf("%-16.16s | %5" PRIu64 " | %5" PRIu64 " | %4" PRIu64 " | %9" PRIu64
+               " | %9" PRIu64 " | %6" PRIu64 "\n",
+               mp->name, mp->block_size, mp->total_blocks, mp->free_blocks,
+               mp->alloc_count, mp->free_count, mp->failed_allocs);
+    }
+    fflush(stdout);
+}
+
+static void print_csv(const TelemetryPage *p, uint64_t sample) {
+    printf("%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.2f",
+           sample, p->publish_ns, p->publish_count, p->total_ticks, p->cpu_load);
+    for (uint32_t i = 0; i < p->num_tasks && i < SCHED_MAX_TASKS; ++i)
+        printf(",%" PRIu64 ",%" PRIu64, p->task[i].run_count, p->task[i].runtime_ns);
+    for (uint32_t i = 0; i < p->num_pools && i < TELEMETRY_MAX_POOLS; ++i)
+        printf(",%" PRIu64 ",%" PRIu64, p->pool[i].free_blocks, p->pool[i].failed_allocs);
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    double rate_hz = 2.0;
+    uint64_t max_samples = 0;
+    int csv = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) rate_hz = atof(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) max_samples = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--csv") == 0) csv = 1;
+        else {
+            fprintf(stderr, "Usage: %s [-r HZ] [-n SAMPLES] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rate_hz <= 0.0) rate_hz = 2.0;
+
+    int fd = shm_open(TELEMETRY_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "No telemetry page %s (%s). Start scheduler_demo --telemetry MS first.\n",
+                TELEMETRY_SHM_NAME, strerror(errno));
+        return 1;
+    }
+    void *map = mmap(NULL, sizeof(TelemetryPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    const volatile TelemetryPage *page = (const volatile TelemetryPage *)map;
+
+    signal(SIGINT, handle_sigint);
+
+    uint64_t period_ns = (uint64_t)(1e9 / rate_hz);
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    TelemetryPage snap;
+    uint64_t samples = 0, retries = 0, busy = 0;
+    while (keep_running && (max_samples == 0 || samples + busy < max_samples)) {
+        int r = telemetry_read(page, &snap);
+        if (r == TELEMETRY_BUSY) {
+            /* writer stalled or died mid-update: report it, keep polling */
+            uint32_t seq = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+            fprintf(stderr, "Telemetry busy: seq %u %s after %d retries (writer stalled or gone?)\n",
+                    seq, (seq & 1u) ? "odd" : "changing", TELEMETRY_READ_RETRIES);
+            busy++;
+        } else if (r < 0) {
+            fprintf(stderr, "Telemetry page not initialised\n");
+            break;
+        } else {
+            retries += (uint64_t)r;
+            samples++;
+            if (csv) print_csv(&snap, samples);
+            else print_table(&snap, retries);
+        }
+
+        uint64_t ns = (uint64_t)next.tv_nsec + period_ns;
+        next.tv_sec += (time_t)(ns / 1000000000ULL);
+        next.tv_nsec = (long)(ns % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    fprintf(stderr, "%" PRIu64 " samples, %" PRIu64 " seqlock retries, %" PRIu64 " busy reads\n",
+            samples, retries, busy);
+    munmap(map, sizeof(TelemetryPage));
+    return 0;
+}
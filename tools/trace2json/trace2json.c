@@ -0,0 +1,137 @@
+/*
+ * trace2json: convert a binary scheduler trace (firmware/inc/trace.h)
+ * into Chrome trace-event JSON, viewable in chrome://tracing or
+ * https://ui.perfetto.dev
+ *
+ * Usage: trace2json <trace.bin> [out.json] [--no-ticks]
+ */
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define TID_TICK     0
+#define TID_TASK0    1
+#define TID_QUEUE0   100
+
+static const char *event_name(uint16_t type) {
+    switch (type) {
+    case TRACE_EV_TICK:         return "tick";
+    case TRACE_EV_TASK_START:   return "run";
+    case TRACE_EV_TASK_STOP:    return "run";
+    case TRACE_EV_TASK_ENABLE:  return "enable";
+    case TRACE_EV_TASK_DISABLE: return "disable";
+    case TRACE_EV_QUEUE_PUSH:   return "push";
+    case TRACE_EV_QUEUE_POP:    return "pop";
+    case TRACE_EV_QUEUE_FULL:   return "full";
+    case TRACE_EV_POOL_FAIL:    return "pool alloc failed";
+    case TRACE_EV_USER:         return "user";
+    default:                    return "unknown";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *in_path = NULL, *out_path = NULL;
+    int with_ticks = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--no-ticks") == 0) with_ticks = 0;
+        else if (!in_path) in_path = argv[i];
+        else out_path = argv[i];
+    }
+    if (!in_path) {
+        fprintf(stderr, "Usage: %s <trace.bin> [out.json] [--no-ticks]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(in_path, "rb");
+    if (!in) {
+        perror("Error opening trace");
+        return 1;
+    }
+
+    TraceFileHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, in) != 1 || hdr.magic != TRACE_FILE_MAGIC ||
+        hdr.version != TRACE_FILE_VERSION || hdr.event_size != sizeof(TraceEvent)) {
+        fprintf(stderr, "%s: not a trace file (or unsupported version)\n", in_path);
+        fclose(in);
+        return 1;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror("Error opening output");
+        fclose(in);
+        return 1;
+    }
+
+    uint8_t task_seen[256] = {0};
+    uint8_t queue_seen[256] = {0};
+    const char *sep = "";
+    uint64_t written = 0;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":%" PRIu64 "},\n\"traceEvents\":[\n",
+            hdr.dropped);
+
+    TraceEvent e;
+    for (uint64_t n = 0; n < hdr.count && fread(&e, sizeof(e), 1, in) == 1; ++n) {
+        double ts_us = (double)e.ts / 1e3;
+        unsigned id = e.id;
+
+        switch (e.type) {
+        case TRACE_EV_TICK:
+            if (!with_ticks) continue;
+            fprintf(out, "%s{\"name\":\"tick\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,"
+                    "\"ts\":%.3f,\"args\":{\"tick\":%u}}", sep, TID_TICK, ts_us, e.arg);
+            break;
+        case TRACE_EV_TASK_START:
+        case TRACE_EV_TASK_STOP:
+            if (id < sizeof(task_seen)) task_seen[id] = 1;
+            fprintf(out, "%s{\"name\":\"task %u\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,"
+                    "\"ts\":%.3f,\"args\":{\"run\":%u}}", sep, id,
+                    e.type == TRACE_EV_TASK_START ? "B" : "E", TID_TASK0 + id, ts_us, e.arg);
+            break;
+        case TRACE_EV_TASK_ENABLE:
+        case TRACE_EV_TASK_DISABLE:
+            if (id < sizeof(task_seen)) task_seen[id] = 1;
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                    sep, event_name(e.type), TID_TASK0 + id, ts_us);
+            break;
+        case TRACE_EV_QUEUE_PUSH:
+        case TRACE_EV_QUEUE_POP:
+        case TRACE_EV_QUEUE_FULL:
+            if (id < sizeof(queue_seen)) queue_seen[id] = 1;
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,"
+                    "\"ts\":%.3f,\"args\":{\"items\":%u}}", sep, event_name(e.type),
+                    TID_QUEUE0 + id, ts_us, e.arg);
+            break;
+        default:
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,"
+                    "\"ts\":%.3f,\"args\":{\"id\":%u,\"arg\":%u}}", sep, event_name(e.type),
+                    ts_us, id, e.arg);
+            break;
+        }
+        sep = ",\n";
+        written++;
+    }
+
+    /* thread names so the viewer shows one track per task / queue */
+    fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"ticks\"}}",
+            sep, TID_TICK);
+    for (unsigned i = 0; i < sizeof(task_seen); ++i) {
+        if (task_seen[i])
+            fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":\"task %u\"}}", TID_TASK0 + i, i);
+        if (queue_seen[i])
+            fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":\"queue %u\"}}", TID_QUEUE0 + i, i);
+    }
+    fprintf(out, "\n]}\n");
+
+    fclose(in);
+    if (out != stdout) fclose(out);
+    fprintf(stderr, "%" PRIu64 " events converted (%" PRIu64 " dropped before dump)\n",
+            written, hdr.dropped);
+    return 0;
+}